@@ -0,0 +1,118 @@
+#ifndef CXXAUTOMATA_BENCH_UTILITIES_HPP
+#define CXXAUTOMATA_BENCH_UTILITIES_HPP
+
+#include "DFA.hpp"
+#include "NFA.hpp"
+#include "RandomAutomata.hpp"
+#include "Typedefs.hpp"
+#include <random>
+#include <string>
+
+/**
+ * @brief Helpers building reproducible automata and inputs of a given size
+ * for the benchmarks.
+ *
+ */
+namespace BENCH {
+
+using namespace CXXAUTOMATA;
+
+/**
+ * @brief A complete, accessible random DFA; one state in four is final.
+ *
+ */
+inline DFA makeDFA(std::size_t stateCount, std::size_t symbolCount,
+                   unsigned seed = 1) {
+  return RandomAutomatonGenerator(seed).randomDFA(stateCount, symbolCount,
+                                                  0.25);
+}
+
+/**
+ * @brief A random DFA over symbolCount symbols in which consecutive runs of
+ *        symbolCount / classCount symbols behave identically, as in
+ *        byte-oriented automata.
+ *
+ */
+inline DFA makeRunDFA(std::size_t stateCount, std::size_t symbolCount,
+                      std::size_t classCount, unsigned seed = 1) {
+  auto base = RandomAutomatonGenerator(seed).randomDFA(stateCount, classCount,
+                                                       0.25);
+  InputSymbols symbols;
+  Transitions transitions;
+  for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+    auto name = RandomAutomatonGenerator::symbolName(symbol, symbolCount);
+    auto baseName = RandomAutomatonGenerator::symbolName(
+        symbol * classCount / symbolCount, classCount);
+    symbols.insert(name);
+    for (auto &transition : base.getTransitions()) {
+      transitions[transition.first][name] = transition.second.at(baseName);
+    }
+  }
+  return DFA(base.getStates(), symbols, transitions, base.getInitialState(),
+             base.getFinalStates());
+}
+
+/**
+ * @brief A DFA in which one state in 64 is a hub with a random target on
+ *        every symbol, and every other state goes back to its hub except on
+ *        three random symbols.
+ *
+ */
+inline DFA makeHubDFA(std::size_t stateCount, std::size_t symbolCount,
+                      unsigned seed = 1) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::size_t> pickState(0, stateCount - 1);
+  std::uniform_int_distribution<std::size_t> pickSymbol(0, symbolCount - 1);
+  InputSymbols_v symbols;
+  for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+    symbols.push_back(
+        RandomAutomatonGenerator::symbolName(symbol, symbolCount));
+  }
+  States states;
+  States finalStates;
+  Transitions transitions;
+  for (std::size_t i = 0; i < stateCount; i++) {
+    State state = "q" + std::to_string(i);
+    State hub = "q" + std::to_string(i / 64 * 64);
+    states.insert(state);
+    if (i % 3 == 0) {
+      finalStates.insert(state);
+    }
+    Paths &paths = transitions[state];
+    for (auto &symbol : symbols) {
+      paths[symbol] = i % 64 == 0 ? "q" + std::to_string(pickState(rng)) : hub;
+    }
+    for (int k = 0; i % 64 != 0 && k < 3; k++) {
+      paths[symbols[pickSymbol(rng)]] = "q" + std::to_string(pickState(rng));
+    }
+  }
+  return DFA(states, InputSymbols(symbols.begin(), symbols.end()),
+             transitions, "q0", finalStates);
+}
+
+/**
+ * @brief A random NFA with two end states per state and symbol on average.
+ *
+ */
+inline NFA makeNFA(std::size_t stateCount, std::size_t symbolCount,
+                   unsigned seed = 1) {
+  return RandomAutomatonGenerator(seed).randomNFA(stateCount, symbolCount,
+                                                  0.25, 2.0);
+}
+
+inline InputSymbols_v makeInput(std::size_t length, std::size_t symbolCount,
+                                unsigned seed = 2) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::size_t> pick(0, symbolCount - 1);
+  InputSymbols_v input;
+  input.reserve(length);
+  for (std::size_t i = 0; i < length; i++) {
+    input.push_back(
+        RandomAutomatonGenerator::symbolName(pick(rng), symbolCount));
+  }
+  return input;
+}
+
+} // namespace BENCH
+
+#endif /* CXXAUTOMATA_BENCH_UTILITIES_HPP */
@@ -0,0 +1,49 @@
+#include "BenchUtilities.hpp"
+#include "benchmark/benchmark.h"
+#include "direct64_2.hpp"
+#include "direct64_16.hpp"
+#include "table64_2.hpp"
+#include "table64_16.hpp"
+
+using namespace BENCH;
+
+// Matchers generated at build time from makeDFA(states, symbols), compared
+// with DFA::acceptsInput (BM_AcceptsInput) on the same automata and inputs.
+// Arguments are {input length}.
+
+static void BM_Generated(benchmark::State &state,
+                         bool (*match)(const std::vector<std::string> &),
+                         std::size_t symbolCount) {
+  auto input = makeInput(state.range(0), symbolCount);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(match(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static void BM_GeneratedIndices(benchmark::State &state,
+                                bool (*match)(const int *, std::size_t),
+                                std::size_t symbolCount) {
+  auto input = makeInput(state.range(0), symbolCount);
+  std::vector<int> indices;
+  for (auto &symbol : input) {
+    indices.push_back(std::stoi(symbol.substr(1)));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(match(indices.data(), indices.size()));
+  }
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+
+BENCHMARK_CAPTURE(BM_Generated, direct_64_16, direct64_16, 16)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Generated, table_64_16, table64_16, 16)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Generated, direct_64_2, direct64_2, 2)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Generated, table_64_2, table64_2, 2)->Arg(4096);
+BENCHMARK_CAPTURE(BM_GeneratedIndices, direct_64_16, direct64_16_indices, 16)
+    ->Arg(4096);
+BENCHMARK_CAPTURE(BM_GeneratedIndices, table_64_16, table64_16_indices, 16)
+    ->Arg(4096);
+BENCHMARK_CAPTURE(BM_GeneratedIndices, direct_64_2, direct64_2_indices, 2)
+    ->Arg(4096);
+BENCHMARK_CAPTURE(BM_GeneratedIndices, table_64_2, table64_2_indices, 2)
+    ->Arg(4096);
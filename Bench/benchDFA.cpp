@@ -0,0 +1,400 @@
+#include "BenchUtilities.hpp"
+#include "CompiledDFA.hpp"
+#include "DAWGBuilder.hpp"
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include "HybridDFA.hpp"
+#include "Lexer.hpp"
+#include "StaticDFA.hpp"
+#include "ThreadPool.hpp"
+#include "WordGenerator.hpp"
+#include "benchmark/benchmark.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+
+using namespace BENCH;
+
+// Arguments are {states, symbols} unless stated otherwise.
+
+static void BM_ReadInputStepwise(benchmark::State &state) {
+  // Arguments are {states, symbols, input length}.
+  auto dfa = makeDFA(state.range(0), state.range(1));
+  auto input = makeInput(state.range(2), state.range(1));
+  for (auto _ : state) {
+    try {
+      benchmark::DoNotOptimize(dfa.readInputStepwise(input));
+    } catch (const AutomatonException &) {
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_ReadInputStepwise)
+    ->ArgsProduct({{64, 4096}, {2, 16}, {64, 4096}});
+
+static void BM_AcceptsInput(benchmark::State &state) {
+  // Arguments are {states, symbols, input length}.
+  auto dfa = makeDFA(state.range(0), state.range(1));
+  auto input = makeInput(state.range(2), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dfa.acceptsInput(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_AcceptsInput)->ArgsProduct({{64, 4096}, {2, 16}, {64, 4096}});
+
+static void BM_TraceInput(benchmark::State &state) {
+  // Arguments are {states, symbols, input length}; the last 64 steps.
+  auto dfa = makeDFA(state.range(0), state.range(1));
+  auto input = makeInput(state.range(2), state.range(1));
+  auto recorder = TraceRecorder::last(64);
+  for (auto _ : state) {
+    recorder.clear();
+    benchmark::DoNotOptimize(dfa.traceInput(input, recorder));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_TraceInput)->ArgsProduct({{64, 4096}, {2, 16}, {64, 4096}});
+
+static void BM_Validate(benchmark::State &state) {
+  auto dfa = makeDFA(state.range(0), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dfa.validate());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+BENCHMARK(BM_Validate)->ArgsProduct({{64, 512}, {2, 16}});
+
+static void BM_Minify(benchmark::State &state) {
+  auto dfa = makeDFA(state.range(0), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dfa.minify(false));
+  }
+  state.counters["states"] = state.range(0);
+}
+BENCHMARK(BM_Minify)->ArgsProduct({{16, 64, 256}, {2, 8}});
+
+static void BM_ParallelMinify(benchmark::State &state) {
+  // Arguments are {states, symbols, threads}; 0 threads is the sequential
+  // minify.
+  auto dfa = makeDFA(state.range(0), state.range(1));
+  std::unique_ptr<ThreadPool> pool;
+  if (state.range(2) > 0) {
+    pool.reset(new ThreadPool(state.range(2)));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pool ? dfa.minify(false, *pool)
+                                  : dfa.minify(false));
+  }
+  state.counters["states"] = state.range(0);
+  state.counters["threads"] = state.range(2);
+}
+BENCHMARK(BM_ParallelMinify)
+    ->ArgsProduct({{1 << 16, 1 << 20}, {4}, {0, 1, 2, 4, 8, 16}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_UnionJoin(benchmark::State &state) {
+  auto a = makeDFA(state.range(0), state.range(1), 1);
+  auto b = makeDFA(state.range(0), state.range(1), 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.unionJoin(b));
+  }
+  state.counters["product_states"] = state.range(0) * state.range(0);
+}
+BENCHMARK(BM_UnionJoin)->ArgsProduct({{4, 16}, {2, 8}});
+
+static void BM_Intersection(benchmark::State &state) {
+  auto a = makeDFA(state.range(0), state.range(1), 1);
+  auto b = makeDFA(state.range(0), state.range(1), 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.intersection(b));
+  }
+  state.counters["product_states"] = state.range(0) * state.range(0);
+}
+BENCHMARK(BM_Intersection)->ArgsProduct({{4, 16}, {2, 8}});
+
+static void BM_Difference(benchmark::State &state) {
+  auto a = makeDFA(state.range(0), state.range(1), 1);
+  auto b = makeDFA(state.range(0), state.range(1), 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.difference(b));
+  }
+  state.counters["product_states"] = state.range(0) * state.range(0);
+}
+BENCHMARK(BM_Difference)->ArgsProduct({{4, 16}, {2, 8}});
+
+static void BM_SymmetricDifference(benchmark::State &state) {
+  auto a = makeDFA(state.range(0), state.range(1), 1);
+  auto b = makeDFA(state.range(0), state.range(1), 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.symmetricDifference(b));
+  }
+  state.counters["product_states"] = state.range(0) * state.range(0);
+}
+BENCHMARK(BM_SymmetricDifference)->ArgsProduct({{4, 16}, {2, 8}});
+
+static void BM_Equal(benchmark::State &state) {
+  auto a = makeDFA(state.range(0), state.range(1), 1);
+  auto b = a.minify(false);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a == b);
+  }
+}
+BENCHMARK(BM_Equal)->ArgsProduct({{4, 16}, {2, 8}});
+
+static void BM_IsFinite(benchmark::State &state) {
+  auto dfa = makeDFA(state.range(0), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dfa.isFinite());
+  }
+}
+BENCHMARK(BM_IsFinite)->ArgsProduct({{16, 64, 256}, {2, 8}});
+
+static void BM_FromNFA(benchmark::State &state) {
+  auto nfa = makeNFA(state.range(0), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DFA::fromNFA(nfa));
+  }
+}
+BENCHMARK(BM_FromNFA)->ArgsProduct({{4, 8, 12}, {2, 4}});
+
+static void BM_ParallelIntersection(benchmark::State &state) {
+  // Arguments are {states, symbols, threads}; 0 threads is the sequential
+  // intersection.
+  auto a = makeDFA(state.range(0), state.range(1), 1);
+  auto b = makeDFA(state.range(0), state.range(1), 2);
+  std::unique_ptr<ThreadPool> pool;
+  if (state.range(2) > 0) {
+    pool.reset(new ThreadPool(state.range(2)));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pool ? a.intersection(b, false, *pool)
+                                  : a.intersection(b));
+  }
+  state.counters["product_states"] = state.range(0) * state.range(0);
+  state.counters["threads"] = state.range(2);
+}
+BENCHMARK(BM_ParallelIntersection)
+    ->ArgsProduct({{256, 1024}, {4}, {0, 1, 2, 4, 8, 16}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_ParallelFromNFA(benchmark::State &state) {
+  // Arguments are {states, symbols, threads}; 0 threads is the sequential
+  // subset construction.
+  auto nfa = makeNFA(state.range(0), state.range(1));
+  std::unique_ptr<ThreadPool> pool;
+  if (state.range(2) > 0) {
+    pool.reset(new ThreadPool(state.range(2)));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pool ? DFA::fromNFA(nfa, *pool)
+                                  : DFA::fromNFA(nfa));
+  }
+  state.counters["threads"] = state.range(2);
+}
+BENCHMARK(BM_ParallelFromNFA)
+    ->ArgsProduct({{12, 16}, {4}, {0, 1, 2, 4, 8, 16}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_RandomDFA(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(makeDFA(state.range(0), state.range(1)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RandomDFA)
+    ->ArgsProduct({{1 << 10, 1 << 16}, {2, 16}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_DAWGBuilder(benchmark::State &state) {
+  // Argument is the number of random words of 1 to 12 letters.
+  std::mt19937_64 rng(1);
+  std::uniform_int_distribution<int> length(1, 12);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::vector<std::string> words(state.range(0));
+  for (auto &word : words) {
+    for (int n = length(rng); n > 0; n--) {
+      word += static_cast<char>(letter(rng));
+    }
+  }
+  std::sort(words.begin(), words.end());
+  for (auto _ : state) {
+    DAWGBuilder builder;
+    for (auto &word : words) {
+      builder.add(word);
+    }
+    benchmark::DoNotOptimize(builder.build());
+  }
+  state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK(BM_DAWGBuilder)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+static DFA oneOrMore(const std::string &chars) {
+  InputSymbols symbols;
+  Paths paths;
+  for (char c : chars) {
+    symbols.insert(std::string(1, c));
+    paths[std::string(1, c)] = "more";
+  }
+  return DFA({"start", "more"}, symbols, {{"start", paths}, {"more", paths}},
+             "start", {"more"}, true);
+}
+
+static void BM_LexerTokenize(benchmark::State &state) {
+  // Argument is the input length in bytes.
+  DAWGBuilder keywords;
+  for (auto word : {"else", "if", "return", "while"}) {
+    keywords.add(word);
+  }
+  Lexer lexer({keywords.build(), oneOrMore("abcdefghijklmnopqrstuvwxyz"),
+               oneOrMore("0123456789"), oneOrMore(" "), oneOrMore("=+-<>")});
+  std::string line = "while x1 <= 4096 if y == z return y + 17 else ";
+  std::string input;
+  while (input.size() < static_cast<std::size_t>(state.range(0))) {
+    input += line;
+  }
+  std::vector<Token> tokens;
+  for (auto _ : state) {
+    tokens.clear();
+    benchmark::DoNotOptimize(lexer.scan(input.data(), input.size(), tokens));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+  state.counters["states"] = lexer.getStateCount();
+}
+BENCHMARK(BM_LexerTokenize)->Arg(1 << 12)->Arg(1 << 20);
+
+static void BM_SampleWords(benchmark::State &state) {
+  // Arguments are {states, word length}, over 4 symbols.
+  WordGenerator generator(makeDFA(state.range(0), 4));
+  generator.prepare(state.range(1));
+  std::mt19937_64 rng(1);
+  std::vector<SymbolId> word;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(generator.sampleIds(state.range(1), rng, word));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SampleWords)->Args({1 << 10, 16})->Args({100000, 64});
+
+static void BM_ConcatenateRules(benchmark::State &state) {
+  // Argument is the number of random 8-state rules concatenated in turn.
+  std::vector<DFA> rules;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    rules.push_back(makeDFA(8, 2, static_cast<unsigned>(i + 1)));
+  }
+  for (auto _ : state) {
+    DFA result = rules[0];
+    for (std::size_t i = 1; i < rules.size(); i++) {
+      result = result.concatenate(rules[i]);
+    }
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * rules.size());
+}
+BENCHMARK(BM_ConcatenateRules)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+
+// Strings over {0, 1} without "11", as a compile-time automaton.
+static constexpr StaticDFA<3, 2> noConsecutive11({'0', '1'},
+                                                 {{0, 1}, {0, 2}, {2, 2}},
+                                                 {true, true, false}, 0);
+
+static void BM_StaticAcceptsInput(benchmark::State &state) {
+  // Arguments are {input length}.
+  std::string input(state.range(0), '0');
+  for (std::size_t i = 0; i < input.size(); i += 3) {
+    input[i] = '1';
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(noConsecutive11.acceptsInput(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_StaticAcceptsInput)->Arg(64)->Arg(4096);
+
+static void BM_StaticEquivalentAcceptsInput(benchmark::State &state) {
+  // The same automaton and input through the runtime DFA.
+  auto dfa = noConsecutive11.toDFA();
+  InputSymbols_v input(state.range(0), "0");
+  for (std::size_t i = 0; i < input.size(); i += 3) {
+    input[i] = "1";
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dfa.acceptsInput(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_StaticEquivalentAcceptsInput)->Arg(64)->Arg(4096);
+
+static void BM_CompiledAcceptsInput(benchmark::State &state) {
+  // Arguments are {states, symbols, symbol classes}; input length 4096.
+  auto dfa = makeRunDFA(state.range(0), state.range(1), state.range(2));
+  auto input = makeInput(4096, state.range(1));
+  CompiledDFA compiled(dfa);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compiled.acceptsInput(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+  state.counters["classes"] = compiled.getClassCount();
+  state.counters["rows"] = compiled.getRowCount();
+  state.counters["dense_bytes"] = compiled.denseTableBytes();
+  state.counters["table_bytes"] = compiled.tableBytes();
+}
+BENCHMARK(BM_CompiledAcceptsInput)
+    ->Args({64, 256, 8})
+    ->Args({4096, 256, 8})
+    ->Args({4096, 256, 256})
+    ->Args({1024, 4096, 16});
+
+static void BM_HybridAcceptsInput(benchmark::State &state) {
+  // A few dense hub states among sparse ones; input length 4096.
+  auto dfa = makeHubDFA(state.range(0), state.range(1));
+  auto input = makeInput(4096, state.range(1));
+  HybridDFA hybrid(dfa);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hybrid.acceptsInput(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+  state.counters["dense_rows"] =
+      hybrid.getRowCount(HybridDFA::RowKind::DENSE);
+  state.counters["dense_bytes"] = hybrid.denseTableBytes();
+  state.counters["table_bytes"] = hybrid.tableBytes();
+}
+BENCHMARK(BM_HybridAcceptsInput)->Args({4096, 256})->Args({65536, 256});
+
+static void BM_CompiledHubAcceptsInput(benchmark::State &state) {
+  // The automata and inputs of BM_HybridAcceptsInput through CompiledDFA.
+  auto dfa = makeHubDFA(state.range(0), state.range(1));
+  auto input = makeInput(4096, state.range(1));
+  CompiledDFA compiled(dfa);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compiled.acceptsInput(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+  state.counters["table_bytes"] = compiled.tableBytes();
+}
+BENCHMARK(BM_CompiledHubAcceptsInput)->Args({4096, 256})->Args({65536, 256});
+
+static void BM_RunDFAAcceptsInput(benchmark::State &state) {
+  // The automata and inputs of BM_CompiledAcceptsInput through the DFA.
+  auto dfa = makeRunDFA(state.range(0), state.range(1), state.range(2));
+  auto input = makeInput(4096, state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dfa.acceptsInput(input));
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_RunDFAAcceptsInput)
+    ->Args({64, 256, 8})
+    ->Args({4096, 256, 8})
+    ->Args({4096, 256, 256})
+    ->Args({1024, 4096, 16});
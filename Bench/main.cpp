@@ -0,0 +1,13 @@
+#include "benchmark/benchmark.h"
+#include <iostream>
+
+int main(int argc, char **argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  std::cout << "Running Benchmark for CXXAUTOMATA" << std::endl;
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -1,13 +1,23 @@
 #include "Automaton.hpp"
 #include "Exceptions.hpp"
 #include <algorithm>
-#include <sstream>
+#include <atomic>
 
 namespace CXXAUTOMATA {
 
-Automaton::Automaton() {}
+namespace {
 
-Automaton::~Automaton() {}
+std::atomic<std::size_t> liveBytes(0);
+std::atomic<std::size_t> liveCount(0);
+
+} // namespace
+
+Automaton::Automaton() : accountedBytes(0) { liveCount++; }
+
+Automaton::~Automaton() {
+  liveBytes -= accountedBytes;
+  liveCount--;
+}
 
 bool Automaton::operator==(const Automaton &rhs) const {
   return (states == rhs.states) && (inputSymbols == rhs.inputSymbols) &&
@@ -15,15 +25,50 @@ bool Automaton::operator==(const Automaton &rhs) const {
          (initialState == rhs.initialState) && (finalStates == rhs.finalStates);
 }
 
-Automaton::Automaton(const Automaton &other) {}
+Automaton::Automaton(const Automaton &other) : accountedBytes(0) {
+  liveCount++;
+}
+
+Automaton &Automaton::operator=(const Automaton &rhs) {
+  states = rhs.states;
+  inputSymbols = rhs.inputSymbols;
+  transitions = rhs.transitions;
+  initialState = rhs.initialState;
+  finalStates = rhs.finalStates;
+  return *this;
+}
+
+MemoryUsage Automaton::memoryUsage() const {
+  MemoryUsage usage;
+  usage.transitions = MemoryUsage::of(transitions);
+  usage.stateNames = MemoryUsage::of(states) + MemoryUsage::of(finalStates) +
+                     MemoryUsage::of(initialState);
+  usage.symbols = MemoryUsage::of(inputSymbols);
+  // The containers above are part of the object.
+  usage.auxiliary = sizeof(*this) - sizeof(transitions) - sizeof(states) -
+                    sizeof(finalStates) - sizeof(initialState) -
+                    sizeof(inputSymbols);
+  return usage;
+}
+
+std::size_t Automaton::getLiveMemoryBytes() { return liveBytes; }
+
+std::size_t Automaton::getLiveCount() { return liveCount; }
+
+void Automaton::updateMemoryAccount() {
+  std::size_t bytes = memoryUsage().total();
+  liveBytes += bytes;
+  liveBytes -= accountedBytes;
+  accountedBytes = bytes;
+}
 
-State Automaton::readInput(const InputSymbols_v &input_str) {
+State Automaton::readInput(const InputSymbols_v &input_str) const {
   auto validation_generator = readInputStepwise(input_str);
   auto last_state = validation_generator.back();
   return last_state;
 }
 
-bool Automaton::acceptsInput(const InputSymbols_v &input_str) {
+bool Automaton::acceptsInput(const InputSymbols_v &input_str) const {
   try {
     readInput(input_str);
     return true;
@@ -32,27 +77,22 @@ bool Automaton::acceptsInput(const InputSymbols_v &input_str) {
   }
 }
 
-void Automaton::validateInitialState() const {
-  if (std::find(states.begin(), states.end(), initialState) == states.end()) {
-    std::stringstream ss;
-    ss << initialState << " is not a valid initial state.";
-    throw InvalidStateException(ss.str());
+void Automaton::validateInitialState(ValidationResult &result) const {
+  if (states.find(initialState) == states.end()) {
+    result.add(INVALID_INITIAL_STATE, initialState);
   }
 }
 
-void Automaton::validateInitialStateTransitions() const {
+void Automaton::validateInitialStateTransitions(
+    ValidationResult &result) const {
   if (transitions.find(initialState) == transitions.end()) {
-    std::stringstream ss;
-    ss << "initial state " << initialState << " has no transitions defined.";
-    throw MissingStateException(ss.str());
+    result.add(MISSING_INITIAL_STATE_TRANSITIONS, initialState);
   }
 }
-void Automaton::validateFinalStates() const {
-  for (auto state : finalStates) {
-    if (std::find(states.begin(), states.end(), state) == states.end()) {
-      std::stringstream ss;
-      ss << state << " is not a valid final state.";
-      throw InvalidStateException(ss.str());
+void Automaton::validateFinalStates(ValidationResult &result) const {
+  for (auto &state : finalStates) {
+    if (states.find(state) == states.end()) {
+      result.add(INVALID_FINAL_STATE, state);
     }
   }
 }
@@ -1,7 +1,10 @@
 #ifndef CXXAUTOMATA_AUTOMATON
 #define CXXAUTOMATA_AUTOMATON
 
+#include "MemoryUsage.hpp"
 #include "Typedefs.hpp"
+#include "Validation.hpp"
+#include <cstddef>
 #include <string>
 
 namespace CXXAUTOMATA {
@@ -9,6 +12,9 @@ namespace CXXAUTOMATA {
 /**
  * @brief An abstract base class for all automata, including Turing machines.
  *
+ *        readInputStepwise, readInput and acceptsInput are const and keep no
+ *        state between calls, so any number of threads may match against
+ *        one shared automaton without locks, as long as none modifies it.
  */
 class Automaton {
 public:
@@ -35,7 +41,7 @@ public:
    * @param input_str
    * @return States_v
    */
-  virtual States_v readInputStepwise(const InputSymbols_v &input_str) = 0;
+  virtual States_v readInputStepwise(const InputSymbols_v &input_str) const = 0;
   /**
   * @brief Check if the given string is accepted by this automaton.
   Return the automaton's final configuration if this string is valid.
@@ -43,7 +49,7 @@ public:
   * @param input_str
   * @return States
   */
-  virtual State readInput(const InputSymbols_v &input_str);
+  virtual State readInput(const InputSymbols_v &input_str) const;
   /**
    * @brief validate input to the automaton
    *
@@ -51,7 +57,7 @@ public:
    * @return true if this automaton accepts the given input.
    * @return false otherwise
    */
-  virtual bool acceptsInput(const InputSymbols_v &input_str);
+  virtual bool acceptsInput(const InputSymbols_v &input_str) const;
   /**
    * @brief Copy Construct a new Automaton object
    *
@@ -66,6 +72,35 @@ public:
    * @return false otherwise
    */
   virtual bool operator==(const Automaton &rhs) const;
+  /**
+   * @brief Copy the states, symbols and transitions of another automaton.
+   *
+   * @param rhs
+   * @return Automaton&
+   */
+  Automaton &operator=(const Automaton &rhs);
+
+  /**
+   * @brief Return the estimated memory held by this automaton, by purpose.
+   *
+   * @return MemoryUsage
+   */
+  virtual MemoryUsage memoryUsage() const;
+
+  /**
+   * @brief Return the bytes held by all live automata of the process, as
+   *        of their construction or last assignment.
+   *
+   * @return std::size_t
+   */
+  static std::size_t getLiveMemoryBytes();
+
+  /**
+   * @brief Return the number of live automata of the process.
+   *
+   * @return std::size_t
+   */
+  static std::size_t getLiveCount();
 
   const States& getStates() const;
   const InputSymbols& getInputSymbols() const;
@@ -75,26 +110,41 @@ public:
 
 protected:
   /**
-   * @brief Raise an error if the initial state is invalid.
+   * @brief Record an error if the initial state is invalid.
    *
+   * @param result
    */
-  virtual void validateInitialState() const;
+  virtual void validateInitialState(ValidationResult &result) const;
   /**
-   * @brief Raise an error if the initial state has no transitions defined.
+   * @brief Record an error if the initial state has no transitions defined.
    *
+   * @param result
    */
-  virtual void validateInitialStateTransitions() const;
+  virtual void
+  validateInitialStateTransitions(ValidationResult &result) const;
   /**
-   * @brief Raise an error if any final states are invalid.
+   * @brief Record an error for every invalid final state.
    *
+   * @param result
    */
-  virtual void validateFinalStates() const;
+  virtual void validateFinalStates(ValidationResult &result) const;
+  /**
+   * @brief Charge the process-wide tally with the current memoryUsage(),
+   *        replacing what was charged before. Called once an automaton is
+   *        fully built or assigned.
+   *
+   */
+  void updateMemoryAccount();
 
   States states;
   InputSymbols inputSymbols;
   Transitions transitions;
   State initialState;
   States finalStates;
+
+private:
+  /** bytes charged to the process-wide tally */
+  std::size_t accountedBytes;
 };
 } // namespace CXXAUTOMATA
 
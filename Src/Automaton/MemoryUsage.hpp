@@ -0,0 +1,84 @@
+#ifndef CXXAUTOMATA_MEMORY_USAGE
+#define CXXAUTOMATA_MEMORY_USAGE
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Estimated heap and object bytes held by an automaton, by purpose.
+ *
+ *        Tree containers are counted as one node of four pointers per
+ *        element plus the element, and strings by their object plus any
+ *        buffer beyond the small-string storage, as in the common standard
+ *        libraries. Allocator rounding is not included.
+ */
+struct MemoryUsage {
+  MemoryUsage() : transitions(0), stateNames(0), symbols(0), auxiliary(0) {}
+
+  /** transition maps, including the names repeated in them */
+  std::size_t transitions;
+  /** the sets of states and final states and the initial state */
+  std::size_t stateNames;
+  /** the input alphabet */
+  std::size_t symbols;
+  /** the automaton object itself, indexes and provenance */
+  std::size_t auxiliary;
+
+  std::size_t total() const {
+    return transitions + stateNames + symbols + auxiliary;
+  }
+
+  /**
+   * @brief Return the bytes of a string object and its buffer.
+   *
+   * @param value
+   * @return std::size_t
+   */
+  static std::size_t of(const std::string &value) {
+    const char *object = reinterpret_cast<const char *>(&value);
+    bool inPlace =
+        value.data() >= object && value.data() < object + sizeof(value);
+    return sizeof(value) + (inPlace ? 0 : value.capacity() + 1);
+  }
+
+  /**
+   * @brief Return the bytes of a set of strings.
+   *
+   * @param values
+   * @return std::size_t
+   */
+  static std::size_t of(const std::set<std::string> &values) {
+    std::size_t bytes = sizeof(values);
+    for (auto &value : values) {
+      bytes += TREE_NODE + of(value);
+    }
+    return bytes;
+  }
+
+  /**
+   * @brief Return the bytes of a map from strings to values whose bytes are
+   *        given by of(value).
+   *
+   * @param values
+   * @return std::size_t
+   */
+  template <class Value>
+  static std::size_t of(const std::map<std::string, Value> &values) {
+    std::size_t bytes = sizeof(values);
+    for (auto &value : values) {
+      bytes += TREE_NODE + of(value.first) + of(value.second);
+    }
+    return bytes;
+  }
+
+  /** red-black tree node overhead: colour and three links */
+  static const std::size_t TREE_NODE = 4 * sizeof(void *);
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_MEMORY_USAGE */
@@ -0,0 +1,139 @@
+#ifndef CXXAUTOMATA_ARENA
+#define CXXAUTOMATA_ARENA
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Monotonic memory arena.
+ *
+ * Memory is carved out of large blocks and is only given back when the
+ * arena is released or destroyed, so containers built on top of it are
+ * freed in one step instead of node by node. An arena is meant to belong
+ * to a single operation or thread and is not synchronized.
+ */
+class Arena {
+public:
+  explicit Arena(std::size_t blockSize = 64 * 1024)
+      : head(nullptr), cursor(nullptr), end(nullptr), blockSize(blockSize),
+        allocated(0) {}
+
+  ~Arena() { release(); }
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief Return bytes of memory aligned to alignment.
+   *
+   * @param bytes
+   * @param alignment
+   * @return void*
+   */
+  void *allocate(std::size_t bytes, std::size_t alignment) {
+    uintptr_t aligned =
+        (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) &
+        ~(static_cast<uintptr_t>(alignment) - 1);
+    if (cursor == nullptr ||
+        aligned + bytes > reinterpret_cast<uintptr_t>(end)) {
+      addBlock(bytes + alignment);
+      aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) &
+                ~(static_cast<uintptr_t>(alignment) - 1);
+    }
+    cursor = reinterpret_cast<char *>(aligned + bytes);
+    allocated += bytes;
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  /**
+   * @brief Free every block at once.
+   *
+   */
+  void release() {
+    while (head != nullptr) {
+      Block *next = head->next;
+      std::free(head);
+      head = next;
+    }
+    cursor = end = nullptr;
+    allocated = 0;
+  }
+
+  /**
+   * @brief Return the number of bytes handed out since the last release.
+   *
+   * @return std::size_t
+   */
+  std::size_t bytesAllocated() const { return allocated; }
+
+private:
+  struct Block {
+    Block *next;
+    std::max_align_t padding;
+  };
+
+  void addBlock(std::size_t minimum) {
+    std::size_t size = minimum > blockSize ? minimum : blockSize;
+    void *memory = std::malloc(sizeof(Block) + size);
+    if (memory == nullptr) {
+      throw std::bad_alloc();
+    }
+    Block *block = static_cast<Block *>(memory);
+    block->next = head;
+    head = block;
+    cursor = reinterpret_cast<char *>(block + 1);
+    end = cursor + size;
+  }
+
+  Block *head;
+  char *cursor;
+  char *end;
+  std::size_t blockSize;
+  std::size_t allocated;
+};
+
+/**
+ * @brief Standard allocator drawing from an Arena. Deallocation is a no-op.
+ *
+ */
+template <typename T> class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  ArenaAllocator(Arena &arena) noexcept : arena(&arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+      : arena(other.arena) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *, std::size_t) noexcept {}
+
+  template <typename U> bool operator==(const ArenaAllocator<U> &other) const {
+    return arena == other.arena;
+  }
+
+  template <typename U> bool operator!=(const ArenaAllocator<U> &other) const {
+    return arena != other.arena;
+  }
+
+  Arena *arena;
+};
+
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>
+    ArenaString;
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_ARENA */
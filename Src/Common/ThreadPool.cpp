@@ -0,0 +1,107 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace CXXAUTOMATA {
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+    : task(nullptr), generation(0), running(0), stopping(false) {
+  if (threadCount == 0) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads.reserve(threadCount - 1);
+  for (std::size_t worker = 1; worker < threadCount; worker++) {
+    threads.emplace_back(&ThreadPool::work, this, worker);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  started.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::run(const std::function<void(std::size_t)> &task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->task = &task;
+    error = nullptr;
+    running = threads.size();
+    generation++;
+  }
+  started.notify_all();
+  execute(0);
+  std::unique_lock<std::mutex> lock(mutex);
+  finished.wait(lock, [this] { return running == 0; });
+  this->task = nullptr;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::parallelFor(
+    std::size_t count, std::size_t grain,
+    const std::function<void(std::size_t, std::size_t)> &body) {
+  grain = std::max<std::size_t>(grain, 1);
+  if (count <= grain || threads.empty()) {
+    for (std::size_t begin = 0; begin < count; begin += grain) {
+      body(begin, std::min(begin + grain, count));
+    }
+    return;
+  }
+  std::size_t workers = getThreadCount();
+  std::unique_ptr<std::atomic<std::size_t>[]> next(
+      new std::atomic<std::size_t>[workers]);
+  std::vector<std::size_t> end(workers);
+  for (std::size_t worker = 0; worker < workers; worker++) {
+    next[worker] = count * worker / workers;
+    end[worker] = count * (worker + 1) / workers;
+  }
+  run([&](std::size_t worker) {
+    for (std::size_t i = 0; i < workers; i++) {
+      std::size_t slice = (worker + i) % workers;
+      for (std::size_t begin = next[slice].fetch_add(grain);
+           begin < end[slice]; begin = next[slice].fetch_add(grain)) {
+        body(begin, std::min(begin + grain, end[slice]));
+      }
+    }
+  });
+}
+
+void ThreadPool::work(std::size_t worker) {
+  std::size_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      started.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) {
+        return;
+      }
+      seen = generation;
+    }
+    execute(worker);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--running == 0) {
+      finished.notify_one();
+    }
+  }
+}
+
+void ThreadPool::execute(std::size_t worker) {
+  try {
+    (*task)(worker);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) {
+      error = std::current_exception();
+    }
+  }
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,81 @@
+#ifndef CXXAUTOMATA_THREAD_POOL
+#define CXXAUTOMATA_THREAD_POOL
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Fixed set of worker threads for the parallel operations.
+ *
+ * Work is fork-join: run() hands one task to every worker, the calling
+ * thread included as worker 0, and returns when all of them are done. The
+ * first exception thrown by a task is rethrown by run(). A pool runs one
+ * task at a time and may be reused by any number of operations.
+ */
+class ThreadPool {
+public:
+  /**
+   * @brief Start threadCount - 1 background threads. 0 uses one thread per
+   *        hardware thread.
+   *
+   * @param threadCount
+   */
+  explicit ThreadPool(std::size_t threadCount = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Number of workers, the calling thread included.
+   *
+   * @return std::size_t
+   */
+  std::size_t getThreadCount() const { return threads.size() + 1; }
+
+  /**
+   * @brief Call task(worker) on every worker and wait for all of them.
+   *
+   * @param task
+   */
+  void run(const std::function<void(std::size_t)> &task);
+
+  /**
+   * @brief Call body(begin, end) on consecutive ranges of at most grain
+   *        indexes until [0, count) is covered. Every worker starts on its
+   *        own slice of [0, count) and, once it is done, steals ranges from
+   *        the slices of the others.
+   *
+   * @param count
+   * @param grain
+   * @param body
+   */
+  void parallelFor(std::size_t count, std::size_t grain,
+                   const std::function<void(std::size_t, std::size_t)> &body);
+
+private:
+  void work(std::size_t worker);
+  void execute(std::size_t worker);
+
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable started;
+  std::condition_variable finished;
+  const std::function<void(std::size_t)> *task;
+  std::exception_ptr error;
+  /** incremented for every task so that workers see each one once */
+  std::size_t generation;
+  std::size_t running;
+  bool stopping;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_THREAD_POOL */
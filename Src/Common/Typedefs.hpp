@@ -16,6 +16,8 @@ typedef std::vector<InputSymbol> InputSymbols_v;
 typedef std::map<InputSymbol, State> Paths;
 typedef std::map<State, Paths> Transitions;
 typedef std::map<State, States> Graph;
+typedef std::map<InputSymbol, States> NFAPaths;
+typedef std::map<State, NFAPaths> NFATransitions;
 } // namespace CXXAUTOMATA
 
 #endif /* CXXAUTOMATA_TYPEDEFS */
@@ -48,4 +48,14 @@ NotImplementedException::NotImplementedException(const std::string &message)
 
 NotImplementedException::~NotImplementedException() throw() {}
 
+SerializationException::SerializationException(const std::string &message)
+    : AutomatonException(message) {}
+
+SerializationException::~SerializationException() throw() {}
+
+BudgetExceededException::BudgetExceededException(const std::string &message)
+    : AutomatonException(message) {}
+
+BudgetExceededException::~BudgetExceededException() throw() {}
+
 } // namespace CXXAUTOMATA
\ No newline at end of file
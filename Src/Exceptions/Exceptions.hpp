@@ -190,6 +190,44 @@ public:
   virtual ~NotImplementedException() throw();
 };
 
+/**
+ * @brief A serialized automaton could not be written, read or verified.
+ *
+ */
+class SerializationException : public AutomatonException {
+public:
+  /**
+   * @brief Construct a new Serialization Exception object
+   *
+   * @param message
+   */
+  SerializationException(const std::string &message);
+  /**
+   * @brief Destroy the Serialization Exception object
+   *
+   */
+  virtual ~SerializationException() throw();
+};
+
+/**
+ * @brief A construction went over its state or memory budget.
+ *
+ */
+class BudgetExceededException : public AutomatonException {
+public:
+  /**
+   * @brief Construct a new Budget Exceeded Exception object
+   *
+   * @param message
+   */
+  BudgetExceededException(const std::string &message);
+  /**
+   * @brief Destroy the Budget Exceeded Exception object
+   *
+   */
+  virtual ~BudgetExceededException() throw();
+};
+
 } // namespace CXXAUTOMATA
 
 #endif /* CXXAUTOMATA_EXCEPTIONS */
@@ -0,0 +1,76 @@
+#include "Validation.hpp"
+#include "Exceptions.hpp"
+#include <sstream>
+
+namespace CXXAUTOMATA {
+
+std::string ValidationIssue::message() const {
+  std::stringstream ss;
+  switch (error) {
+  case MISSING_TRANSITION_START_STATE:
+    ss << "transition start state " << state << " is missing";
+    break;
+  case MISSING_TRANSITION_SYMBOL:
+    ss << "state " << state << " is missing a transition for input symbol "
+       << symbol;
+    break;
+  case INVALID_TRANSITION_SYMBOL:
+    ss << "state " << state << " has an invalid transition symbol " << symbol;
+    break;
+  case INVALID_TRANSITION_END_STATE:
+    ss << "end state " << endState << " for transition on " << state
+       << " is invalid";
+    break;
+  case INVALID_INITIAL_STATE:
+    ss << state << " is not a valid initial state.";
+    break;
+  case MISSING_INITIAL_STATE_TRANSITIONS:
+    ss << "initial state " << state << " has no transitions defined.";
+    break;
+  case INVALID_FINAL_STATE:
+    ss << state << " is not a valid final state.";
+    break;
+  }
+  return ss.str();
+}
+
+void ValidationIssue::raise() const {
+  switch (error) {
+  case MISSING_TRANSITION_START_STATE:
+  case MISSING_INITIAL_STATE_TRANSITIONS:
+    throw MissingStateException(message());
+  case MISSING_TRANSITION_SYMBOL:
+    throw MissingSymbolException(message());
+  case INVALID_TRANSITION_SYMBOL:
+    throw InvalidSymbolException(message());
+  case INVALID_TRANSITION_END_STATE:
+  case INVALID_INITIAL_STATE:
+  case INVALID_FINAL_STATE:
+    throw InvalidStateException(message());
+  }
+  throw AutomatonException(message());
+}
+
+void ValidationResult::add(ValidationError error, const State &state,
+                           const InputSymbol &symbol,
+                           const State &endState) {
+  ValidationIssue issue = {error, state, symbol, endState};
+  issues.push_back(std::move(issue));
+}
+
+std::vector<std::string> ValidationResult::messages() const {
+  std::vector<std::string> formatted;
+  formatted.reserve(issues.size());
+  for (auto &issue : issues) {
+    formatted.push_back(issue.message());
+  }
+  return formatted;
+}
+
+void ValidationResult::throwIfInvalid() const {
+  if (!issues.empty()) {
+    issues.front().raise();
+  }
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,159 @@
+#ifndef CXXAUTOMATA_VALIDATION
+#define CXXAUTOMATA_VALIDATION
+
+#include "Exceptions.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief What is wrong with an automaton, one value per kind of check made
+ *        by validate(). Each maps to the exception validate() throws.
+ *
+ */
+enum ValidationError {
+  /** a state has no entry in the transitions (MissingStateException) */
+  MISSING_TRANSITION_START_STATE,
+  /** a state has no transition on a symbol (MissingSymbolException) */
+  MISSING_TRANSITION_SYMBOL,
+  /** a transition uses a symbol outside the alphabet
+      (InvalidSymbolException) */
+  INVALID_TRANSITION_SYMBOL,
+  /** a transition leads to an unknown state (InvalidStateException) */
+  INVALID_TRANSITION_END_STATE,
+  /** the initial state is unknown (InvalidStateException) */
+  INVALID_INITIAL_STATE,
+  /** the initial state has no transitions (MissingStateException) */
+  MISSING_INITIAL_STATE_TRANSITIONS,
+  /** a final state is unknown (InvalidStateException) */
+  INVALID_FINAL_STATE
+};
+
+/**
+ * @brief One violation found by a validation: its error code and the
+ *        states and symbol involved. The message is only formatted when
+ *        asked for.
+ *
+ */
+struct ValidationIssue {
+  ValidationError error;
+  /** the state the error is about */
+  State state;
+  /** the symbol of a transition error, or empty */
+  InputSymbol symbol;
+  /** the end state of INVALID_TRANSITION_END_STATE, or empty */
+  State endState;
+
+  /**
+   * @brief Format the message validate() would throw for this issue.
+   *
+   * @return std::string
+   */
+  std::string message() const;
+
+  /**
+   * @brief Throw the exception validate() would throw for this issue.
+   *
+   */
+  [[noreturn]] void raise() const;
+};
+
+/**
+ * @brief Every violation found by a validation, in the order validate()
+ *        checks them, so that the first one is what validate() throws.
+ *
+ */
+class ValidationResult {
+public:
+  /**
+   * @brief Record a violation.
+   *
+   * @param error
+   * @param state
+   * @param symbol
+   * @param endState
+   */
+  void add(ValidationError error, const State &state,
+           const InputSymbol &symbol = InputSymbol(),
+           const State &endState = State());
+
+  bool isValid() const { return issues.empty(); }
+  explicit operator bool() const { return isValid(); }
+  const std::vector<ValidationIssue> &getIssues() const { return issues; }
+
+  /**
+   * @brief Format the message of every issue.
+   *
+   * @return std::vector<std::string>
+   */
+  std::vector<std::string> messages() const;
+
+  /**
+   * @brief Throw the exception of the first issue, if there is one.
+   *
+   */
+  void throwIfInvalid() const;
+
+private:
+  std::vector<ValidationIssue> issues;
+};
+
+/**
+ * @brief Result of a non-throwing construction such as DFA::tryCreate:
+ *        the automaton if it is valid, and the validation in any case.
+ *
+ * @tparam T
+ */
+template <typename T> class CreateResult {
+public:
+  CreateResult(ValidationResult validation, std::unique_ptr<T> value)
+      : validation(std::move(validation)), value(std::move(value)) {}
+
+  bool isValid() const { return value != nullptr; }
+  explicit operator bool() const { return isValid(); }
+  const ValidationResult &getValidation() const { return validation; }
+
+  /**
+   * @brief Return the automaton, throwing the first validation error if
+   *        there is none.
+   *
+   * @return T&
+   * @throw AutomatonException if the automaton was taken by release()
+   */
+  T &get() {
+    checkValue();
+    return *value;
+  }
+  const T &get() const {
+    checkValue();
+    return *value;
+  }
+
+  /**
+   * @brief Take the automaton out of the result; null if it was invalid.
+   *        isValid() is false and get() throws afterwards.
+   *
+   * @return std::unique_ptr<T>
+   */
+  std::unique_ptr<T> release() { return std::move(value); }
+
+private:
+  void checkValue() const {
+    validation.throwIfInvalid();
+    if (value == nullptr) {
+      throw AutomatonException("the automaton was released from its result");
+    }
+  }
+
+  ValidationResult validation;
+  std::unique_ptr<T> value;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_VALIDATION */
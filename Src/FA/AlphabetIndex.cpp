@@ -0,0 +1,44 @@
+#include "AlphabetIndex.hpp"
+
+namespace CXXAUTOMATA {
+
+AlphabetIndex::AlphabetIndex(const InputSymbols &alphabet)
+    : symbols(alphabet.begin(), alphabet.end()) {
+  std::vector<uint32_t> ids(symbols.size());
+  for (uint32_t symbol = 0; symbol < ids.size(); symbol++) {
+    ids[symbol] = symbol;
+  }
+  setValues(ids);
+}
+
+void AlphabetIndex::setValues(const std::vector<uint32_t> &values) {
+  bool singleBytes = true;
+  for (auto &symbol : symbols) {
+    singleBytes = singleBytes && symbol.size() == 1;
+  }
+  valueOfByte.clear();
+  valueOfName.clear();
+  if (singleBytes) {
+    valueOfByte.assign(256, NO_SYMBOL);
+    for (std::size_t symbol = 0; symbol < symbols.size(); symbol++) {
+      valueOfByte[static_cast<unsigned char>(symbols[symbol][0])] =
+          values[symbol];
+    }
+  } else {
+    valueOfName.reserve(symbols.size());
+    for (std::size_t symbol = 0; symbol < symbols.size(); symbol++) {
+      valueOfName.emplace(symbols[symbol], values[symbol]);
+    }
+  }
+}
+
+std::size_t AlphabetIndex::lookupBytes() const {
+  if (isByteIndexed()) {
+    return valueOfByte.size() * sizeof(uint32_t);
+  }
+  return valueOfName.bucket_count() * sizeof(void *) +
+         valueOfName.size() *
+             (sizeof(InputSymbol) + sizeof(uint32_t) + sizeof(void *));
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,131 @@
+#ifndef CXXAUTOMATA_ALPHABET_INDEX
+#define CXXAUTOMATA_ALPHABET_INDEX
+
+#include "IndexedDFA.hpp"
+#include "Typedefs.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Lookup from the symbols of an alphabet to 32-bit values, shared
+ *        by the matchers CompiledDFA and HybridDFA and by Lexer.
+ *
+ *        Symbols are numbered in sorted order, and the value of a symbol
+ *        is its id until setValues() changes it, e.g. to a symbol class.
+ *        When every symbol is one character the lookup is a table indexed
+ *        by byte, otherwise a hash table.
+ */
+class AlphabetIndex {
+public:
+  AlphabetIndex() {}
+
+  explicit AlphabetIndex(const InputSymbols &alphabet);
+
+  /**
+   * @brief Give symbol i the value values[i].
+   *
+   * @param values one per symbol
+   */
+  void setValues(const std::vector<uint32_t> &values);
+
+  /**
+   * @brief Return the value of the given symbol, or NO_SYMBOL.
+   *
+   * @param symbol
+   * @return uint32_t
+   */
+  uint32_t find(const InputSymbol &symbol) const {
+    if (isByteIndexed()) {
+      return symbol.size() == 1
+                 ? valueOfByte[static_cast<unsigned char>(symbol[0])]
+                 : NO_SYMBOL;
+    }
+    auto it = valueOfName.find(symbol);
+    return it == valueOfName.end() ? NO_SYMBOL : it->second;
+  }
+
+  /**
+   * @brief Return the value of the one-character symbol byte, or
+   *        NO_SYMBOL. Only for an alphabet of one-character symbols.
+   *
+   * @param byte
+   * @return uint32_t
+   */
+  uint32_t findByte(unsigned char byte) const { return valueOfByte[byte]; }
+
+  bool isByteIndexed() const { return !valueOfByte.empty(); }
+  const InputSymbols_v &getSymbols() const { return symbols; }
+  uint32_t size() const { return static_cast<uint32_t>(symbols.size()); }
+
+  /**
+   * @brief Return the bytes used by the lookup.
+   *
+   * @return std::size_t
+   */
+  std::size_t lookupBytes() const;
+
+  /**
+   * @brief Return the bytes an uncompressed table of stateCount rows over
+   *        this alphabet would use.
+   *
+   * @param stateCount
+   * @return std::size_t
+   */
+  std::size_t denseTableBytes(std::size_t stateCount) const {
+    return stateCount * symbols.size() * sizeof(StateId);
+  }
+
+private:
+  InputSymbols_v symbols;
+  /** values of one-character symbols, used when every symbol is one */
+  std::vector<uint32_t> valueOfByte;
+  std::unordered_map<InputSymbol, uint32_t> valueOfName;
+};
+
+/**
+ * @brief Return the index of name in the sorted names, or NO_STATE.
+ *
+ * @param names
+ * @param name
+ * @return StateId
+ */
+inline StateId findSorted(const States_v &names, const State &name) {
+  auto it = std::lower_bound(names.begin(), names.end(), name);
+  return it != names.end() && *it == name
+             ? static_cast<StateId>(it - names.begin())
+             : NO_STATE;
+}
+
+/**
+ * @brief Read input from state, looking every symbol up in alphabet and
+ *        following next(state, value); visitor(state, position, symbol)
+ *        is called with every state entered.
+ *
+ * @return StateId the last state, or NO_STATE if the input leaves the DFA
+ */
+template <typename Next, typename Visitor>
+StateId walkInput(const AlphabetIndex &alphabet, StateId state,
+                  const InputSymbols_v &input, Next &&next,
+                  Visitor &&visitor) {
+  for (std::size_t position = 0; position < input.size(); position++) {
+    uint32_t value = alphabet.find(input[position]);
+    if (value == NO_SYMBOL) {
+      return NO_STATE;
+    }
+    state = next(state, value);
+    if (state == NO_STATE) {
+      return NO_STATE;
+    }
+    visitor(state, position, input[position]);
+  }
+  return state;
+}
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_ALPHABET_INDEX */
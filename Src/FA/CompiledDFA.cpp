@@ -0,0 +1,139 @@
+#include "CompiledDFA.hpp"
+#include "DFA.hpp"
+#include <algorithm>
+
+namespace CXXAUTOMATA {
+
+namespace {
+uint64_t hashRow(const StateId *row, uint32_t length) {
+  // FNV-1a over the row's targets
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (uint32_t i = 0; i < length; i++) {
+    hash = (hash ^ row[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+} // namespace
+
+CompiledDFA::CompiledDFA(const DFA &dfa)
+    : alphabet(dfa.getInputSymbols()), initialState(NO_STATE),
+      classCount(0) {
+  stateNames.assign(dfa.getStates().begin(), dfa.getStates().end());
+  const InputSymbols_v &symbolNames = alphabet.getSymbols();
+  uint32_t stateCount = static_cast<uint32_t>(stateNames.size());
+  uint32_t symbolCount = alphabet.size();
+  auto stateId = [&](const State &state) {
+    return findSorted(stateNames, state);
+  };
+
+  // Dense table, only needed while the classes are computed.
+  std::vector<StateId> dense(static_cast<std::size_t>(stateCount) *
+                                 symbolCount,
+                             NO_STATE);
+  for (auto &transition : dfa.getTransitions()) {
+    StateId state = stateId(transition.first);
+    if (state == NO_STATE) {
+      continue;
+    }
+    StateId *targets = &dense[static_cast<std::size_t>(state) * symbolCount];
+    auto symbol = symbolNames.begin();
+    for (auto &path : transition.second) {
+      symbol = std::lower_bound(symbol, symbolNames.end(), path.first);
+      if (symbol != symbolNames.end() && *symbol == path.first) {
+        targets[symbol - symbolNames.begin()] = stateId(path.second);
+      }
+    }
+  }
+
+  // Refine the symbol classes state by state: two symbols stay together
+  // while every state seen so far sends them to the same target. Classes
+  // are numbered in the order of their first symbol.
+  classOfSymbol.assign(symbolCount, 0);
+  classCount = symbolCount > 0 ? 1 : 0;
+  std::unordered_map<uint64_t, SymbolClass> refined;
+  for (uint32_t state = 0; state < stateCount && classCount < symbolCount;
+       state++) {
+    refined.clear();
+    const StateId *targets =
+        &dense[static_cast<std::size_t>(state) * symbolCount];
+    for (uint32_t symbol = 0; symbol < symbolCount; symbol++) {
+      uint64_t key = static_cast<uint64_t>(classOfSymbol[symbol]) << 32 |
+                     targets[symbol];
+      auto inserted =
+          refined.emplace(key, static_cast<SymbolClass>(refined.size()));
+      classOfSymbol[symbol] = inserted.first->second;
+    }
+    classCount = static_cast<uint32_t>(refined.size());
+  }
+
+  // One row per distinct class row.
+  std::vector<SymbolClass> representative(classCount);
+  for (uint32_t symbol = symbolCount; symbol-- > 0;) {
+    representative[classOfSymbol[symbol]] = symbol;
+  }
+  std::unordered_multimap<uint64_t, uint32_t> rowsByHash;
+  std::vector<StateId> row(classCount);
+  rowOffset.resize(stateCount);
+  for (uint32_t state = 0; state < stateCount; state++) {
+    const StateId *targets =
+        &dense[static_cast<std::size_t>(state) * symbolCount];
+    for (uint32_t c = 0; c < classCount; c++) {
+      row[c] = targets[representative[c]];
+    }
+    uint64_t hash = hashRow(row.data(), classCount);
+    auto candidates = rowsByHash.equal_range(hash);
+    uint32_t offset = static_cast<uint32_t>(rows.size());
+    for (auto candidate = candidates.first; candidate != candidates.second;
+         candidate++) {
+      if (std::equal(row.begin(), row.end(),
+                     rows.begin() + candidate->second)) {
+        offset = candidate->second;
+        break;
+      }
+    }
+    if (offset == rows.size()) {
+      rows.insert(rows.end(), row.begin(), row.end());
+      rowsByHash.emplace(hash, offset);
+    }
+    rowOffset[state] = offset;
+  }
+
+  alphabet.setValues(classOfSymbol);
+
+  finals.assign(stateCount, 0);
+  for (auto &state : dfa.getFinalStates()) {
+    StateId id = stateId(state);
+    if (id != NO_STATE) {
+      finals[id] = 1;
+    }
+  }
+  initialState = stateId(dfa.getInitialState());
+}
+
+StateId CompiledDFA::readInput(const InputSymbols_v &input) const {
+  return trace(input, [](StateId, std::size_t, const InputSymbol &) {});
+}
+
+bool CompiledDFA::acceptsInput(const InputSymbols_v &input) const {
+  StateId state = readInput(input);
+  return state != NO_STATE && isFinal(state);
+}
+
+std::vector<InputSymbols> CompiledDFA::getSymbolClasses() const {
+  std::vector<InputSymbols> classes(classCount);
+  for (std::size_t symbol = 0; symbol < alphabet.size(); symbol++) {
+    classes[classOfSymbol[symbol]].insert(alphabet.getSymbols()[symbol]);
+  }
+  return classes;
+}
+
+std::size_t CompiledDFA::tableBytes() const {
+  return rows.size() * sizeof(StateId) + rowOffset.size() * sizeof(uint32_t) +
+         alphabet.lookupBytes();
+}
+
+std::size_t CompiledDFA::denseTableBytes() const {
+  return alphabet.denseTableBytes(stateNames.size());
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,142 @@
+#ifndef CXXAUTOMATA_COMPILED_DFA
+#define CXXAUTOMATA_COMPILED_DFA
+
+#include "AlphabetIndex.hpp"
+#include "IndexedDFA.hpp"
+#include "TraceRecorder.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+class DFA;
+
+typedef uint32_t SymbolClass;
+
+/** Returned by CompiledDFA::symbolClass for symbols outside the alphabet. */
+static const SymbolClass NO_CLASS = 0xFFFFFFFFu;
+
+/**
+ * @brief Read-only, compressed form of a DFA for matching.
+ *
+ *        Symbols that lead every state to the same target are merged into
+ *        one equivalence class, so rows are indexed by class after a single
+ *        symbol-to-class lookup. Identical rows are then stored once and
+ *        states refer to their row. States are numbered in sorted order of
+ *        their names. A compiled DFA is immutable and may be shared between
+ *        threads.
+ */
+class CompiledDFA {
+public:
+  explicit CompiledDFA(const DFA &dfa);
+
+  /**
+   * @brief Return the class of the given symbol, or NO_CLASS.
+   *
+   * @param symbol
+   * @return SymbolClass
+   */
+  SymbolClass symbolClass(const InputSymbol &symbol) const {
+    return alphabet.find(symbol);
+  }
+
+  /**
+   * @brief Return the state reached from state on a symbol of the given
+   *        class, or NO_STATE.
+   *
+   * @param state
+   * @param symbolClass
+   * @return StateId
+   */
+  StateId nextState(StateId state, SymbolClass symbolClass) const {
+    return rows[rowOffset[state] + symbolClass];
+  }
+
+  /**
+   * @brief Return the state reached after reading input, or NO_STATE.
+   *
+   * @param input
+   * @return StateId
+   */
+  StateId readInput(const InputSymbols_v &input) const;
+
+  /**
+   * @brief Read input, calling visitor(state, position, symbol) after every
+   *        symbol with the state entered. visitor may be a TraceRecorder or
+   *        any callable; nothing is allocated per step.
+   *
+   * @param input
+   * @param visitor
+   * @return StateId the last state, or NO_STATE if the input leaves the
+   *         DFA, after the steps taken so far were visited
+   */
+  template <typename Visitor>
+  StateId trace(const InputSymbols_v &input, Visitor &&visitor) const {
+    return walkInput(
+        alphabet, initialState, input,
+        [this](StateId state, SymbolClass c) { return nextState(state, c); },
+        visitor);
+  }
+
+  /**
+   * @brief Return True if input is accepted.
+   *
+   * @param input
+   * @return true
+   * @return false
+   */
+  bool acceptsInput(const InputSymbols_v &input) const;
+
+  bool isFinal(StateId state) const { return finals[state] != 0; }
+  StateId getInitialState() const { return initialState; }
+  const State &getStateName(StateId state) const { return stateNames[state]; }
+  uint32_t getStateCount() const {
+    return static_cast<uint32_t>(stateNames.size());
+  }
+  uint32_t getClassCount() const { return classCount; }
+  uint32_t getRowCount() const {
+    return classCount == 0 ? 0
+                           : static_cast<uint32_t>(rows.size() / classCount);
+  }
+
+  /**
+   * @brief Return the symbol equivalence classes, in class order.
+   *
+   * @return std::vector<InputSymbols>
+   */
+  std::vector<InputSymbols> getSymbolClasses() const;
+
+  /**
+   * @brief Return the bytes used by the compressed transition table and
+   *        the symbol-to-class lookup.
+   *
+   * @return std::size_t
+   */
+  std::size_t tableBytes() const;
+
+  /**
+   * @brief Return the bytes an uncompressed |Q| x |Σ| table would use.
+   *
+   * @return std::size_t
+   */
+  std::size_t denseTableBytes() const;
+
+private:
+  States_v stateNames;
+  /** from every symbol to its class */
+  AlphabetIndex alphabet;
+  /** class of every symbol, in the order of the alphabet */
+  std::vector<SymbolClass> classOfSymbol;
+  /** start of every state's row in rows */
+  std::vector<uint32_t> rowOffset;
+  std::vector<StateId> rows;
+  std::vector<uint8_t> finals;
+  StateId initialState;
+  uint32_t classCount;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_COMPILED_DFA */
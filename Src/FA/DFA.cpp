@@ -1,30 +1,43 @@
 #include "DFA.hpp"
+#include "CompiledDFA.hpp"
 #include "Exceptions.hpp"
+#include "IndexedDFA.hpp"
 #include "NFA.hpp"
+#include "ParallelExplorer.hpp"
+#include "Statistics.hpp"
+#include "ThreadPool.hpp"
 #include "Typedefs.hpp"
 #include "Utilities.hpp"
 #include <algorithm>
-#include <cassert>
 #include <deque>
 #include <fstream>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <spawn.h>
 #include <sstream>
+#include <sys/wait.h>
+#include <unordered_map>
+#include <utility>
+
+extern char **environ;
 
 namespace CXXAUTOMATA {
-DFA::DFA(const States &states, const InputSymbols &inputSymbols,
-         const Transitions &transitions, const State &initialState,
-         const States &finalStates, bool allowPartial)
+DFA::DFA(States states, InputSymbols inputSymbols, Transitions transitions,
+         State initialState, States finalStates, bool allowPartial)
     : FA() {
-  this->states = states;
-  this->inputSymbols = inputSymbols;
-  this->transitions = transitions;
-  this->initialState = initialState;
-  this->finalStates = finalStates;
+  this->states = std::move(states);
+  this->inputSymbols = std::move(inputSymbols);
+  this->transitions = std::move(transitions);
+  this->initialState = std::move(initialState);
+  this->finalStates = std::move(finalStates);
   this->allowPartial = allowPartial;
   this->validate();
+  updateMemoryAccount();
 }
 
+DFA::DFA() : FA(), allowPartial(false) {}
+
 DFA::DFA(const DFA &dfa) {
   this->states = dfa.states;
   this->inputSymbols = dfa.inputSymbols;
@@ -32,10 +45,68 @@ DFA::DFA(const DFA &dfa) {
   this->initialState = dfa.initialState;
   this->finalStates = dfa.finalStates;
   this->allowPartial = dfa.allowPartial;
+  this->provenance = dfa.provenance;
+  updateMemoryAccount();
+}
+
+DFA &DFA::operator=(const DFA &rhs) {
+  Automaton::operator=(rhs);
+  allowPartial = rhs.allowPartial;
+  provenance = rhs.provenance;
+  std::atomic_store(&matcher, std::shared_ptr<const CompiledDFA>());
+  updateMemoryAccount();
+  return *this;
 }
 
 DFA::~DFA() {}
 
+MemoryUsage DFA::memoryUsage() const {
+  MemoryUsage usage = FA::memoryUsage();
+  usage.auxiliary += sizeof(*this) - sizeof(Automaton);
+  if (provenance != nullptr) {
+    usage.auxiliary += provenance->memoryBytes();
+  }
+  return usage;
+}
+
+bool DFA::getAllowPartial() const { return allowPartial; }
+
+DFA DFA::withProvenance() const {
+  DFA result(*this);
+  result.provenance =
+      Provenance::source(States_v(states.begin(), states.end()));
+  result.updateMemoryAccount();
+  return result;
+}
+
+const std::shared_ptr<const Provenance> &DFA::getProvenance() const {
+  return provenance;
+}
+
+std::string DFA::describeState(StateId state) const {
+  if (state >= states.size() ||
+      (provenance != nullptr && state >= provenance->getStateCount())) {
+    std::stringstream ss;
+    ss << "state id " << state << " is out of range";
+    throw InvalidStateException(ss.str());
+  }
+  if (provenance != nullptr) {
+    return provenance->name(state);
+  }
+  return *std::next(states.begin(), state);
+}
+
+std::string DFA::describeState(const State &state) const {
+  auto it = states.find(state);
+  if (it == states.end()) {
+    std::stringstream ss;
+    ss << state << " is not a valid state.";
+    throw InvalidStateException(ss.str());
+  }
+  return describeState(
+      static_cast<StateId>(std::distance(states.begin(), it)));
+}
+
 bool DFA::operator==(const DFA &other) const {
   return symmetricDifference(other).isEmpty();
 }
@@ -52,94 +123,121 @@ bool DFA::operator>(const DFA &other) const {
 DFA DFA::operator-(const DFA &other) const { return difference(other); }
 
 void DFA::validateTransitionMissingSymbols(const State &start_state,
-                                           const Paths &paths) const {
+                                           const Paths &paths,
+                                           ValidationResult &result) const {
   if (allowPartial) {
     return;
   }
-  for (auto inputSymbol : inputSymbols) {
+  for (auto &inputSymbol : inputSymbols) {
     if (paths.find(inputSymbol) == paths.end()) {
-      std::stringstream ss;
-      ss << "state " << start_state
-         << " is missing a transition for input symbol " << inputSymbol;
-      throw MissingSymbolException(ss.str());
+      result.add(MISSING_TRANSITION_SYMBOL, start_state, inputSymbol);
     }
   }
 }
 
 void DFA::validateTransitionInvalidSymbols(const State &start_state,
-                                           const Paths &paths) const {
-  for (auto path : paths) {
-    if (std::find(inputSymbols.begin(), inputSymbols.end(), path.first) ==
-        inputSymbols.end()) {
-      std::stringstream ss;
-      ss << "state " << start_state << " has an invalid transition symbol "
-         << path.first;
-      throw InvalidSymbolException(ss.str());
+                                           const Paths &paths,
+                                           ValidationResult &result) const {
+  for (auto &path : paths) {
+    if (inputSymbols.find(path.first) == inputSymbols.end()) {
+      result.add(INVALID_TRANSITION_SYMBOL, start_state, path.first);
     }
   }
 }
 
-void DFA::validateTransitionStartStates() const {
-  for (auto state : states) {
+void DFA::validateTransitionStartStates(ValidationResult &result) const {
+  if (allowPartial) {
+    return;
+  }
+  for (auto &state : states) {
     if (transitions.find(state) == transitions.end()) {
-      std::stringstream ss;
-      ss << "transition start state " << state << " is missing";
-      throw MissingStateException(ss.str());
+      result.add(MISSING_TRANSITION_START_STATE, state);
     }
   }
 }
 
 void DFA::validateTransitionEndStates(const State &start_state,
-                                      const Paths &paths) const {
-  for (auto path : paths) {
-    if (std::find(states.begin(), states.end(), path.second) == states.end()) {
-      std::stringstream ss;
-      ss << "end state " << path.second << " for transition on " << start_state
-         << " is invalid";
-      throw InvalidStateException(ss.str());
+                                      const Paths &paths,
+                                      ValidationResult &result) const {
+  for (auto &path : paths) {
+    if (states.find(path.second) == states.end()) {
+      result.add(INVALID_TRANSITION_END_STATE, start_state, path.first,
+                 path.second);
     }
   }
 }
 
-void DFA::validateTransitions(const State &start_state,
-                              const Paths &paths) const {
-  validateTransitionMissingSymbols(start_state, paths);
-  validateTransitionInvalidSymbols(start_state, paths);
-  validateTransitionEndStates(start_state, paths);
+void DFA::validateTransitions(const State &start_state, const Paths &paths,
+                              ValidationResult &result) const {
+  validateTransitionMissingSymbols(start_state, paths, result);
+  validateTransitionInvalidSymbols(start_state, paths, result);
+  validateTransitionEndStates(start_state, paths, result);
 }
 
 bool DFA::validate() const {
-  validateTransitionStartStates();
-  for (auto transition : transitions) {
-    validateTransitions(transition.first, transition.second);
-  }
-  validateInitialState();
-  validateFinalStates();
+  validateAll().throwIfInvalid();
   return true;
 }
 
+ValidationResult DFA::validateAll() const {
+  CXXAUTOMATA_STATS_SCOPE(VALIDATE);
+  ValidationResult result;
+  validateTransitionStartStates(result);
+  for (auto &transition : transitions) {
+    validateTransitions(transition.first, transition.second, result);
+    CXXAUTOMATA_STATS_ADD(STATES_EXPLORED, 1);
+    CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, transition.second.size());
+  }
+  validateInitialState(result);
+  validateFinalStates(result);
+  return result;
+}
+
+CreateResult<DFA> DFA::tryCreate(States states, InputSymbols inputSymbols,
+                                 Transitions transitions, State initialState,
+                                 States finalStates, bool allowPartial) {
+  std::unique_ptr<DFA> dfa(new DFA());
+  dfa->states = std::move(states);
+  dfa->inputSymbols = std::move(inputSymbols);
+  dfa->transitions = std::move(transitions);
+  dfa->initialState = std::move(initialState);
+  dfa->finalStates = std::move(finalStates);
+  dfa->allowPartial = allowPartial;
+  ValidationResult validation = dfa->validateAll();
+  if (!validation.isValid()) {
+    dfa.reset();
+  } else {
+    dfa->updateMemoryAccount();
+  }
+  return CreateResult<DFA>(std::move(validation), std::move(dfa));
+}
+
 State DFA::getNextCurrentState(const State &current_state,
                                const InputSymbol &input_symbol) const {
-  if (transitions.at(current_state).find(input_symbol) ==
-      transitions.at(current_state).end()) {
+  auto paths = transitions.find(current_state);
+  if (paths == transitions.end()) {
+    std::stringstream ss;
+    ss << "state " << current_state << " has no transitions";
+    throw RejectionException(ss.str());
+  }
+  auto path = paths->second.find(input_symbol);
+  if (path == paths->second.end()) {
     std::stringstream ss;
     ss << input_symbol << " is not a valid input symbol";
     throw RejectionException(ss.str());
-  } else {
-    return transitions.at(current_state).at(input_symbol);
   }
+  return path->second;
 }
 
 void DFA::checkForInputRejection(const State &current_state) const {
-  if (std::find(finalStates.begin(), finalStates.end(), current_state) ==
-      finalStates.end()) {
+  if (finalStates.find(current_state) == finalStates.end()) {
     std::stringstream ss;
     ss << "the DFA stopped on a non-final state " << current_state;
     throw RejectionException(ss.str());
   }
 }
 
-States_v DFA::readInputStepwise(const InputSymbols_v &input_str) {
+States_v DFA::readInputStepwise(const InputSymbols_v &input_str) const {
   States_v stateYield;
   State current_state = initialState;
 
@@ -153,329 +251,421 @@ States_v DFA::readInputStepwise(const InputSymbols_v &input_str) {
   return stateYield;
 }
 
-DFA DFA::minify(bool retainNames) const {
-  DFA newDfa = *this;
-  newDfa.removeUnreachableStates();
-  newDfa.mergeStates(retainNames);
-  return newDfa;
+std::shared_ptr<const CompiledDFA> DFA::getMatcher() const {
+  auto compiled = std::atomic_load(&matcher);
+  if (compiled == nullptr) {
+    // Threads racing here compile alike; the last one stored is kept.
+    compiled = std::make_shared<const CompiledDFA>(*this);
+    std::atomic_store(&matcher, compiled);
+  }
+  return compiled;
 }
 
-void DFA::removeUnreachableStates() {
-  auto reachableStates = computeReachableStates();
-  States unreachableStates;
-  for (auto state : states) {
-    if (reachableStates.find(state) == reachableStates.end()) {
-      unreachableStates.insert(state);
+StateId DFA::traceInput(const InputSymbols_v &input_str,
+                        const TraceVisitor &visitor) const {
+  return getMatcher()->trace(input_str, visitor);
+}
+
+StateId DFA::traceInput(const InputSymbols_v &input_str,
+                        TraceRecorder &recorder) const {
+  return traceInput(input_str,
+                    [&recorder](StateId state, std::size_t position,
+                                const InputSymbol &) {
+                      recorder.record(state, position);
+                    });
+}
+
+bool DFA::acceptsInput(const InputSymbols_v &input_str) const {
+  const State *current_state = &initialState;
+  for (auto &input_symbol : input_str) {
+    auto paths = transitions.find(*current_state);
+    if (paths == transitions.end()) {
+      return false;
     }
-  }
-  for (auto unreachableState : unreachableStates) {
-    states.erase(std::find(states.begin(), states.end(), unreachableState));
-    transitions.erase(transitions.find(unreachableState));
-    if (std::find(finalStates.begin(), finalStates.end(), unreachableState) !=
-        finalStates.end()) {
-      finalStates.erase(
-          std::find(finalStates.begin(), finalStates.end(), unreachableState));
-    }
-  }
-}
-std::set<State> DFA::computeReachableStates() const {
-  std::set<State> reachableStates;
-  std::deque<State> statesToCheck;
-  statesToCheck.push_back(initialState);
-  reachableStates.insert(initialState);
-  while (!statesToCheck.empty()) {
-    auto state = statesToCheck.front();
-    statesToCheck.pop_front();
-    for (auto transitionForState : transitions.at(state)) {
-      if (reachableStates.find(transitionForState.second) ==
-          reachableStates.end()) {
-        reachableStates.insert(transitionForState.second);
-        statesToCheck.push_back(transitionForState.second);
-      }
+    auto path = paths->second.find(input_symbol);
+    if (path == paths->second.end()) {
+      return false;
     }
+    current_state = &path->second;
   }
-  return reachableStates;
+  return finalStates.find(*current_state) != finalStates.end();
 }
 
-void DFA::mergeStates(bool retainNames) {
-  std::vector<States> eqClasses_v;
-  if (finalStates.size() != 0) {
-    eqClasses_v.push_back(finalStates);
-  }
-  if (finalStates.size() != states.size()) {
-    States s;
-    // std::sort(finalStates.begin(), finalStates.end());
-    // std::sort(states.begin(), states.end());
-    std::set_difference(states.begin(), states.end(), finalStates.begin(),
-                        finalStates.end(), std::inserter(s, s.begin()));
-    eqClasses_v.push_back(s);
+DFA DFA::minify(bool retainNames) const {
+  CXXAUTOMATA_STATS_SCOPE(MINIFY);
+  Arena arena;
+  return IndexedDFA::fromDFA(*this, arena).toMinimalDFA(retainNames);
+}
+
+DFA DFA::minify(bool retainNames, ThreadPool &pool) const {
+  CXXAUTOMATA_STATS_SCOPE(MINIFY);
+  Arena arena;
+  return IndexedDFA::fromDFA(*this, arena).toMinimalDFA(retainNames, &pool);
+}
+
+DFA DFA::canonical(Fingerprint *fingerprint) const {
+  DFA minimal = minify(false);
+  FingerprintBuilder hash;
+  hash.add(minimal.inputSymbols.size());
+  for (auto &symbol : minimal.inputSymbols) {
+    hash.add(symbol);
   }
-  std::set<States> eqClasses(eqClasses_v.begin(), eqClasses_v.end());
-  std::set<State> processing(finalStates.begin(), finalStates.end());
 
-  while (!processing.empty()) {
-    auto activeState = *processing.begin();
-    processing.erase(processing.begin());
-    for (auto activeLetter : inputSymbols) {
-      States statesThatMoveIntoActiveState;
-      for (auto state : states) {
-        if (transitions.at(state).find(activeLetter) !=
-                transitions.at(state).end() &&
-            transitions.at(state).at(activeLetter) == activeState) {
-          statesThatMoveIntoActiveState.insert(state);
-        }
+  // The dead state of a minimal DFA is its only non-final state looping on
+  // every symbol it has; it becomes a missing transition, so that a
+  // complete DFA and its partial counterpart have the same form.
+  const State *dead = nullptr;
+  for (auto &state : minimal.states) {
+    if (minimal.finalStates.count(state)) {
+      continue;
+    }
+    auto paths = minimal.transitions.find(state);
+    bool loops = true;
+    if (paths != minimal.transitions.end()) {
+      for (auto &path : paths->second) {
+        loops = loops && path.second == state;
       }
-      auto copyEqClasses = eqClasses;
-      for (auto checkingSet : copyEqClasses) {
-        // std::sort(checkingSet.begin(), checkingSet.end());
-        // std::sort(statesThatMoveIntoActiveState.begin(),
-        //           statesThatMoveIntoActiveState.end());
-        States XIntY;
-        auto lsi = std::set_intersection(checkingSet.begin(), checkingSet.end(),
-                                         statesThatMoveIntoActiveState.begin(),
-                                         statesThatMoveIntoActiveState.end(),
-                                         std::inserter(XIntY, XIntY.begin()));
-        if (XIntY.size() == 0) {
-          continue;
-        }
-        States XDiffY;
-        auto lsd = std::set_difference(checkingSet.begin(), checkingSet.end(),
-                                       statesThatMoveIntoActiveState.begin(),
-                                       statesThatMoveIntoActiveState.end(),
-                                       std::inserter(XDiffY, XDiffY.begin()));
-        if (XDiffY.size() == 0) {
-          continue;
-        }        
-        eqClasses.erase(checkingSet);
-        eqClasses.insert(XIntY);
-        eqClasses.insert(XDiffY);
-
-        bool found = true;
-        for (auto state : checkingSet) {
-          if (processing.find(state) == processing.end()) {
-            found = false;
-            break;
-          }
-        }
-        if (found) {
-          for (auto state : checkingSet) {
-            processing.erase(state);
-          }
-          for (auto state : XDiffY) {
-            processing.insert(state);
-          }
-          for (auto state : XIntY) {
-            processing.insert(state);
-          }
+    }
+    if (loops) {
+      dead = &state;
+      break;
+    }
+  }
 
-        } else {
-          if (XIntY.size() < XDiffY.size()) {
-            for (auto state : XIntY) {
-              processing.insert(state);
-            }
-          } else {
-            for (auto state : XDiffY) {
-              processing.insert(state);
-            }
+  // Breadth-first numbering over the sorted symbols
+  std::unordered_map<State, StateId> ids;
+  std::vector<const State *> order(1, &minimal.initialState);
+  ids.emplace(minimal.initialState, 0);
+  std::vector<StateId> table;
+  table.reserve(minimal.states.size() * minimal.inputSymbols.size());
+  for (std::size_t i = 0; i < order.size(); i++) {
+    auto paths = minimal.transitions.find(*order[i]);
+    for (auto &symbol : minimal.inputSymbols) {
+      StateId target = NO_STATE;
+      if (paths != minimal.transitions.end()) {
+        auto path = paths->second.find(symbol);
+        if (path != paths->second.end() &&
+            (dead == nullptr || path->second != *dead)) {
+          auto inserted =
+              ids.emplace(path->second, static_cast<StateId>(order.size()));
+          if (inserted.second) {
+            order.push_back(&path->second);
           }
+          target = inserted.first->second;
         }
       }
+      table.push_back(target);
     }
   }
 
-  auto rename = [&](const States_v &states) -> std::string {
-    if (states.size() == 1) {
-      return states.at(0);
-    } else {
-      return stringifyStates(states);
-    }
-  };
-
-  std::map<State, std::string> backMap;
-  int i = 0;
-  for (auto eqClass : eqClasses) {
-    States_v eqClass_v;
-    set2Vector(eqClass, eqClass_v);
-    std::string name;
-    if (retainNames) {
-      name = rename(eqClass_v);
-    } else {
-      name = std::to_string(i);
-    }
-
-    for (auto state : eqClass_v) {
-      backMap.insert(std::pair<State, std::string>(state, name));
-    }
-    i++;
+  // The result is valid by construction and is not validated again.
+  DFA result;
+  result.inputSymbols = minimal.inputSymbols;
+  result.allowPartial = std::find(table.begin(), table.end(), NO_STATE) !=
+                        table.end();
+  States_v names;
+  names.reserve(order.size());
+  for (std::size_t i = 0; i < order.size(); i++) {
+    names.push_back(std::to_string(i));
   }
-  auto newInputSymbols = inputSymbols;
-  States newStates;
-  if (retainNames) {
-    for (auto eq : eqClasses) {
-      States_v eq_v;
-      set2Vector(eq, eq_v);
-      auto state = rename(eq_v);
-      newStates.insert(state);
+  hash.add(order.size());
+  std::size_t symbolCount = result.inputSymbols.size();
+  for (std::size_t i = 0; i < order.size(); i++) {
+    bool final = minimal.finalStates.count(*order[i]) > 0;
+    hash.add(final);
+    result.states.insert(names[i]);
+    if (final) {
+      result.finalStates.insert(names[i]);
     }
-  } else {
-    for (int i = 0; i < eqClasses.size(); i++) {
-      newStates.insert(std::to_string(i));
+    Paths &paths = result.transitions[names[i]];
+    auto symbol = result.inputSymbols.begin();
+    for (std::size_t s = 0; s < symbolCount; s++, symbol++) {
+      StateId target = table[i * symbolCount + s];
+      hash.add(target);
+      if (target != NO_STATE) {
+        paths.emplace_hint(paths.end(), *symbol, names[target]);
+      }
     }
   }
-  auto newInitialState = backMap.at(initialState);
-  States newFinalStates;
-  for (auto acc : finalStates) {
-    newFinalStates.insert(backMap.at(acc));
+  result.initialState = names[0];
+  if (fingerprint != nullptr) {
+    *fingerprint = hash.finish();
   }
+  result.updateMemoryAccount();
+  return result;
+}
 
-  Transitions newTransitions;
-  i = 0;
-  for (auto eqClass : eqClasses) {
-    States_v eqClass_v;
-    set2Vector(eqClass, eqClass_v);
-    std::string name;
-    if (retainNames) {
-      name = rename(eqClass_v);
-    } else {
-      name = std::to_string(i);
-    }
-    for (auto letter : inputSymbols) {
-      for (auto state : eqClass_v) {
-      }
-      newTransitions[name][letter] =
-          backMap.at(transitions.at(eqClass_v.at(0)).at(letter));
-    }
-    i++;
-  }
+Fingerprint DFA::fingerprint() const {
+  Fingerprint result;
+  canonical(&result);
+  return result;
+}
+
+DFA DFA::concatenate(const DFA &other,
+                     const ConstructionBudget &budget) const {
+  CXXAUTOMATA_STATS_SCOPE(SUBSET_CONSTRUCTION);
+  return SubsetConstruction::concatenation(*this, other, budget).toDFA();
+}
+
+DFA DFA::star(const ConstructionBudget &budget) const {
+  CXXAUTOMATA_STATS_SCOPE(SUBSET_CONSTRUCTION);
+  return SubsetConstruction::star(*this, budget).toDFA();
+}
 
-  states = newStates;
-  inputSymbols = newInputSymbols;
-  transitions = newTransitions;
-  initialState = newInitialState;
-  finalStates = newFinalStates;
+DFA DFA::reverse(const ConstructionBudget &budget) const {
+  CXXAUTOMATA_STATS_SCOPE(SUBSET_CONSTRUCTION);
+  return SubsetConstruction::reversal(*this, budget).toDFA();
 }
 
-DFA DFA::crossProduct(const DFA &other) const {
-  assert(inputSymbols == other.inputSymbols);
-  auto states_a = states;
-  auto states_b = other.states;
+DFA DFA::leftQuotient(const DFA &other,
+                      const ConstructionBudget &budget) const {
+  CXXAUTOMATA_STATS_SCOPE(SUBSET_CONSTRUCTION);
+  return SubsetConstruction::leftQuotient(*this, other, budget).toDFA();
+}
+
+DFA DFA::rightQuotient(const DFA &other,
+                       const ConstructionBudget &budget) const {
+  CXXAUTOMATA_STATS_SCOPE(SUBSET_CONSTRUCTION);
+  return SubsetConstruction::rightQuotient(*this, other, budget).toDFA();
+}
+
+DFA DFA::minimalProduct(const DFA &other, bool (*accept)(bool, bool),
+                        bool retainNames, ThreadPool *pool) const {
+  InputSymbols alphabet = inputSymbols;
+  alphabet.insert(other.inputSymbols.begin(), other.inputSymbols.end());
+  Arena arena;
+  auto product = IndexedDFA::product(IndexedDFA::fromDFA(*this, arena),
+                                     IndexedDFA::fromDFA(other, arena),
+                                     alphabet, accept, pool);
+  CXXAUTOMATA_STATS_SCOPE(MINIFY);
+  return product.toMinimalDFA(retainNames, pool);
+}
+
+DFA DFA::crossProduct(const DFA &other, bool (*accept)(bool, bool)) const {
+  CXXAUTOMATA_STATS_SCOPE(CROSS_PRODUCT);
+  InputSymbols newInputSymbols = inputSymbols;
+  newInputSymbols.insert(other.inputSymbols.begin(), other.inputSymbols.end());
+
+  // Components of each side by index in the sorted states; a side partial
+  // over the alphabet gets its implicit dead state as a last, null one.
+  std::vector<const State *> statesA, statesB;
+  for (auto &state : states) {
+    statesA.push_back(&state);
+  }
+  for (auto &state : other.states) {
+    statesB.push_back(&state);
+  }
+  bool deadA = isPartialOver(newInputSymbols);
+  bool deadB = other.isPartialOver(newInputSymbols);
+  if (deadA) {
+    statesA.push_back(nullptr);
+  }
+  if (deadB) {
+    statesB.push_back(nullptr);
+  }
+  std::size_t symbolCount = newInputSymbols.size();
+  auto indexOf = [](const std::vector<const State *> &components,
+                    const State &state) {
+    auto end = components.end() - (components.back() == nullptr);
+    return static_cast<uint32_t>(
+        std::lower_bound(components.begin(), end, &state,
+                         [](const State *x, const State *y) {
+                           return *x < *y;
+                         }) -
+        components.begin());
+  };
+  // Successor indices of every component by symbol, the dead one for
+  // missing transitions
+  auto tableOf = [&](const DFA &dfa,
+                     const std::vector<const State *> &components) {
+    uint32_t dead = static_cast<uint32_t>(components.size() - 1);
+    std::vector<uint32_t> table(components.size() * symbolCount, dead);
+    for (std::size_t i = 0; i < components.size(); i++) {
+      auto paths = components[i] == nullptr
+                       ? dfa.transitions.end()
+                       : dfa.transitions.find(*components[i]);
+      if (paths == dfa.transitions.end()) {
+        continue;
+      }
+      std::size_t symbol = 0;
+      for (auto &input : newInputSymbols) {
+        auto path = paths->second.find(input);
+        if (path != paths->second.end()) {
+          table[i * symbolCount + symbol] = indexOf(components, path->second);
+        }
+        symbol++;
+      }
+    }
+    return table;
+  };
+  std::vector<uint32_t> nextA = tableOf(*this, statesA);
+  std::vector<uint32_t> nextB = tableOf(other, statesB);
+  auto isFinal = [](const DFA &dfa, const State *state) {
+    return state != nullptr && dfa.finalStates.count(*state) > 0;
+  };
+
+  // Pair (i, j) is state i * |statesB| + j; the pair of two dead states
+  // is the last one and is left out.
+  std::size_t countB = statesB.size();
+  std::size_t pairCount = statesA.size() * countB - (deadA && deadB);
+  // The dead state is named "" unless a state of either side is.
+  State dead;
+  while (states.count(dead) || other.states.count(dead)) {
+    dead += "'";
+  }
+  bool tracked = provenance != nullptr || other.provenance != nullptr;
+  std::vector<State> names(pairCount);
   States newStates;
-  for (auto state_a : states_a) {
-    for (auto state_b : states_b) {
-      States_v statesToAdd;
-      statesToAdd.push_back(state_a);
-      statesToAdd.push_back(state_b);
-      newStates.insert(stringifyStatesUnsorted(statesToAdd));
+  for (std::size_t pair = 0; pair < pairCount && !tracked; pair++) {
+    auto stateA = statesA[pair / countB];
+    auto stateB = statesB[pair % countB];
+    names[pair] = (stateA == nullptr ? dead : *stateA) + ',' +
+                  (stateB == nullptr ? dead : *stateB);
+    newStates.insert(names[pair]);
+  }
+  if (newStates.size() < pairCount) {
+    // A tracked product leaves the long names to describeState, and names
+    // with commas may make two pairs alike: number the pairs instead.
+    newStates.clear();
+    for (std::size_t pair = 0; pair < pairCount; pair++) {
+      names[pair] = std::to_string(pair);
+      newStates.insert(names[pair]);
     }
   }
 
   Transitions newTransitions;
-  for (auto transitionIt = transitions.begin();
-       transitionIt != transitions.end(); transitionIt++) {
-    for (auto otherTransitionIt = other.transitions.begin();
-         otherTransitionIt != other.transitions.end(); otherTransitionIt++) {
-      States_v statesToAdd;
-      statesToAdd.push_back(transitionIt->first);
-      statesToAdd.push_back(otherTransitionIt->first);
-      auto new_state = stringifyStatesUnsorted(statesToAdd);
-      for (auto symbol : inputSymbols) {
-        States_v statesToAdd;
-        statesToAdd.push_back(transitionIt->second.at(symbol));
-        statesToAdd.push_back(otherTransitionIt->second.at(symbol));
-        newTransitions[new_state][symbol] =
-            stringifyStatesUnsorted(statesToAdd);
+  States newFinalStates;
+  bool partial = false;
+  for (std::size_t pair = 0; pair < pairCount; pair++) {
+    std::size_t i = pair / countB;
+    std::size_t j = pair % countB;
+    CXXAUTOMATA_STATS_ADD(STATES_EXPLORED, 1);
+    CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, 2 * symbolCount);
+    CXXAUTOMATA_STATS_ADD(ALLOCATIONS, 2 + symbolCount);
+    Paths &paths = newTransitions[names[pair]];
+    std::size_t symbol = 0;
+    for (auto &input : newInputSymbols) {
+      std::size_t target = nextA[i * symbolCount + symbol] * countB +
+                           nextB[j * symbolCount + symbol];
+      symbol++;
+      if (target == pairCount) {
+        partial = true;
+        continue;
       }
+      paths.emplace_hint(paths.end(), input, names[target]);
+    }
+    if (accept(isFinal(*this, statesA[i]), isFinal(other, statesB[j]))) {
+      newFinalStates.insert(names[pair]);
+    }
+  }
+
+  auto newInitialState = names[indexOf(statesA, initialState) * countB +
+                               indexOf(statesB, other.initialState)];
+  std::vector<StateId> pairs;
+  if (tracked) {
+    // Ids in this and other of every new state, in the order of the names
+    std::vector<std::size_t> order(pairCount);
+    for (std::size_t pair = 0; pair < pairCount; pair++) {
+      order[pair] = pair;
     }
+    std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+      return names[x] < names[y];
+    });
+    pairs.reserve(2 * pairCount);
+    for (auto pair : order) {
+      std::size_t i = pair / countB;
+      std::size_t j = pair % countB;
+      pairs.push_back(statesA[i] == nullptr ? NO_STATE
+                                            : static_cast<StateId>(i));
+      pairs.push_back(statesB[j] == nullptr ? NO_STATE
+                                            : static_cast<StateId>(j));
+    }
+  }
+  DFA result(std::move(newStates), std::move(newInputSymbols),
+             std::move(newTransitions), std::move(newInitialState),
+             std::move(newFinalStates), partial);
+  if (tracked) {
+    result.provenance = Provenance::product(
+        provenanceOrSource(), other.provenanceOrSource(), std::move(pairs));
+    result.updateMemoryAccount();
   }
-  States_v statesToAdd;
-  statesToAdd.push_back(initialState);
-  statesToAdd.push_back(other.initialState);
-  auto newInitialState = stringifyStatesUnsorted(statesToAdd);
+  return result;
+}
 
-  return DFA(newStates, inputSymbols, newTransitions, newInitialState,
-             States());
+std::shared_ptr<const Provenance> DFA::provenanceOrSource() const {
+  return provenance != nullptr
+             ? provenance
+             : Provenance::source(States_v(states.begin(), states.end()));
 }
 
-DFA DFA::unionJoin(const DFA &other, bool retainsName, bool minify) const {
-  auto newDFA = crossProduct(other);
-  for (auto stateA : states) {
-    for (auto stateB : other.states) {
-      if (std::find(finalStates.begin(), finalStates.end(), stateA) !=
-              finalStates.end() ||
-          std::find(other.finalStates.begin(), other.finalStates.end(),
-                    stateB) != other.finalStates.end()) {
-        States_v statesToAdd;
-        statesToAdd.push_back(stateA);
-        statesToAdd.push_back(stateB);
-        newDFA.finalStates.insert(stringifyStatesUnsorted(statesToAdd));
-      }
+bool DFA::isPartialOver(const InputSymbols &alphabet) const {
+  if (alphabet.size() > inputSymbols.size()) {
+    return true;
+  }
+  for (auto &state : states) {
+    auto paths = transitions.find(state);
+    if (paths == transitions.end() || paths->second.size() < alphabet.size()) {
+      return true;
     }
   }
+  return false;
+}
+
+DFA DFA::unionJoin(const DFA &other, bool retainsName, bool minify) const {
+  auto accept = [](bool a, bool b) { return a || b; };
   if (minify) {
-    return newDFA.minify(retainsName);
+    return minimalProduct(other, accept, retainsName);
   }
-  return newDFA;
+  return crossProduct(other, accept);
+}
+
+DFA DFA::unionJoin(const DFA &other, bool retainsName,
+                   ThreadPool &pool) const {
+  return minimalProduct(
+      other, [](bool a, bool b) { return a || b; }, retainsName, &pool);
 }
 
 DFA DFA::intersection(const DFA &other, bool retainsName, bool minify) const {
-  auto newDFA = crossProduct(other);
-  for (auto stateA : finalStates) {
-    for (auto stateB : other.finalStates) {
-      States_v statesToAdd;
-      statesToAdd.push_back(stateA);
-      statesToAdd.push_back(stateB);
-      newDFA.finalStates.insert(stringifyStatesUnsorted(statesToAdd));
-    }
-  }
+  auto accept = [](bool a, bool b) { return a && b; };
   if (minify) {
-    return newDFA.minify(retainsName);
+    return minimalProduct(other, accept, retainsName);
   }
-  return newDFA;
+  return crossProduct(other, accept);
+}
+
+DFA DFA::intersection(const DFA &other, bool retainsName,
+                      ThreadPool &pool) const {
+  return minimalProduct(
+      other, [](bool a, bool b) { return a && b; }, retainsName, &pool);
 }
 
 DFA DFA::difference(const DFA &other, bool retainsName, bool minify) const {
-  auto newDFA = crossProduct(other);
-  for (auto stateA : finalStates) {
-    for (auto stateB : other.states) {
-      if (std::find(other.finalStates.begin(), other.finalStates.end(),
-                    stateB) == other.finalStates.end()) {
-        States_v statesToAdd;
-        statesToAdd.push_back(stateA);
-        statesToAdd.push_back(stateB);
-        newDFA.finalStates.insert(stringifyStatesUnsorted(statesToAdd));
-      }
-    }
-  }
+  auto accept = [](bool a, bool b) { return a && !b; };
   if (minify) {
-    return newDFA.minify(retainsName);
+    return minimalProduct(other, accept, retainsName);
   }
-  return newDFA;
+  return crossProduct(other, accept);
+}
+
+DFA DFA::difference(const DFA &other, bool retainsName,
+                    ThreadPool &pool) const {
+  return minimalProduct(
+      other, [](bool a, bool b) { return a && !b; }, retainsName, &pool);
 }
 
 DFA DFA::symmetricDifference(const DFA &other, bool retainsName,
                              bool minify) const {
-  auto newDFA = crossProduct(other);
-  for (auto stateA : states) {
-    for (auto stateB : other.states) {
-      if ((std::find(finalStates.begin(), finalStates.end(), stateA) !=
-               finalStates.end() &&
-           std::find(other.finalStates.begin(), other.finalStates.end(),
-                     stateB) == other.finalStates.end()) ||
-          (std::find(finalStates.begin(), finalStates.end(), stateA) ==
-               finalStates.end() &&
-           std::find(other.finalStates.begin(), other.finalStates.end(),
-                     stateB) != other.finalStates.end())) {
-        States_v statesToAdd;
-        statesToAdd.push_back(stateA);
-        statesToAdd.push_back(stateB);
-        newDFA.finalStates.insert(stringifyStatesUnsorted(statesToAdd));
-      }
-    }
-  }  
+  auto accept = [](bool a, bool b) { return a != b; };
   if (minify) {
-    return newDFA.minify(retainsName);
+    return minimalProduct(other, accept, retainsName);
   }
-  return newDFA;
+  return crossProduct(other, accept);
+}
+
+DFA DFA::symmetricDifference(const DFA &other, bool retainsName,
+                             ThreadPool &pool) const {
+  return minimalProduct(
+      other, [](bool a, bool b) { return a != b; }, retainsName, &pool);
 }
 
 DFA DFA::complement() const {
@@ -487,6 +677,31 @@ DFA DFA::complement() const {
       newDFA.finalStates.insert(state);
     }
   }
+  if (!isPartialOver(inputSymbols)) {
+    newDFA.updateMemoryAccount();
+    return newDFA;
+  }
+  // The implicit dead state becomes final, so it has to be added.
+  State sink;
+  while (states.find(sink) != states.end()) {
+    sink += "'";
+  }
+  auto inserted = newDFA.states.insert(sink).first;
+  newDFA.finalStates.insert(sink);
+  if (provenance != nullptr) {
+    // The sink shifts the ids of the states sorted after it.
+    StateId position = static_cast<StateId>(
+        std::distance(newDFA.states.begin(), inserted));
+    newDFA.provenance = Provenance::inserted(provenance, position, sink);
+  }
+  for (auto &state : newDFA.states) {
+    Paths &paths = newDFA.transitions[state];
+    for (auto &symbol : inputSymbols) {
+      paths.emplace(symbol, sink);
+    }
+  }
+  newDFA.allowPartial = false;
+  newDFA.updateMemoryAccount();
   return newDFA;
 }
 
@@ -500,7 +715,30 @@ bool DFA::isDisjoint(const DFA &other) const {
   return intersection(other).isEmpty();
 }
 
-bool DFA::isEmpty() const { return minify().finalStates.size() == 0; }
+bool DFA::isEmpty() const {
+  if (finalStates.empty()) {
+    return true;
+  }
+  States visited = {initialState};
+  std::deque<const State *> queue = {&initialState};
+  while (!queue.empty()) {
+    const State &state = *queue.front();
+    queue.pop_front();
+    if (finalStates.find(state) != finalStates.end()) {
+      return false;
+    }
+    auto paths = transitions.find(state);
+    if (paths == transitions.end()) {
+      continue;
+    }
+    for (auto &path : paths->second) {
+      if (visited.insert(path.second).second) {
+        queue.push_back(&path.second);
+      }
+    }
+  }
+  return true;
+}
 
 Graph DFA::makeGraph() const {
   Graph g;
@@ -525,7 +763,11 @@ Graph DFA::reverseGraph(const Graph &graph) const {
 void DFA::reachableNodes(const Graph &G, const State &v, States &vis) const {
   if (std::find(vis.begin(), vis.end(), v) == vis.end()) {
     vis.insert(v);
-    for (auto w : G.at(v)) {
+    auto edges = G.find(v);
+    if (edges == G.end()) {
+      return;
+    }
+    for (auto w : edges->second) {
       reachableNodes(G, w, vis);
     }
   }
@@ -547,14 +789,19 @@ Graph DFA::inducedSubgraph(const Graph &G, const States &S) const {
 
 bool DFA::hasCycle(const Graph &G) const {
   std::function<bool(const Graph &, const State &, States &, States &)> dfs =
-      [dfs](const Graph &G, const State &at, States &vis,
+      [&dfs](const Graph &G, const State &at, States &vis,
             States &stack) -> bool {
     // Helper function which accepts input parameters for the graph, current
     // node, visited set and current stack
     if (std::find(vis.begin(), vis.end(), at) == vis.end()) {
       vis.insert(at);
       stack.insert(at);
-      for (auto k : G.at(at)) {
+      auto edges = G.find(at);
+      if (edges == G.end()) {
+        stack.erase(at);
+        return false;
+      }
+      for (auto k : edges->second) {
         if (std::find(vis.begin(), vis.end(), k) == vis.end() &&
             dfs(G, k, vis, stack)) {
           return true;
@@ -604,6 +851,10 @@ bool DFA::isFinite() const {
   return !containsCycle;
 }
 
+std::vector<InputSymbols> DFA::symbolClasses() const {
+  return CompiledDFA(*this).getSymbolClasses();
+}
+
 std::string DFA::stringifyStatesUnsorted(const States_v &states) {
   std::stringstream ss;
   int i = 0;
@@ -622,7 +873,7 @@ std::string DFA::stringifyStates(const States_v &states) {
   States_v sortedStates = states;
   std::sort(sortedStates.begin(), sortedStates.end());
   int i = 0;
-  for (auto state : states) {
+  for (auto state : sortedStates) {
     ss << state;
     if (i != states.size() - 1) {
       ss << ",";
@@ -632,86 +883,370 @@ std::string DFA::stringifyStates(const States_v &states) {
   return ss.str();
 }
 
-void DFA::addNfaStatesFromQueue(const NFA &nfa, const State &currentState,
+void DFA::addNfaStatesFromQueue(const NFA &nfa, const States &currentStates,
                                 const State &currentStateName,
                                 States &dfaStates, Transitions &dfaTransitions,
                                 States &dfaFinalStates) {
   dfaStates.insert(currentStateName);
   dfaTransitions[currentStateName] = Paths();
-  if (std::find(nfa.getFinalStates().begin(), nfa.getFinalStates().end(),
-                currentState) != nfa.getFinalStates().end()) {
-    dfaFinalStates.insert(currentStateName);
+  CXXAUTOMATA_STATS_ADD(STATES_EXPLORED, 1);
+  CXXAUTOMATA_STATS_ADD(ALLOCATIONS, 2 + nfa.getInputSymbols().size());
+  for (auto &state : currentStates) {
+    if (nfa.getFinalStates().find(state) != nfa.getFinalStates().end()) {
+      dfaFinalStates.insert(currentStateName);
+      break;
+    }
   }
 }
 
-void DFA::enqueueNextNfaCurrentStates(const NFA &nfa, const State &currentState,
+void DFA::enqueueNextNfaCurrentStates(const NFA &nfa,
+                                      const States &currentStates,
                                       const State &currentStateName,
-                                      States &stateQueue,
+                                      std::deque<States> &stateQueue,
                                       Transitions &dfaTransitions) {
-  for (auto inputSymbol : nfa.getInputSymbols()) {
-    State nextCurrentState = nfa.getNextCurrentState(currentState, inputSymbol);
+  for (auto &inputSymbol : nfa.getInputSymbols()) {
+    States nextCurrentStates =
+        nfa.getNextCurrentStates(currentStates, inputSymbol);
+    CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, currentStates.size());
+    States_v nextCurrentStates_v;
+    set2Vector(nextCurrentStates, nextCurrentStates_v);
     dfaTransitions[currentStateName][inputSymbol] =
-        stringifyStates({nextCurrentState});
-    stateQueue.insert(nextCurrentState);
+        stringifyStates(nextCurrentStates_v);
+    stateQueue.push_back(nextCurrentStates);
   }
 }
 
 DFA DFA::fromNFA(const NFA &nfa) {
+  CXXAUTOMATA_STATS_SCOPE(FROM_NFA);
   States dfaStates;
   InputSymbols dfaInputSymbols = nfa.getInputSymbols();
   Transitions dfaTransitions;
-  auto nfaInitialState = nfa.getLambdaClosure(nfa.getInitialState());
-  States_v nfaInitialState_v;
-  set2Vector(nfaInitialState, nfaInitialState_v);
-  State dfaInitialState = stringifyStates(nfaInitialState_v);
+  auto nfaInitialStates = nfa.getLambdaClosure(nfa.getInitialState());
+  States_v nfaInitialStates_v;
+  set2Vector(nfaInitialStates, nfaInitialStates_v);
+  State dfaInitialState = stringifyStates(nfaInitialStates_v);
   States dfaFinalStates;
 
-  States stateQueue;
-  for (auto state : nfaInitialState) {
-    stateQueue.insert(state);
-  }
+  std::deque<States> stateQueue;
+  stateQueue.push_back(nfaInitialStates);
 
   while (!stateQueue.empty()) {
-    State currentState = *stateQueue.begin();
-    stateQueue.erase(stateQueue.begin());
-    State currentStateName = stringifyStates({currentState});
-    if (std::find(dfaStates.begin(), dfaStates.end(), currentStateName) !=
-        dfaStates.end()) {
+    States currentStates = stateQueue.front();
+    stateQueue.pop_front();
+    States_v currentStates_v;
+    set2Vector(currentStates, currentStates_v);
+    State currentStateName = stringifyStates(currentStates_v);
+    if (dfaStates.find(currentStateName) != dfaStates.end()) {
       // We've been here before and nothing should have changed.
       continue;
     }
-    addNfaStatesFromQueue(nfa, currentState, currentStateName, dfaStates,
+    addNfaStatesFromQueue(nfa, currentStates, currentStateName, dfaStates,
                           dfaTransitions, dfaFinalStates);
-    enqueueNextNfaCurrentStates(nfa, currentState, currentStateName, stateQueue,
-                                dfaTransitions);
+    enqueueNextNfaCurrentStates(nfa, currentStates, currentStateName,
+                                stateQueue, dfaTransitions);
   }
 
   return DFA(dfaStates, dfaInputSymbols, dfaTransitions, dfaInitialState,
              dfaFinalStates);
 }
 
-void DFA::showDiagram(const std::string &path) const {
-  std::ofstream dotFile;
-  dotFile.open(path + ".dot");
-  dotFile << "digraph DFA {\n";
-  dotFile << "rankdir=LR;\n";
-  dotFile << "node [shape = circle];\n";
-  for (auto state : states) {
-    dotFile << state << ";\n";
+namespace {
+
+typedef std::vector<uint32_t> Subset;
+
+struct SubsetHash {
+  std::size_t operator()(const Subset &subset) const {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto state : subset) {
+      hash = (hash ^ state) * 0x100000001b3ull;
+    }
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
   }
-  for (auto state : states) {
-    for (auto inputSymbol : inputSymbols) {
-      dotFile << state << " -> " << transitions.at(state).at(inputSymbol)
-              << " [label = \"" << inputSymbol << "\"];\n";
+};
+
+} // namespace
+
+DFA DFA::fromNFA(const NFA &nfa, ThreadPool &pool) {
+  CXXAUTOMATA_STATS_SCOPE(FROM_NFA);
+  const States &nfaStates = nfa.getStates();
+  const NFATransitions &nfaTransitions = nfa.getNFATransitions();
+  States_v names(nfaStates.begin(), nfaStates.end());
+  InputSymbols_v symbols(nfa.getInputSymbols().begin(),
+                         nfa.getInputSymbols().end());
+  std::size_t stateCount = names.size();
+  std::size_t symbolCount = symbols.size();
+  auto idOf = [&](const State &state) {
+    return static_cast<uint32_t>(
+        std::lower_bound(names.begin(), names.end(), state) - names.begin());
+  };
+
+  // Lambda closures and moves of the NFA states by id. Ids follow the
+  // sorted names, so a sorted subset is named as stringifyStates names it.
+  std::vector<Subset> closures(stateCount);
+  std::vector<Subset> moves(stateCount * symbolCount);
+  pool.parallelFor(stateCount, 64, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t state = begin; state < end; state++) {
+      for (auto &member : nfa.getLambdaClosure(names[state])) {
+        closures[state].push_back(idOf(member));
+      }
+      auto transition = nfaTransitions.find(names[state]);
+      if (transition == nfaTransitions.end()) {
+        continue;
+      }
+      for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+        auto path = transition->second.find(symbols[symbol]);
+        if (path == transition->second.end()) {
+          continue;
+        }
+        for (auto &target : path->second) {
+          moves[state * symbolCount + symbol].push_back(idOf(target));
+        }
+      }
+    }
+  });
+
+  ParallelExplorer<Subset, SubsetHash> explorer(pool, symbolCount);
+  explorer.explore(closures[idOf(nfa.getInitialState())],
+                   [&](const Subset &subset, std::size_t symbol,
+                       Subset &target) {
+                     target.clear();
+                     for (auto state : subset) {
+                       for (auto end : moves[state * symbolCount + symbol]) {
+                         target.insert(target.end(), closures[end].begin(),
+                                       closures[end].end());
+                       }
+                     }
+                     std::sort(target.begin(), target.end());
+                     target.erase(std::unique(target.begin(), target.end()),
+                                  target.end());
+                     return true;
+                   });
+
+  const std::vector<Subset> &subsets = explorer.getStates();
+  States_v subsetNames(subsets.size());
+  std::vector<char> subsetFinal(subsets.size(), 0);
+  pool.parallelFor(subsets.size(), 64, [&](std::size_t begin,
+                                           std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      for (auto state : subsets[i]) {
+        if (state != subsets[i].front()) {
+          subsetNames[i] += ',';
+        }
+        subsetNames[i] += names[state];
+        if (nfa.getFinalStates().count(names[state]) > 0) {
+          subsetFinal[i] = 1;
+        }
+      }
+    }
+  });
+  CXXAUTOMATA_STATS_ADD(STATES_EXPLORED, subsets.size());
+
+  States dfaStates;
+  Transitions dfaTransitions;
+  States dfaFinalStates;
+  for (std::size_t i = 0; i < subsets.size(); i++) {
+    dfaStates.insert(subsetNames[i]);
+    if (subsetFinal[i]) {
+      dfaFinalStates.insert(subsetNames[i]);
+    }
+    Paths &paths = dfaTransitions[subsetNames[i]];
+    for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+      StateId target = explorer.next(static_cast<StateId>(i),
+                                     static_cast<SymbolId>(symbol));
+      paths.emplace_hint(paths.end(), symbols[symbol], subsetNames[target]);
     }
   }
-  for (auto state : finalStates) {
-    dotFile << state << " [shape = doublecircle];\n";
+  return DFA(std::move(dfaStates), nfa.getInputSymbols(),
+             std::move(dfaTransitions), subsetNames[0],
+             std::move(dfaFinalStates));
+}
+
+namespace {
+
+void writeDotId(std::ostream &out, const std::string &id) {
+  out << '"';
+  for (char c : id) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+/**
+ * @brief Build a label listing the given symbol indexes, collapsing runs of
+ * three or more consecutive symbols into "first-last".
+ *
+ */
+std::string rangeLabel(const std::vector<std::size_t> &indexes,
+                       const InputSymbols_v &symbols) {
+  std::string label;
+  for (std::size_t i = 0; i < indexes.size();) {
+    std::size_t j = i;
+    while (j + 1 < indexes.size() && indexes[j + 1] == indexes[j] + 1) {
+      j++;
+    }
+    if (!label.empty()) {
+      label += ",";
+    }
+    label += symbols[indexes[i]];
+    if (j - i >= 2) {
+      label += "-" + symbols[indexes[j]];
+    } else if (j == i + 1) {
+      label += "," + symbols[indexes[j]];
+    }
+    i = j + 1;
+  }
+  return label;
+}
+
+} // namespace
+
+States DFA::diagramStates(const DiagramOptions &options) const {
+  if (options.scope == DiagramOptions::ALL) {
+    return states;
+  }
+  auto g = makeGraph();
+  auto revG = reverseGraph(g);
+  auto bfs = [](const Graph &G, const States &sources, States &vis,
+                const std::function<bool(const State &, unsigned)> &expand) {
+    std::deque<std::pair<State, unsigned>> queue;
+    for (auto &source : sources) {
+      if (vis.insert(source).second) {
+        queue.push_back(std::make_pair(source, 0u));
+      }
+    }
+    while (!queue.empty()) {
+      auto current = queue.front();
+      queue.pop_front();
+      auto edges = G.find(current.first);
+      if (edges == G.end() || !expand(current.first, current.second)) {
+        continue;
+      }
+      for (auto &next : edges->second) {
+        if (vis.insert(next).second) {
+          queue.push_back(std::make_pair(next, current.second + 1));
+        }
+      }
+    }
+  };
+  auto always = [](const State &, unsigned) { return true; };
+
+  if (options.scope == DiagramOptions::CORE) {
+    States accessibleNodes;
+    bfs(g, {initialState}, accessibleNodes, always);
+    States coaccessibleNodes;
+    bfs(revG, finalStates, coaccessibleNodes, always);
+    States importantNodes;
+    std::set_intersection(
+        accessibleNodes.begin(), accessibleNodes.end(),
+        coaccessibleNodes.begin(), coaccessibleNodes.end(),
+        std::inserter(importantNodes, importantNodes.begin()));
+    return importantNodes;
+  }
+
+  if (states.find(options.center) == states.end()) {
+    std::stringstream ss;
+    ss << options.center << " is not a valid state";
+    throw InvalidStateException(ss.str());
+  }
+  // Successors and predecessors together form the undirected neighbourhood.
+  for (auto &edges : revG) {
+    g[edges.first].insert(edges.second.begin(), edges.second.end());
+  }
+  States neighbourhood;
+  bfs(g, {options.center}, neighbourhood,
+      [&options](const State &, unsigned distance) {
+        return distance < options.radius;
+      });
+  return neighbourhood;
+}
+
+void DFA::writeDiagram(std::ostream &out,
+                       const DiagramOptions &options) const {
+  States shown = diagramStates(options);
+  InputSymbols_v symbols;
+  set2Vector(inputSymbols, symbols);
+  std::map<InputSymbol, std::size_t> symbolIndexes;
+  for (std::size_t i = 0; i < symbols.size(); i++) {
+    symbolIndexes.emplace_hint(symbolIndexes.end(), symbols[i], i);
+  }
+
+  out << "digraph DFA {\n";
+  out << "rankdir=LR;\n";
+  out << "node [shape = circle];\n";
+  for (auto &state : shown) {
+    writeDotId(out, state);
+    if (finalStates.find(state) != finalStates.end()) {
+      out << " [shape = doublecircle]";
+    }
+    out << ";\n";
+  }
+  if (shown.find(initialState) != shown.end()) {
+    out << "__start [shape = point];\n__start -> ";
+    writeDotId(out, initialState);
+    out << ";\n";
+  }
+  std::map<State, std::vector<std::size_t>> edges;
+  for (auto &state : shown) {
+    auto transition = transitions.find(state);
+    if (transition == transitions.end()) {
+      continue;
+    }
+    edges.clear();
+    for (auto &path : transition->second) {
+      if (shown.find(path.second) == shown.end()) {
+        continue;
+      }
+      if (!options.mergeEdges) {
+        writeDotId(out, state);
+        out << " -> ";
+        writeDotId(out, path.second);
+        out << " [label = ";
+        writeDotId(out, path.first);
+        out << "];\n";
+        continue;
+      }
+      edges[path.second].push_back(symbolIndexes.at(path.first));
+    }
+    for (auto &edge : edges) {
+      std::sort(edge.second.begin(), edge.second.end());
+      writeDotId(out, state);
+      out << " -> ";
+      writeDotId(out, edge.first);
+      out << " [label = ";
+      writeDotId(out, rangeLabel(edge.second, symbols));
+      out << "];\n";
+    }
   }
-  dotFile << "}\n";
+  out << "}\n";
+}
+
+std::string DFA::toDot(const DiagramOptions &options) const {
+  std::stringstream ss;
+  writeDiagram(ss, options);
+  return ss.str();
+}
+
+void DFA::showDiagram(const std::string &path) const {
+  std::string dotPath = path + ".dot";
+  std::string pngPath = path + ".png";
+  std::ofstream dotFile(dotPath);
+  writeDiagram(dotFile);
   dotFile.close();
-  std::string command = "dot -Tpng " + path + ".dot -o " + path + ".png";
-  system(command.c_str());
+
+  std::vector<std::string> args = {"dot", "-Tpng", dotPath, "-o", pngPath};
+  std::vector<char *> argv;
+  for (auto &arg : args) {
+    argv.push_back(&arg[0]);
+  }
+  argv.push_back(nullptr);
+  pid_t pid;
+  if (posix_spawnp(&pid, "dot", nullptr, nullptr, argv.data(), environ) == 0) {
+    int status;
+    waitpid(pid, &status, 0);
+  }
 }
 
 } // namespace CXXAUTOMATA
@@ -2,25 +2,77 @@
 #define CXXAUTOMATA_DFA
 
 #include "FA.hpp"
+#include "Fingerprint.hpp"
+#include "Provenance.hpp"
+#include "SubsetConstruction.hpp"
+#include "TraceRecorder.hpp"
 #include "Typedefs.hpp"
+#include <deque>
+#include <ostream>
 #include <set>
+#include <vector>
 
 namespace CXXAUTOMATA {
+/**
+ * @brief Options controlling which part of a DFA a diagram shows.
+ *
+ */
+struct DiagramOptions {
+  enum Scope {
+    /** every state */
+    ALL,
+    /** states both accessible and co-accessible */
+    CORE,
+    /** states at most radius transitions away from center, in either
+        direction */
+    NEIGHBOURHOOD
+  };
+
+  DiagramOptions() : scope(ALL), radius(1), mergeEdges(true) {}
+
+  Scope scope;
+  State center;
+  unsigned radius;
+  /** If true, parallel edges are drawn once with symbol-range labels. */
+  bool mergeEdges;
+};
+
 /**
  * @brief A deterministic finite automaton.
  *
  */
 
+class CompiledDFA;
 class NFA;
+class ThreadPool;
 class DFA : public FA {
 public:
-  DFA(const States &states, const InputSymbols &inputSymbols,
-      const Transitions &transitions, const State &initialState,
-      const States &finalStates, bool allowPartial = false);
+  /**
+   * @brief Construct a new DFA object. The arguments are taken by value so
+   *        that large automata built by the caller can be moved in.
+   *
+   *        If allowPartial is true, a state may omit transitions, or have no
+   *        entry in transitions at all. A missing transition leads to an
+   *        implicit dead state which every operation understands without
+   *        adding it.
+   *
+   */
+  DFA(States states, InputSymbols inputSymbols, Transitions transitions,
+      State initialState, States finalStates, bool allowPartial = false);
 
   DFA(const DFA &dfa);
+  DFA &operator=(const DFA &rhs);
   virtual ~DFA();
 
+  /**
+   * @brief Return the estimated memory held by this DFA. The provenance
+   *        record, if any, counts as auxiliary; records it shares with its
+   *        sources are not included.
+   *
+   * @return MemoryUsage
+   */
+  MemoryUsage memoryUsage() const override;
+
   /**
    * @brief Return True if two DFAs are equivalent.
    *
@@ -91,6 +143,32 @@ public:
    */
   bool validate() const override;
 
+  /**
+   * @brief Check the DFA like validate() without throwing, and return
+   *        every violation found instead of the first one. Messages are
+   *        only formatted when the result is asked for them.
+   *
+   * @return ValidationResult
+   */
+  ValidationResult validateAll() const;
+
+  /**
+   * @brief Construct a DFA like the constructor does, but return the
+   *        validation result instead of throwing when it is invalid.
+   *
+   * @param states
+   * @param inputSymbols
+   * @param transitions
+   * @param initialState
+   * @param finalStates
+   * @param allowPartial
+   * @return CreateResult<DFA>
+   */
+  static CreateResult<DFA> tryCreate(States states, InputSymbols inputSymbols,
+                                     Transitions transitions,
+                                     State initialState, States finalStates,
+                                     bool allowPartial = false);
+
   /**
    * @brief Check if the given string is accepted by this DFA.
    *        Yield the current configuration of the DFA at each step.
@@ -98,12 +176,51 @@ public:
    * @param input_str
    * @return States
    */
-  States_v readInputStepwise(const InputSymbols_v &input_str) override;
+  States_v readInputStepwise(const InputSymbols_v &input_str) const override;
+
+  /**
+   * @brief Walk input like readInputStepwise without copying any state
+   *        name: visitor is called after every symbol with the id of the
+   *        state entered, which is its index in getStates(). The first
+   *        trace compiles this DFA into a CompiledDFA that later traces of
+   *        the same object reuse, so each step costs a symbol lookup and a
+   *        table read. The compiled form is kept until the DFA is
+   *        destroyed or assigned, and it is not part of memoryUsage().
+   *
+   * @param input_str
+   * @param visitor
+   * @return StateId the id of the last state, or NO_STATE if the input
+   *         leaves the DFA, after the steps taken so far were visited
+   */
+  StateId traceInput(const InputSymbols_v &input_str,
+                     const TraceVisitor &visitor) const;
+
+  /**
+   * @brief Walk input like traceInput, recording the states in recorder.
+   *
+   * @param input_str
+   * @param recorder
+   * @return StateId
+   */
+  StateId traceInput(const InputSymbols_v &input_str,
+                     TraceRecorder &recorder) const;
+
+  /**
+   * @brief Return True if input is accepted. Unlike readInput, this walks
+   *        the transitions without recording the path or throwing.
+   *
+   * @param input_str
+   * @return true
+   * @return false
+   */
+  bool acceptsInput(const InputSymbols_v &input_str) const override;
 
   /**
    * @brief Create a minimal DFA which accepts the same inputs as this DFA.
    *        First, non-reachable states are removed.
    *        Then, similiar states are merged using Hopcroft's Algorithm.
+   *        Missing transitions of a partial DFA lead to an implicit dead
+   *        state, which is left out of the result again.
    *        retain_names: If True, merged states retain names.
    *        If False, new states will be named 0, ..., n-1.
    *
@@ -112,10 +229,46 @@ public:
    */
   DFA minify(bool retainNames = true) const;
 
+  /**
+   * @brief Same as minify(retainNames), with the equivalent states found by
+   *        refining state signatures in parallel rounds on pool. The result
+   *        is identical to the sequential one. Every round splits the blocks
+   *        by one more symbol of lookahead, so this pays off on large
+   *        automata whose states are told apart by short words.
+   *
+   * @param retainNames
+   * @param pool
+   * @return DFA
+   */
+  DFA minify(bool retainNames, ThreadPool &pool) const;
+
+  /**
+   * @brief Return the canonical form of this DFA: its minimal DFA with the
+   *        states numbered 0, 1, ... in breadth-first order from the initial
+   *        state, following the symbols in sorted order. Equivalent DFAs
+   *        over the same alphabet have identical canonical forms.
+   *
+   * @param fingerprint if not null, receives the fingerprint of the form
+   * @return DFA
+   */
+  DFA canonical(Fingerprint *fingerprint = nullptr) const;
+
+  /**
+   * @brief Return the 128-bit hash of the canonical form, which is equal
+   *        for equivalent DFAs over the same alphabet. Costs a
+   *        minimization.
+   *
+   * @return Fingerprint
+   */
+  Fingerprint fingerprint() const;
+
   /**
    * @brief Takes as input two DFAs M1 and M2 which
    *        accept languages L1 and L2 respectively.
    *        Returns a DFA which accepts the union of L1 and L2.
+   *        M1 and M2 may have different alphabets: the result is over
+   *        their union, and a symbol an automaton lacks sends it to an
+   *        implicit dead state, which is never added to its table.
    *
    * @param other
    * @param retainsName
@@ -125,10 +278,22 @@ public:
   DFA unionJoin(const DFA &other, bool retainsName = false,
                 bool minify = true) const;
 
+  /**
+   * @brief Same as unionJoin(other, retainsName), with the reachable product
+   *        explored and minimized on pool. The result is identical.
+   *
+   * @param other
+   * @param retainsName
+   * @param pool
+   * @return DFA
+   */
+  DFA unionJoin(const DFA &other, bool retainsName, ThreadPool &pool) const;
+
   /**
    * @brief Takes as input two DFAs M1 and M2 which
    *        accept languages L1 and L2 respectively.
    *        Returns a DFA which accepts the intersection of L1 and L2.
+   *        The alphabets may differ, as in unionJoin.
    *
    * @param other
    * @param retainsName
@@ -138,10 +303,22 @@ public:
   DFA intersection(const DFA &other, bool retainsName = false,
                    bool minify = true) const;
 
+  /**
+   * @brief Same as intersection(other, retainsName), with the reachable product
+   *        explored and minimized on pool. The result is identical.
+   *
+   * @param other
+   * @param retainsName
+   * @param pool
+   * @return DFA
+   */
+  DFA intersection(const DFA &other, bool retainsName, ThreadPool &pool) const;
+
   /**
    * @brief Takes as input two DFAs M1 and M2 which
    *        accept languages L1 and L2 respectively.
    *        Returns a DFA which accepts the difference of L1 and L2.
+   *        The alphabets may differ, as in unionJoin.
    *
    * @param other
    * @param retainsName
@@ -151,10 +328,22 @@ public:
   DFA difference(const DFA &other, bool retainsName = false,
                  bool minify = true) const;
 
+  /**
+   * @brief Same as difference(other, retainsName), with the reachable product
+   *        explored and minimized on pool. The result is identical.
+   *
+   * @param other
+   * @param retainsName
+   * @param pool
+   * @return DFA
+   */
+  DFA difference(const DFA &other, bool retainsName, ThreadPool &pool) const;
+
   /**
    * @brief Takes as input two DFAs M1 and M2 which
    *        accept languages L1 and L2 respectively.
    *        Returns a DFA which accepts the symmetric difference of L1 and L2.
+   *        The alphabets may differ, as in unionJoin.
    *
    * @param other
    * @param retainsName
@@ -165,7 +354,76 @@ public:
                           bool minify = true) const;
 
   /**
-   * @brief Return the complement of this DFA.
+   * @brief Same as symmetricDifference(other, retainsName), with the
+   *        reachable product explored and minimized on pool. The result is
+   *        identical.
+   *
+   * @param other
+   * @param retainsName
+   * @param pool
+   * @return DFA
+   */
+  DFA symmetricDifference(const DFA &other, bool retainsName,
+                          ThreadPool &pool) const;
+
+  /**
+   * @brief Return a minimal DFA which accepts the words of this DFA followed
+   *        by words of the other DFA, over both alphabets. Only the
+   *        reachable subsets are built (see SubsetConstruction).
+   *
+   * @param other
+   * @param budget
+   * @return DFA
+   */
+  DFA concatenate(const DFA &other,
+                  const ConstructionBudget &budget = ConstructionBudget())
+      const;
+
+  /**
+   * @brief Return a minimal DFA which accepts any number of words of this
+   *        DFA, including none.
+   *
+   * @param budget
+   * @return DFA
+   */
+  DFA star(const ConstructionBudget &budget = ConstructionBudget()) const;
+
+  /**
+   * @brief Return a minimal DFA which accepts the words of this DFA spelled
+   *        backwards.
+   *
+   * @param budget
+   * @return DFA
+   */
+  DFA reverse(const ConstructionBudget &budget = ConstructionBudget()) const;
+
+  /**
+   * @brief Return a minimal DFA which accepts the words w such that uw is
+   *        accepted by this DFA for some word u accepted by the other DFA.
+   *
+   * @param other
+   * @param budget
+   * @return DFA
+   */
+  DFA leftQuotient(const DFA &other,
+                   const ConstructionBudget &budget = ConstructionBudget())
+      const;
+
+  /**
+   * @brief Return a minimal DFA which accepts the words w such that wu is
+   *        accepted by this DFA for some word u accepted by the other DFA.
+   *
+   * @param other
+   * @param budget
+   * @return DFA
+   */
+  DFA rightQuotient(const DFA &other,
+                    const ConstructionBudget &budget = ConstructionBudget())
+      const;
+
+  /**
+   * @brief Return the complement of this DFA. A partial DFA gets one
+   *        final sink for its missing transitions; the result is complete.
    *
    * @return DFA
    */
@@ -199,7 +457,8 @@ public:
   bool isDisjoint(const DFA &other) const;
 
   /**
-   * @brief Return True if this DFA is completely empty.
+   * @brief Return True if this DFA is completely empty, i.e. no final state
+   *        is reachable.
    *
    * @return true
    * @return false
@@ -214,6 +473,15 @@ public:
    */
   bool isFinite() const;
 
+  /**
+   * @brief Return the classes of symbols that lead every state to the same
+   *        state, ordered by their smallest symbol. Matching only needs one
+   *        table column per class (see CompiledDFA).
+   *
+   * @return std::vector<InputSymbols>
+   */
+  std::vector<InputSymbols> symbolClasses() const;
+
   /**
    * @brief Stringify the given set of states as a single state name.
    *
@@ -239,53 +507,149 @@ public:
   static DFA fromNFA(const NFA &nfa);
 
   /**
-   * @brief  Creates the graph associated with this DFA
+   * @brief Same as fromNFA(nfa), with the subsets explored on pool. The
+   *        result is identical.
+   *
+   * @param nfa
+   * @param pool
+   * @return DFA
+   */
+  static DFA fromNFA(const NFA &nfa, ThreadPool &pool);
+
+  /**
+   * @brief Write the graph associated with this DFA in the DOT language.
+   *        Parallel edges are merged into one edge labelled with runs of
+   *        consecutive symbols, e.g. "a-z,0".
+   *
+   * @param out
+   * @param options
+   */
+  void writeDiagram(std::ostream &out,
+                    const DiagramOptions &options = DiagramOptions()) const;
+
+  /**
+   * @brief Return the graph associated with this DFA in the DOT language.
+   *
+   * @param options
+   * @return std::string
+   */
+  std::string toDot(const DiagramOptions &options = DiagramOptions()) const;
+
+  /**
+   * @brief  Creates the graph associated with this DFA.
+   *         Writes <path>.dot and renders <path>.png with Graphviz, which
+   *         is run directly (not through a shell) and waited for.
    *
    * @param path
    */
   void showDiagram(const std::string &path = "") const;
 
+  /**
+   * @brief Return True if this DFA may omit transitions.
+   *
+   * @return true
+   * @return false
+   */
+  bool getAllowPartial() const;
+
+  /**
+   * @brief Return a copy of this DFA that records the provenance of the
+   *        automata derived from it. Products and minimization of DFAs
+   *        that record provenance record it in their result as state ids
+   *        and number the result's states whatever retainNames, so names
+   *        stay short over chains of operations while describeState still
+   *        tells where each state comes from.
+   *
+   * @return DFA
+   */
+  DFA withProvenance() const;
+
+  /**
+   * @brief Return the provenance of this DFA, or null if it records none.
+   *
+   * @return const std::shared_ptr<const Provenance>&
+   */
+  const std::shared_ptr<const Provenance> &getProvenance() const;
+
+  /**
+   * @brief Return the name the state would have had if every operation
+   *        since withProvenance() had kept names, or the state's own name
+   *        without provenance. state is an index in getStates().
+   *
+   * @param state
+   * @return std::string
+   */
+  std::string describeState(StateId state) const;
+
+  /**
+   * @brief Like describeState(StateId), for a state given by name. Finding
+   *        the index of the state costs O(|Q|).
+   *
+   * @param state
+   * @return std::string
+   */
+  std::string describeState(const State &state) const;
+
 private:
+  friend class IndexedDFA;
+  friend class SubsetConstruction;
+
   /**
-   * @brief Raise an error if the transition input_symbols are missing.
+   * @brief Construct an empty DFA to be filled in by an operation whose
+   *        result is valid by construction.
+   *
+   */
+  DFA();
+
+  /**
+   * @brief Record an error for every input symbol missing from paths.
    *
    * @param start_state
    * @param paths
+   * @param result
    */
   void validateTransitionMissingSymbols(const State &start_state,
-                                        const Paths &paths) const;
+                                        const Paths &paths,
+                                        ValidationResult &result) const;
 
   /**
-   * @brief Raise an error if transition input symbols are invalid.
+   * @brief Record an error for every invalid transition input symbol.
    *
    * @param start_state
    * @param paths
+   * @param result
    */
   void validateTransitionInvalidSymbols(const State &start_state,
-                                        const Paths &paths) const;
+                                        const Paths &paths,
+                                        ValidationResult &result) const;
 
   /**
-   * @brief Raise an error if transition start states are missing.
+   * @brief Record an error for every missing transition start state.
    *
+   * @param result
    */
-  void validateTransitionStartStates() const;
+  void validateTransitionStartStates(ValidationResult &result) const;
 
   /**
-   * @brief Raise an error if transition end states are invalid.
+   * @brief Record an error for every invalid transition end state.
    *
    * @param start_state
    * @param paths
+   * @param result
    */
   void validateTransitionEndStates(const State &start_state,
-                                   const Paths &paths) const;
+                                   const Paths &paths,
+                                   ValidationResult &result) const;
 
   /**
-   * @brief Raise an error if transitions are missing or invalid.
+   * @brief Record an error for every missing or invalid transition.
    *
    * @param start_state
    * @param paths
+   * @param result
    */
-  void validateTransitions(const State &start_state, const Paths &paths) const;
+  void validateTransitions(const State &start_state, const Paths &paths,
+                           ValidationResult &result) const;
 
   /**
    * @brief Follow the transition for the given input symbol on the current
@@ -307,30 +671,57 @@ private:
   void checkForInputRejection(const State &current_state) const;
 
   /**
-   * @brief Remove states which are not reachable from the initial
-   * state.
+   * @brief Returns the minimal DFA of the reachable cross product of DFAs
+   *        self and other, built in a scratch arena without materializing
+   *        the product. A pair of states is final if accept(final in self,
+   *        final in other) is true. Dead sides are handled as in
+   *        crossProduct. The product is explored and minimized on pool if
+   *        one is given.
    *
+   * @param other
+   * @param accept
+   * @param retainNames
+   * @param pool
+   * @return DFA
    */
-  void removeUnreachableStates();
+  DFA minimalProduct(const DFA &other, bool (*accept)(bool, bool),
+                     bool retainNames, ThreadPool *pool = nullptr) const;
 
   /**
-   * @brief Compute the states which are reachable from the initial
-   * state.
+   * @brief Creates a new DFA which is the cross product of DFAs self and other
+   *        over the union of their alphabets. A pair of states is final if
+   *        accept(final in self, final in other) is true.
    *
-   * @return a set of unreachable states
+   *        Symbols missing from one alphabet and missing transitions lead
+   *        that side to its implicit dead state, written as the empty name
+   *        (e.g. "q0,"), or with primes appended to it if a state of either
+   *        side is already named so. Pairs of two dead states are left out,
+   *        so the product is partial if both sides can die at once. The
+   *        pairs are numbered instead if either side records provenance,
+   *        or if names with commas would make two pairs alike.
+   *
+   * @param other
+   * @param accept
+   * @return DFA
    */
-  std::set<State> computeReachableStates() const;
+  DFA crossProduct(const DFA &other, bool (*accept)(bool, bool)) const;
 
-  void mergeStates(bool retainNames = false);
+  /**
+   * @brief Return True if, over the given alphabet (a superset of this
+   *        DFA's), some transition is missing.
+   *
+   * @param alphabet
+   * @return true
+   * @return false
+   */
+  bool isPartialOver(const InputSymbols &alphabet) const;
 
   /**
-   * @brief Creates a new DFA which is the cross product of DFAs self and other
-   *        with an empty set of final states.
+   * @brief Return the provenance, or a source provenance of the names.
    *
-   * @param other
-   * @return DFA
+   * @return std::shared_ptr<const Provenance>
    */
-  DFA crossProduct(const DFA &other) const;
+  std::shared_ptr<const Provenance> provenanceOrSource() const;
 
   /**
    * @brief Returns a simple graph representation of the DFA.
@@ -339,6 +730,14 @@ private:
    */
   Graph makeGraph() const;
 
+  /**
+   * @brief Returns the states of the given diagram scope.
+   *
+   * @param options
+   * @return States
+   */
+  States diagramStates(const DiagramOptions &options) const;
+
   /**
    * @brief Returns the graph G where all edges have been reversed.
    *
@@ -379,13 +778,13 @@ private:
    * @brief Add NFA states to DFA as it is constructed from NFA.
    *
    * @param nfa
-   * @param current_states
-   * @param current_state_name
-   * @param dfa_states
-   * @param dfa_transitions
-   * @param dfa_final_states
+   * @param currentStates
+   * @param currentStateName
+   * @param dfaStates
+   * @param dfaTransitions
+   * @param dfaFinalStates
    */
-  static void addNfaStatesFromQueue(const NFA &nfa, const State &currentState,
+  static void addNfaStatesFromQueue(const NFA &nfa, const States &currentStates,
                                     const State &currentStateName,
                                     States &dfaStates,
                                     Transitions &dfaTransitions,
@@ -401,12 +800,22 @@ private:
    * @param dfaTransitions
    */
   static void enqueueNextNfaCurrentStates(const NFA &nfa,
-                                          const State &currentState,
+                                          const States &currentStates,
                                           const State &currentStateName,
-                                          States &stateQueue,
+                                          std::deque<States> &stateQueue,
                                           Transitions &dfaTransitions);
 
+  /**
+   * @brief Return the compiled form traceInput walks, compiling it on the
+   *        first call. Safe to call from several threads.
+   *
+   */
+  std::shared_ptr<const CompiledDFA> getMatcher() const;
+
   bool allowPartial;
+  std::shared_ptr<const Provenance> provenance;
+  /** built by getMatcher(); not copied with the DFA */
+  mutable std::shared_ptr<const CompiledDFA> matcher;
 };
 } // namespace CXXAUTOMATA
 
@@ -0,0 +1,67 @@
+#include "Fingerprint.hpp"
+#include <cstring>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+inline uint64_t rotate(uint64_t x, int bits) {
+  return (x << bits) | (x >> (64 - bits));
+}
+
+// The splitmix64 finalizer
+inline uint64_t avalanche(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+} // namespace
+
+std::string Fingerprint::toString() const {
+  static const char digits[] = "0123456789abcdef";
+  std::string result(32, '0');
+  for (int i = 0; i < 16; i++) {
+    result[15 - i] = digits[(high >> (4 * i)) & 0xf];
+    result[31 - i] = digits[(low >> (4 * i)) & 0xf];
+  }
+  return result;
+}
+
+FingerprintBuilder::FingerprintBuilder()
+    : first(0x243f6a8885a308d3ull), second(0x13198a2e03707344ull), count(0) {}
+
+void FingerprintBuilder::add(uint64_t word) {
+  count++;
+  first = rotate(first ^ (word * 0x87c37b91114253d5ull), 31) *
+          0x4cf5ad432745937full;
+  second = rotate(second + word * 0x9e3779b97f4a7c15ull, 27) * 5 +
+           0x52dce729 + first;
+}
+
+void FingerprintBuilder::add(const std::string &bytes) {
+  add(bytes.size());
+  std::size_t i = 0;
+  for (; i + 8 <= bytes.size(); i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes.data() + i, 8);
+    add(word);
+  }
+  if (i < bytes.size()) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+    add(word);
+  }
+}
+
+Fingerprint FingerprintBuilder::finish() const {
+  uint64_t a = avalanche(first ^ count);
+  uint64_t b = avalanche(second + a);
+  Fingerprint result = {avalanche(a + b), b};
+  return result;
+}
+
+} // namespace CXXAUTOMATA
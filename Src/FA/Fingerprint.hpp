@@ -0,0 +1,64 @@
+#ifndef CXXAUTOMATA_FINGERPRINT
+#define CXXAUTOMATA_FINGERPRINT
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief 128-bit hash of the canonical form of a DFA (see DFA::canonical).
+ *        Equivalent DFAs over the same alphabet have equal fingerprints;
+ *        different ones collide with negligible probability, although the
+ *        hash is not cryptographic.
+ *
+ */
+struct Fingerprint {
+  uint64_t high;
+  uint64_t low;
+
+  bool operator==(const Fingerprint &other) const {
+    return high == other.high && low == other.low;
+  }
+  bool operator!=(const Fingerprint &other) const { return !(*this == other); }
+  bool operator<(const Fingerprint &other) const {
+    return high != other.high ? high < other.high : low < other.low;
+  }
+
+  /**
+   * @brief Return the fingerprint as 32 hexadecimal digits.
+   *
+   * @return std::string
+   */
+  std::string toString() const;
+};
+
+struct FingerprintHash {
+  std::size_t operator()(const Fingerprint &fingerprint) const {
+    return static_cast<std::size_t>(fingerprint.low ^ fingerprint.high);
+  }
+};
+
+/**
+ * @brief Incremental computation of a Fingerprint over a sequence of words
+ *        and strings, in two independently mixed 64-bit lanes.
+ *
+ */
+class FingerprintBuilder {
+public:
+  FingerprintBuilder();
+
+  void add(uint64_t word);
+  void add(const std::string &bytes);
+  Fingerprint finish() const;
+
+private:
+  uint64_t first;
+  uint64_t second;
+  uint64_t count;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_FINGERPRINT */
@@ -0,0 +1,141 @@
+#include "HybridDFA.hpp"
+#include "DFA.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace CXXAUTOMATA {
+
+const uint32_t HybridDFA::DEFAULT_MAX_EXCEPTIONS;
+
+HybridDFA::HybridDFA(const DFA &dfa, uint32_t maxExceptions)
+    : alphabet(dfa.getInputSymbols()), initialState(NO_STATE) {
+  stateNames.assign(dfa.getStates().begin(), dfa.getStates().end());
+  const InputSymbols_v &symbolNames = alphabet.getSymbols();
+  uint32_t stateCount = static_cast<uint32_t>(stateNames.size());
+  uint32_t symbolCount = alphabet.size();
+  auto stateId = [&](const State &state) {
+    return findSorted(stateNames, state);
+  };
+
+  Row empty = {0, 0, NO_STATE, RowKind::SPARSE};
+  rowOf.assign(stateCount, empty);
+  // The transitions of one state, by symbol id
+  std::vector<std::pair<SymbolId, StateId>> paths;
+  std::vector<StateId> targets;
+  for (auto &transition : dfa.getTransitions()) {
+    StateId state = stateId(transition.first);
+    if (state == NO_STATE) {
+      continue;
+    }
+    paths.clear();
+    auto symbol = symbolNames.begin();
+    for (auto &path : transition.second) {
+      symbol = std::lower_bound(symbol, symbolNames.end(), path.first);
+      StateId target = stateId(path.second);
+      if (symbol != symbolNames.end() && *symbol == path.first &&
+          target != NO_STATE) {
+        SymbolId id = static_cast<SymbolId>(symbol - symbolNames.begin());
+        paths.emplace_back(id, target);
+      }
+    }
+
+    // The most frequent target, as a default for the other symbols
+    targets.clear();
+    for (auto &path : paths) {
+      targets.push_back(path.second);
+    }
+    std::sort(targets.begin(), targets.end());
+    StateId common = NO_STATE;
+    std::size_t commonCount = 0;
+    for (std::size_t i = 0, j = 0; i < targets.size(); i = j) {
+      while (j < targets.size() && targets[j] == targets[i]) {
+        j++;
+      }
+      if (j - i > commonCount) {
+        common = targets[i];
+        commonCount = j - i;
+      }
+    }
+    // A default target turns every other symbol, missing ones included,
+    // into an exception.
+    std::size_t withDefault = symbolCount - commonCount;
+    bool useDefault = withDefault < paths.size();
+    std::size_t exceptions = useDefault ? withDefault : paths.size();
+
+    Row &row = rowOf[state];
+    // An exception takes a symbol and a target, a dense entry a target.
+    if (exceptions > maxExceptions || 2 * exceptions >= symbolCount) {
+      row.kind = RowKind::DENSE;
+      row.start = static_cast<uint32_t>(denseTargets.size());
+      row.count = symbolCount;
+      denseTargets.resize(denseTargets.size() + symbolCount, NO_STATE);
+      for (auto &path : paths) {
+        denseTargets[row.start + path.first] = path.second;
+      }
+      continue;
+    }
+    row.kind = useDefault ? RowKind::DEFAULT : RowKind::SPARSE;
+    row.start = static_cast<uint32_t>(exceptionSymbols.size());
+    row.count = static_cast<uint32_t>(exceptions);
+    row.fallback = useDefault ? common : NO_STATE;
+    if (!useDefault) {
+      for (auto &path : paths) {
+        exceptionSymbols.push_back(path.first);
+        exceptionTargets.push_back(path.second);
+      }
+      continue;
+    }
+    auto path = paths.begin();
+    for (SymbolId id = 0; id < symbolCount; id++) {
+      StateId target = NO_STATE;
+      if (path != paths.end() && path->first == id) {
+        target = (path++)->second;
+      }
+      if (target != common) {
+        exceptionSymbols.push_back(id);
+        exceptionTargets.push_back(target);
+      }
+    }
+  }
+
+  finals.assign(stateCount, 0);
+  for (auto &state : dfa.getFinalStates()) {
+    StateId id = stateId(state);
+    if (id != NO_STATE) {
+      finals[id] = 1;
+    }
+  }
+  initialState = stateId(dfa.getInitialState());
+}
+
+StateId HybridDFA::readInput(const InputSymbols_v &input) const {
+  return walkInput(
+      alphabet, initialState, input,
+      [this](StateId state, SymbolId symbol) {
+        return nextState(state, symbol);
+      },
+      [](StateId, std::size_t, const InputSymbol &) {});
+}
+
+bool HybridDFA::acceptsInput(const InputSymbols_v &input) const {
+  StateId state = readInput(input);
+  return state != NO_STATE && isFinal(state);
+}
+
+uint32_t HybridDFA::getRowCount(RowKind kind) const {
+  return static_cast<uint32_t>(
+      std::count_if(rowOf.begin(), rowOf.end(),
+                    [kind](const Row &row) { return row.kind == kind; }));
+}
+
+std::size_t HybridDFA::tableBytes() const {
+  return rowOf.size() * sizeof(Row) + denseTargets.size() * sizeof(StateId) +
+         exceptionSymbols.size() * sizeof(SymbolId) +
+         exceptionTargets.size() * sizeof(StateId) + alphabet.lookupBytes();
+}
+
+std::size_t HybridDFA::denseTableBytes() const {
+  return alphabet.denseTableBytes(stateNames.size());
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,155 @@
+#ifndef CXXAUTOMATA_HYBRID_DFA
+#define CXXAUTOMATA_HYBRID_DFA
+
+#include "AlphabetIndex.hpp"
+#include "IndexedDFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+class DFA;
+
+/**
+ * @brief Read-only form of a DFA for matching that stores every state's
+ *        transitions in the encoding that suits the state.
+ *
+ *        A state with transitions on most symbols keeps a dense row indexed
+ *        by symbol. Any other state keeps a sorted list of exceptions, the
+ *        symbols whose target differs from its default target: the most
+ *        frequent target when that saves entries, or no target otherwise,
+ *        which makes the list a plain sparse row. The encoding is chosen per
+ *        state when the DFA is built, from the number of entries each one
+ *        needs, so memory stays close to the number of transitions while a
+ *        lookup in a short list is a branch-free scan. Symbols and states
+ *        are numbered in sorted order of their names. A hybrid DFA is
+ *        immutable and may be shared between threads.
+ */
+class HybridDFA {
+public:
+  /** how the transitions of a state are stored */
+  enum class RowKind : uint32_t { DENSE, SPARSE, DEFAULT };
+
+  /**
+   * @brief Construct a hybrid DFA.
+   *
+   * @param dfa
+   * @param maxExceptions states that need more exceptions than this, or
+   *        whose exceptions would take as much memory as a dense row, are
+   *        stored densely
+   */
+  explicit HybridDFA(const DFA &dfa,
+                     uint32_t maxExceptions = DEFAULT_MAX_EXCEPTIONS);
+
+  /**
+   * @brief Return the id of the given symbol, or NO_SYMBOL.
+   *
+   * @param symbol
+   * @return SymbolId
+   */
+  SymbolId symbolId(const InputSymbol &symbol) const {
+    return alphabet.find(symbol);
+  }
+
+  /**
+   * @brief Return the state reached from state on the symbol of the given
+   *        id, or NO_STATE.
+   *
+   * @param state
+   * @param symbol
+   * @return StateId
+   */
+  StateId nextState(StateId state, SymbolId symbol) const {
+    const Row &row = rowOf[state];
+    if (row.kind == RowKind::DENSE) {
+      return denseTargets[row.start + symbol];
+    }
+    // Count the smaller keys rather than branch on each one.
+    const SymbolId *keys = exceptionSymbols.data() + row.start;
+    uint32_t position = 0;
+    for (uint32_t i = 0; i < row.count; i++) {
+      position += keys[i] < symbol;
+    }
+    return position < row.count && keys[position] == symbol
+               ? exceptionTargets[row.start + position]
+               : row.fallback;
+  }
+
+  /**
+   * @brief Return the state reached after reading input, or NO_STATE.
+   *
+   * @param input
+   * @return StateId
+   */
+  StateId readInput(const InputSymbols_v &input) const;
+
+  /**
+   * @brief Return True if input is accepted.
+   *
+   * @param input
+   * @return true
+   * @return false
+   */
+  bool acceptsInput(const InputSymbols_v &input) const;
+
+  bool isFinal(StateId state) const { return finals[state] != 0; }
+  StateId getInitialState() const { return initialState; }
+  const State &getStateName(StateId state) const { return stateNames[state]; }
+  uint32_t getStateCount() const {
+    return static_cast<uint32_t>(stateNames.size());
+  }
+  RowKind getRowKind(StateId state) const { return rowOf[state].kind; }
+
+  /**
+   * @brief Return the number of states stored with the given encoding.
+   *
+   * @param kind
+   * @return uint32_t
+   */
+  uint32_t getRowCount(RowKind kind) const;
+
+  /**
+   * @brief Return the bytes used by the rows and the symbol lookup.
+   *
+   * @return std::size_t
+   */
+  std::size_t tableBytes() const;
+
+  /**
+   * @brief Return the bytes an uncompressed |Q| x |Σ| table would use.
+   *
+   * @return std::size_t
+   */
+  std::size_t denseTableBytes() const;
+
+  static const uint32_t DEFAULT_MAX_EXCEPTIONS = 16;
+
+private:
+  /**
+   * @brief Where the transitions of a state are: denseTargets[start ..] for
+   *        a dense row, else count exceptions at start, with fallback for
+   *        the other symbols.
+   */
+  struct Row {
+    uint32_t start;
+    uint32_t count;
+    StateId fallback;
+    RowKind kind;
+  };
+
+  States_v stateNames;
+  /** from every symbol to its id */
+  AlphabetIndex alphabet;
+  std::vector<Row> rowOf;
+  std::vector<StateId> denseTargets;
+  std::vector<SymbolId> exceptionSymbols;
+  std::vector<StateId> exceptionTargets;
+  std::vector<uint8_t> finals;
+  StateId initialState;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_HYBRID_DFA */
@@ -0,0 +1,731 @@
+#include "IndexedDFA.hpp"
+#include "DFA.hpp"
+#include "ParallelExplorer.hpp"
+#include "Provenance.hpp"
+#include "Statistics.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace CXXAUTOMATA {
+namespace {
+int compareNames(const NameRef &a, const NameRef &b) {
+  int result = std::memcmp(a.data, b.data, std::min(a.size, b.size));
+  if (result != 0) {
+    return result;
+  }
+  return a.size < b.size ? -1 : (a.size > b.size ? 1 : 0);
+}
+
+bool nameLess(const NameRef &a, const NameRef &b) {
+  return compareNames(a, b) < 0;
+}
+
+NameRef toNameRef(const std::string &name) {
+  NameRef ref = {name.data(), name.size()};
+  return ref;
+}
+
+uint32_t findName(const ArenaVector<NameRef> &names, const std::string &name) {
+  auto it = std::lower_bound(names.begin(), names.end(), toNameRef(name),
+                             nameLess);
+  if (it == names.end() || compareNames(*it, toNameRef(name)) != 0) {
+    throw std::out_of_range("unknown state " + name);
+  }
+  return static_cast<uint32_t>(it - names.begin());
+}
+} // namespace
+
+IndexedDFA::IndexedDFA(Arena &arena)
+    : arena(&arena), inputSymbols(nullptr), symbols(arena), names(arena),
+      table(arena), finals(arena), stateCount(0), initialState(NO_STATE),
+      allowPartial(false), provenanceIds(arena) {}
+
+std::shared_ptr<const Provenance> IndexedDFA::provenanceOrSource() const {
+  if (provenance != nullptr) {
+    return provenance;
+  }
+  States_v sourceNames;
+  sourceNames.reserve(names.size());
+  for (auto &name : names) {
+    sourceNames.emplace_back(name.data, name.size);
+  }
+  return Provenance::source(std::move(sourceNames));
+}
+
+IndexedDFA IndexedDFA::fromDFA(const DFA &dfa, Arena &arena) {
+  IndexedDFA result(arena);
+  result.inputSymbols = &dfa.getInputSymbols();
+  result.allowPartial = dfa.getAllowPartial();
+  result.symbols.reserve(dfa.getInputSymbols().size());
+  for (auto &symbol : dfa.getInputSymbols()) {
+    result.symbols.push_back(&symbol);
+  }
+  result.stateCount = static_cast<uint32_t>(dfa.getStates().size());
+  result.names.reserve(result.stateCount);
+  for (auto &state : dfa.getStates()) {
+    result.names.push_back(toNameRef(state));
+  }
+  std::size_t symbolCount = result.symbols.size();
+  result.table.assign(result.stateCount * symbolCount, NO_STATE);
+  result.finals.assign(result.stateCount, 0);
+
+  auto &transitions = dfa.getTransitions();
+  uint32_t id = 0;
+  for (auto &state : dfa.getStates()) {
+    auto paths = transitions.find(state);
+    if (paths != transitions.end()) {
+      // Paths and symbols are both sorted, so they are merged in one pass.
+      SymbolId symbol = 0;
+      for (auto &path : paths->second) {
+        while (symbol < symbolCount && *result.symbols[symbol] < path.first) {
+          symbol++;
+        }
+        if (symbol == symbolCount || *result.symbols[symbol] != path.first) {
+          throw std::out_of_range("unknown symbol " + path.first);
+        }
+        result.table[id * symbolCount + symbol] =
+            findName(result.names, path.second);
+      }
+    }
+    id++;
+  }
+  for (auto &state : dfa.getFinalStates()) {
+    result.finals[findName(result.names, state)] = 1;
+  }
+  result.initialState = findName(result.names, dfa.getInitialState());
+  result.provenance = dfa.getProvenance();
+  return result;
+}
+
+IndexedDFA IndexedDFA::product(const IndexedDFA &a, const IndexedDFA &b,
+                               const InputSymbols &alphabet,
+                               bool (*accept)(bool, bool), ThreadPool *pool) {
+  CXXAUTOMATA_STATS_SCOPE(CROSS_PRODUCT);
+  Arena &arena = *a.arena;
+  IndexedDFA result(arena);
+  result.inputSymbols = &alphabet;
+  std::size_t symbolCount = alphabet.size();
+  result.symbols.reserve(symbolCount);
+  // Column of every symbol of the alphabet in a and in b, or NO_SYMBOL.
+  ArenaVector<SymbolId> columnA(arena);
+  ArenaVector<SymbolId> columnB(arena);
+  auto column = [](const IndexedDFA &dfa, const InputSymbol &symbol,
+                   SymbolId &cursor) {
+    auto &symbols = dfa.symbols;
+    while (cursor < symbols.size() && *symbols[cursor] < symbol) {
+      cursor++;
+    }
+    return cursor < symbols.size() && *symbols[cursor] == symbol ? cursor
+                                                                 : NO_SYMBOL;
+  };
+  SymbolId cursorA = 0;
+  SymbolId cursorB = 0;
+  for (auto &symbol : alphabet) {
+    result.symbols.push_back(&symbol);
+    columnA.push_back(column(a, symbol, cursorA));
+    columnB.push_back(column(b, symbol, cursorB));
+  }
+  auto next = [](const IndexedDFA &dfa, StateId state, SymbolId symbol) {
+    return state == NO_STATE || symbol == NO_SYMBOL ? NO_STATE
+                                                    : dfa.next(state, symbol);
+  };
+  auto pairOf = [](StateId stateA, StateId stateB) {
+    return (static_cast<uint64_t>(stateA) << 32) | stateB;
+  };
+  auto append = [&](char *data, const IndexedDFA &dfa, StateId state) {
+    if (state == NO_STATE) {
+      return data;
+    }
+    const NameRef &name = dfa.names[state];
+    std::memcpy(data, name.data, name.size);
+    return data + name.size;
+  };
+
+  // Reachable pairs in breadth-first order; a pair of two dead states is a
+  // missing transition.
+  ArenaVector<uint64_t> pairs(arena);
+  if (pool != nullptr) {
+    ParallelExplorer<uint64_t> explorer(*pool, symbolCount);
+    explorer.explore(pairOf(a.initialState, b.initialState),
+                     [&](uint64_t pair, std::size_t symbol, uint64_t &target) {
+                       StateId stateA = next(a, pair >> 32, columnA[symbol]);
+                       StateId stateB = next(b, pair & 0xFFFFFFFFu,
+                                             columnB[symbol]);
+                       target = pairOf(stateA, stateB);
+                       return stateA != NO_STATE || stateB != NO_STATE;
+                     });
+    pairs.assign(explorer.getStates().begin(), explorer.getStates().end());
+    result.table.resize(pairs.size() * symbolCount);
+    pool->parallelFor(pairs.size(), 1024, [&](std::size_t begin,
+                                              std::size_t end) {
+      for (std::size_t state = begin; state < end; state++) {
+        for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+          result.table[state * symbolCount + symbol] =
+              explorer.next(static_cast<StateId>(state), symbol);
+        }
+      }
+    });
+  } else {
+    typedef std::pair<const uint64_t, StateId> Entry;
+    std::unordered_map<uint64_t, StateId, std::hash<uint64_t>,
+                       std::equal_to<uint64_t>, ArenaAllocator<Entry>>
+        ids(16, std::hash<uint64_t>(), std::equal_to<uint64_t>(),
+            ArenaAllocator<Entry>(arena));
+    auto intern = [&](StateId stateA, StateId stateB) -> StateId {
+      if (stateA == NO_STATE && stateB == NO_STATE) {
+        return NO_STATE;
+      }
+      uint64_t key = pairOf(stateA, stateB);
+      auto inserted = ids.emplace(key, static_cast<StateId>(pairs.size()));
+      if (inserted.second) {
+        pairs.push_back(key);
+      }
+      return inserted.first->second;
+    };
+    intern(a.initialState, b.initialState);
+    for (std::size_t current = 0; current < pairs.size(); current++) {
+      StateId stateA = static_cast<StateId>(pairs[current] >> 32);
+      StateId stateB = static_cast<StateId>(pairs[current]);
+      for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+        result.table.push_back(intern(next(a, stateA, columnA[symbol]),
+                                      next(b, stateB, columnB[symbol])));
+      }
+    }
+  }
+  CXXAUTOMATA_STATS_ADD(STATES_EXPLORED, pairs.size());
+  CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, 2 * symbolCount * pairs.size());
+
+  // A tracked product numbers its states; describeState names them.
+  bool tracked = a.provenance != nullptr || b.provenance != nullptr;
+  result.names.reserve(pairs.size());
+  result.finals.reserve(pairs.size());
+  for (auto pair : pairs) {
+    StateId stateA = static_cast<StateId>(pair >> 32);
+    StateId stateB = static_cast<StateId>(pair);
+    if (tracked) {
+      std::string number = std::to_string(result.names.size());
+      char *data = static_cast<char *>(arena.allocate(number.size(), 1));
+      std::copy(number.begin(), number.end(), data);
+      NameRef name = {data, number.size()};
+      result.names.push_back(name);
+    } else {
+      std::size_t size = 1;
+      size += stateA == NO_STATE ? 0 : a.names[stateA].size;
+      size += stateB == NO_STATE ? 0 : b.names[stateB].size;
+      char *data = static_cast<char *>(arena.allocate(size, 1));
+      char *end = append(data, a, stateA);
+      *end++ = ',';
+      append(end, b, stateB);
+      NameRef name = {data, size};
+      result.names.push_back(name);
+    }
+    result.finals.push_back(accept(stateA != NO_STATE && a.isFinal(stateA),
+                                   stateB != NO_STATE && b.isFinal(stateB)));
+  }
+  result.initialState = 0;
+  result.stateCount = static_cast<uint32_t>(pairs.size());
+  if (tracked) {
+    std::vector<StateId> ids;
+    ids.reserve(2 * pairs.size());
+    for (auto pair : pairs) {
+      StateId stateA = static_cast<StateId>(pair >> 32);
+      StateId stateB = static_cast<StateId>(pair);
+      ids.push_back(stateA == NO_STATE ? NO_STATE : a.provenanceId(stateA));
+      ids.push_back(stateB == NO_STATE ? NO_STATE : b.provenanceId(stateB));
+    }
+    result.provenance = Provenance::product(
+        a.provenanceOrSource(), b.provenanceOrSource(), std::move(ids));
+  }
+  return result;
+}
+
+IndexedDFA IndexedDFA::reachablePart() const {
+  std::size_t symbolCount = symbols.size();
+  ArenaVector<StateId> newId(stateCount, NO_STATE,
+                             ArenaAllocator<StateId>(*arena));
+  ArenaVector<StateId> queue(*arena);
+  queue.reserve(stateCount);
+  queue.push_back(initialState);
+  newId[initialState] = 0;
+  for (std::size_t current = 0; current < queue.size(); current++) {
+    StateId state = queue[current];
+    CXXAUTOMATA_STATS_ADD(STATES_EXPLORED, 1);
+    CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, symbolCount);
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      StateId target = next(state, symbol);
+      if (target != NO_STATE && newId[target] == NO_STATE) {
+        newId[target] = 0;
+        queue.push_back(target);
+      }
+    }
+  }
+
+  IndexedDFA result(*arena);
+  result.inputSymbols = inputSymbols;
+  result.symbols = symbols;
+  result.allowPartial = allowPartial;
+  result.provenance = provenance;
+  if (queue.size() == stateCount) {
+    result.names = names;
+    result.table = table;
+    result.finals = finals;
+    result.stateCount = stateCount;
+    result.initialState = initialState;
+    result.provenanceIds = provenanceIds;
+    return result;
+  }
+  StateId count = 0;
+  for (StateId state = 0; state < stateCount; state++) {
+    if (newId[state] != NO_STATE) {
+      newId[state] = count++;
+    }
+  }
+  result.stateCount = count;
+  result.names.reserve(count);
+  result.finals.reserve(count);
+  result.table.reserve(count * symbolCount);
+  for (StateId state = 0; state < stateCount; state++) {
+    if (newId[state] == NO_STATE) {
+      continue;
+    }
+    result.names.push_back(names[state]);
+    result.finals.push_back(finals[state]);
+    if (provenance != nullptr) {
+      result.provenanceIds.push_back(provenanceId(state));
+    }
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      StateId target = next(state, symbol);
+      result.table.push_back(target == NO_STATE ? NO_STATE : newId[target]);
+    }
+  }
+  result.initialState = newId[initialState];
+  return result;
+}
+
+bool IndexedDFA::hasMissingTransitions() const {
+  return std::find(table.begin(), table.end(), NO_STATE) != table.end();
+}
+
+ArenaVector<uint32_t> IndexedDFA::minimalPartition(uint32_t &classCount) const {
+  ArenaAllocator<uint32_t> alloc(*arena);
+  std::size_t symbolCount = symbols.size();
+  // Missing transitions go to an extra, non-final dead state.
+  uint32_t n = stateCount + (hasMissingTransitions() ? 1 : 0);
+  auto target = [&](uint32_t state, SymbolId symbol) -> uint32_t {
+    if (state == stateCount) {
+      return stateCount;
+    }
+    StateId to = next(state, symbol);
+    return to == NO_STATE ? stateCount : to;
+  };
+
+  // Predecessors grouped by (symbol, target), in compressed row form.
+  ArenaVector<uint32_t> predecessorStart(symbolCount * n + 1, 0, alloc);
+  ArenaVector<uint32_t> predecessors(symbolCount * n, 0, alloc);
+  for (uint32_t state = 0; state < n; state++) {
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      predecessorStart[symbol * n + target(state, symbol) + 1]++;
+    }
+  }
+  for (std::size_t i = 1; i < predecessorStart.size(); i++) {
+    predecessorStart[i] += predecessorStart[i - 1];
+  }
+  {
+    ArenaVector<uint32_t> fill(predecessorStart.begin(),
+                               predecessorStart.end() - 1, alloc);
+    for (uint32_t state = 0; state < n; state++) {
+      for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+        predecessors[fill[symbol * n + target(state, symbol)]++] = state;
+      }
+    }
+  }
+
+  // Blocks are contiguous ranges of elements; the marked states of a block
+  // are moved to the front of its range, up to blockMarked.
+  ArenaVector<uint32_t> elements(n, 0, alloc);
+  ArenaVector<uint32_t> location(n, 0, alloc);
+  ArenaVector<uint32_t> blockOf(n, 0, alloc);
+  ArenaVector<uint32_t> blockFirst(alloc);
+  ArenaVector<uint32_t> blockEnd(alloc);
+  ArenaVector<uint32_t> blockMarked(alloc);
+  uint32_t finalCount = 0;
+  for (uint32_t state = 0; state < stateCount; state++) {
+    finalCount += finals[state] ? 1 : 0;
+  }
+  uint32_t finalPosition = 0;
+  uint32_t otherPosition = finalCount;
+  for (uint32_t state = 0; state < n; state++) {
+    bool final = state < stateCount && finals[state];
+    uint32_t position = final ? finalPosition++ : otherPosition++;
+    elements[position] = state;
+    location[state] = position;
+  }
+  ArenaVector<uint32_t> worklist(alloc);
+  auto addBlock = [&](uint32_t first, uint32_t end) {
+    uint32_t block = static_cast<uint32_t>(blockFirst.size());
+    blockFirst.push_back(first);
+    blockEnd.push_back(end);
+    blockMarked.push_back(first);
+    for (uint32_t i = first; i < end; i++) {
+      blockOf[elements[i]] = block;
+    }
+    return block;
+  };
+  if (finalCount > 0) {
+    addBlock(0, finalCount);
+  }
+  if (finalCount < n) {
+    addBlock(finalCount, n);
+  }
+  if (blockFirst.size() == 2) {
+    worklist.push_back(finalCount <= n - finalCount ? 0 : 1);
+  }
+
+  ArenaVector<uint32_t> splitter(alloc);
+  ArenaVector<uint32_t> touched(alloc);
+  while (!worklist.empty()) {
+    uint32_t block = worklist.back();
+    worklist.pop_back();
+    splitter.assign(elements.begin() + blockFirst[block],
+                    elements.begin() + blockEnd[block]);
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      for (auto state : splitter) {
+        std::size_t row = symbol * n + state;
+        CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, predecessorStart[row + 1] -
+                                                       predecessorStart[row]);
+        for (uint32_t i = predecessorStart[row]; i < predecessorStart[row + 1];
+             i++) {
+          uint32_t predecessor = predecessors[i];
+          uint32_t predecessorBlock = blockOf[predecessor];
+          uint32_t position = location[predecessor];
+          uint32_t marked = blockMarked[predecessorBlock];
+          if (position < marked) {
+            continue;
+          }
+          if (marked == blockFirst[predecessorBlock]) {
+            touched.push_back(predecessorBlock);
+          }
+          uint32_t other = elements[marked];
+          elements[marked] = predecessor;
+          location[predecessor] = marked;
+          elements[position] = other;
+          location[other] = position;
+          blockMarked[predecessorBlock]++;
+        }
+      }
+      for (auto touchedBlock : touched) {
+        uint32_t first = blockFirst[touchedBlock];
+        uint32_t marked = blockMarked[touchedBlock];
+        uint32_t end = blockEnd[touchedBlock];
+        blockMarked[touchedBlock] = first;
+        if (marked == end) {
+          continue;
+        }
+        // The smaller half becomes the new block and is always a splitter.
+        uint32_t newBlock;
+        if (marked - first <= end - marked) {
+          blockFirst[touchedBlock] = marked;
+          blockMarked[touchedBlock] = marked;
+          newBlock = addBlock(first, marked);
+        } else {
+          blockEnd[touchedBlock] = marked;
+          newBlock = addBlock(marked, end);
+        }
+        worklist.push_back(newBlock);
+        CXXAUTOMATA_STATS_ADD(PARTITIONS_SPLIT, 1);
+      }
+      touched.clear();
+    }
+  }
+  classCount = static_cast<uint32_t>(blockFirst.size());
+  return blockOf;
+}
+
+ArenaVector<uint32_t> IndexedDFA::minimalPartition(ThreadPool &pool,
+                                                   uint32_t &classCount) const {
+  ArenaAllocator<uint32_t> alloc(*arena);
+  std::size_t symbolCount = symbols.size();
+  // Missing transitions go to an extra, non-final dead state.
+  uint32_t n = stateCount + (hasMissingTransitions() ? 1 : 0);
+  auto target = [&](uint32_t state, SymbolId symbol) -> uint32_t {
+    if (state == stateCount) {
+      return stateCount;
+    }
+    StateId to = next(state, symbol);
+    return to == NO_STATE ? stateCount : to;
+  };
+
+  // Everything the workers touch is allocated here: the arena is not
+  // synchronized. States are cut into chunks of consecutive states, and
+  // signatures into shards by hash.
+  std::size_t chunkCount = std::min<std::size_t>(n, 4 * pool.getThreadCount());
+  std::size_t chunkSize = (n + chunkCount - 1) / chunkCount;
+  std::size_t shardCount = chunkCount;
+  ArenaVector<uint32_t> blockOf(n, 0, alloc);
+  ArenaVector<uint32_t> nextBlockOf(n, 0, alloc);
+  ArenaVector<uint32_t> first(n, 0, alloc);
+  ArenaVector<uint32_t> order(n, 0, alloc);
+  ArenaVector<uint64_t> hashes(n, 0, ArenaAllocator<uint64_t>(*arena));
+  ArenaVector<uint32_t> slots(chunkCount * shardCount, 0, alloc);
+  ArenaVector<uint32_t> shardStart(shardCount + 1, 0, alloc);
+  ArenaVector<uint32_t> chunkBlocks(chunkCount + 1, 0, alloc);
+  std::vector<std::unordered_multimap<uint64_t, uint32_t>> seen(shardCount);
+
+  bool anyFinal = false;
+  bool anyOther = false;
+  for (uint32_t state = 0; state < n; state++) {
+    bool final = state < stateCount && finals[state];
+    blockOf[state] = final ? 1 : 0;
+    anyFinal = anyFinal || final;
+    anyOther = anyOther || !final;
+  }
+  uint32_t blockCount = (anyFinal ? 1 : 0) + (anyOther ? 1 : 0);
+
+  auto forEachChunk = [&](const std::function<void(std::size_t, uint32_t,
+                                                   uint32_t)> &body) {
+    pool.parallelFor(chunkCount, 1, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t chunk = begin; chunk < end; chunk++) {
+        uint32_t from = static_cast<uint32_t>(chunk * chunkSize);
+        uint32_t to = static_cast<uint32_t>(
+            std::min<std::size_t>(n, (chunk + 1) * chunkSize));
+        body(chunk, from, to);
+      }
+    });
+  };
+  auto shardOf = [&](uint64_t hash) { return (hash >> 32) % shardCount; };
+  auto sameSignature = [&](uint32_t x, uint32_t y) {
+    if (blockOf[x] != blockOf[y]) {
+      return false;
+    }
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      if (blockOf[target(x, symbol)] != blockOf[target(y, symbol)]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  while (true) {
+    CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, n * symbolCount);
+    // Hash the signatures and count them per chunk and shard.
+    forEachChunk([&](std::size_t chunk, uint32_t from, uint32_t to) {
+      uint32_t *counts = &slots[chunk * shardCount];
+      std::fill(counts, counts + shardCount, 0);
+      for (uint32_t state = from; state < to; state++) {
+        uint64_t hash = 0xcbf29ce484222325ull ^ blockOf[state];
+        for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+          hash = (hash ^ blockOf[target(state, symbol)]) * 0x100000001b3ull;
+        }
+        hash ^= hash >> 29;
+        hash *= 0xbf58476d1ce4e5b9ull;
+        hash ^= hash >> 32;
+        hashes[state] = hash;
+        counts[shardOf(hash)]++;
+      }
+    });
+    // Lay the shards out one after the other, each in state order.
+    uint32_t position = 0;
+    for (std::size_t shard = 0; shard < shardCount; shard++) {
+      shardStart[shard] = position;
+      for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+        uint32_t count = slots[chunk * shardCount + shard];
+        slots[chunk * shardCount + shard] = position;
+        position += count;
+      }
+    }
+    shardStart[shardCount] = position;
+    forEachChunk([&](std::size_t chunk, uint32_t from, uint32_t to) {
+      uint32_t *cursors = &slots[chunk * shardCount];
+      for (uint32_t state = from; state < to; state++) {
+        order[cursors[shardOf(hashes[state])]++] = state;
+      }
+    });
+    // Find the first state with the same signature as every state.
+    pool.parallelFor(shardCount, 1, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t shard = begin; shard < end; shard++) {
+        auto &firsts = seen[shard];
+        firsts.clear();
+        for (uint32_t i = shardStart[shard]; i < shardStart[shard + 1]; i++) {
+          uint32_t state = order[i];
+          uint32_t found = state;
+          auto candidates = firsts.equal_range(hashes[state]);
+          for (auto candidate = candidates.first;
+               candidate != candidates.second; candidate++) {
+            if (sameSignature(candidate->second, state)) {
+              found = candidate->second;
+              break;
+            }
+          }
+          if (found == state) {
+            firsts.emplace(hashes[state], state);
+          }
+          first[state] = found;
+        }
+      }
+    });
+    // Number the new blocks in the order of their first state.
+    forEachChunk([&](std::size_t chunk, uint32_t from, uint32_t to) {
+      uint32_t count = 0;
+      for (uint32_t state = from; state < to; state++) {
+        count += first[state] == state ? 1 : 0;
+      }
+      chunkBlocks[chunk + 1] = count;
+    });
+    for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+      chunkBlocks[chunk + 1] += chunkBlocks[chunk];
+    }
+    forEachChunk([&](std::size_t chunk, uint32_t from, uint32_t to) {
+      uint32_t block = chunkBlocks[chunk];
+      for (uint32_t state = from; state < to; state++) {
+        if (first[state] == state) {
+          nextBlockOf[state] = block++;
+        }
+      }
+    });
+    forEachChunk([&](std::size_t, uint32_t from, uint32_t to) {
+      for (uint32_t state = from; state < to; state++) {
+        if (first[state] != state) {
+          nextBlockOf[state] = nextBlockOf[first[state]];
+        }
+      }
+    });
+    blockOf.swap(nextBlockOf);
+    uint32_t newCount = chunkBlocks[chunkCount];
+    CXXAUTOMATA_STATS_ADD(PARTITIONS_SPLIT, newCount - blockCount);
+    if (newCount == blockCount) {
+      break;
+    }
+    blockCount = newCount;
+  }
+  classCount = blockCount;
+  return blockOf;
+}
+
+DFA IndexedDFA::toMinimalDFA(bool retainNames, ThreadPool *pool) const {
+  IndexedDFA reachable = reachablePart();
+  ArenaAllocator<uint32_t> alloc(*arena);
+  uint32_t classCount = 0;
+  auto classOf = pool != nullptr
+                     ? reachable.minimalPartition(*pool, classCount)
+                     : reachable.minimalPartition(classCount);
+  uint32_t n = reachable.stateCount;
+  uint32_t deadClass = classOf.size() > n ? classOf[n] : classCount;
+  uint32_t initialClass = classOf[reachable.initialState];
+
+  // Members of every class, sorted by name.
+  ArenaVector<uint32_t> memberStart(classCount + 1, 0, alloc);
+  ArenaVector<uint32_t> members(n, 0, alloc);
+  for (uint32_t state = 0; state < n; state++) {
+    memberStart[classOf[state] + 1]++;
+  }
+  for (uint32_t c = 1; c <= classCount; c++) {
+    memberStart[c] += memberStart[c - 1];
+  }
+  {
+    ArenaVector<uint32_t> fill(memberStart.begin(), memberStart.end() - 1,
+                               alloc);
+    for (uint32_t state = 0; state < n; state++) {
+      members[fill[classOf[state]]++] = state;
+    }
+  }
+  auto byName = [&](uint32_t x, uint32_t y) {
+    return nameLess(reachable.names[x], reachable.names[y]);
+  };
+  for (uint32_t c = 0; c < classCount; c++) {
+    std::sort(members.begin() + memberStart[c],
+              members.begin() + memberStart[c + 1], byName);
+  }
+
+  // The dead state's class is dropped unless the initial state is in it.
+  ArenaVector<uint32_t> kept(alloc);
+  for (uint32_t c = 0; c < classCount; c++) {
+    if (memberStart[c] != memberStart[c + 1] &&
+        (c != deadClass || c == initialClass)) {
+      kept.push_back(c);
+    }
+  }
+  // A tracked DFA leaves the long names to describeState.
+  bool numbered = !retainNames || reachable.provenance != nullptr;
+  if (numbered) {
+    // Numbered in the order of the classes' sorted member names.
+    std::sort(kept.begin(), kept.end(), [&](uint32_t x, uint32_t y) {
+      auto first = members.begin();
+      return std::lexicographical_compare(
+          first + memberStart[x], first + memberStart[x + 1],
+          first + memberStart[y], first + memberStart[y + 1], byName);
+    });
+  }
+
+  std::vector<State> classNames(classCount);
+  for (std::size_t i = 0; i < kept.size(); i++) {
+    uint32_t c = kept[i];
+    if (numbered) {
+      classNames[c] = std::to_string(i);
+      continue;
+    }
+    for (uint32_t m = memberStart[c]; m < memberStart[c + 1]; m++) {
+      if (m != memberStart[c]) {
+        classNames[c] += ',';
+      }
+      const NameRef &name = reachable.names[members[m]];
+      classNames[c].append(name.data, name.size);
+    }
+  }
+
+  // The result is valid by construction and is not validated again.
+  DFA result;
+  result.inputSymbols = *inputSymbols;
+  result.allowPartial = allowPartial;
+  std::size_t symbolCount = symbols.size();
+  for (auto c : kept) {
+    const State &name = classNames[c];
+    result.states.insert(name);
+    if (reachable.finals[members[memberStart[c]]]) {
+      result.finalStates.insert(name);
+    }
+    Paths &paths = result.transitions[name];
+    if (c == deadClass) {
+      result.allowPartial = true;
+      continue;
+    }
+    uint32_t representative = members[memberStart[c]];
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      StateId to = reachable.next(representative, symbol);
+      if (to == NO_STATE || classOf[to] == deadClass) {
+        result.allowPartial = true;
+        continue;
+      }
+      paths.emplace_hint(paths.end(), *symbols[symbol],
+                         classNames[classOf[to]]);
+    }
+    CXXAUTOMATA_STATS_ADD(ALLOCATIONS, 1 + paths.size());
+  }
+  result.initialState = classNames[initialClass];
+
+  if (reachable.provenance != nullptr) {
+    // Classes by the sorted order of their names in the result
+    std::vector<uint32_t> sorted(kept.begin(), kept.end());
+    std::sort(sorted.begin(), sorted.end(), [&](uint32_t x, uint32_t y) {
+      return classNames[x] < classNames[y];
+    });
+    std::vector<uint32_t> start(1, 0);
+    std::vector<StateId> ids;
+    start.reserve(sorted.size() + 1);
+    for (auto c : sorted) {
+      for (uint32_t m = memberStart[c]; m < memberStart[c + 1]; m++) {
+        ids.push_back(reachable.provenanceId(members[m]));
+      }
+      start.push_back(static_cast<uint32_t>(ids.size()));
+    }
+    result.provenance = Provenance::classes(reachable.provenance,
+                                            std::move(start), std::move(ids));
+  }
+  result.updateMemoryAccount();
+  return result;
+}
+
+} // namespace CXXAUTOMATA
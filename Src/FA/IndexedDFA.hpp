@@ -0,0 +1,184 @@
+#ifndef CXXAUTOMATA_INDEXED_DFA
+#define CXXAUTOMATA_INDEXED_DFA
+
+#include "Arena.hpp"
+#include "Typedefs.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace CXXAUTOMATA {
+
+class DFA;
+class Provenance;
+class ThreadPool;
+
+typedef uint32_t StateId;
+typedef uint32_t SymbolId;
+
+/** Marks a missing transition in an IndexedDFA table. */
+static const StateId NO_STATE = 0xFFFFFFFFu;
+
+/** Marks a symbol outside an alphabet, as HybridDFA::symbolId returns. */
+static const SymbolId NO_SYMBOL = 0xFFFFFFFFu;
+
+/**
+ * @brief A state name that is not owned by the IndexedDFA: it points either
+ *        into the source DFA or into the arena.
+ *
+ */
+struct NameRef {
+  const char *data;
+  std::size_t size;
+};
+
+/**
+ * @brief Integer-indexed working copy of a DFA used by the operations that
+ *        build temporary automata (minification, products).
+ *
+ *        States and symbols are numbered, transitions are kept in one flat
+ *        row-major table and every container draws from an operation-scoped
+ *        Arena, so the whole intermediate automaton is freed in one step.
+ *        Only the final result is turned back into a DFA.
+ *
+ *        When an operand records its provenance, the provenance of every
+ *        intermediate state is carried along and recorded in the result.
+ */
+class IndexedDFA {
+public:
+  /**
+   * @brief Construct an empty IndexedDFA whose storage lives in arena.
+   *
+   * @param arena
+   */
+  explicit IndexedDFA(Arena &arena);
+
+  /**
+   * @brief Index the given DFA. States and symbols are numbered in their
+   *        sorted order. dfa must outlive the result.
+   *
+   * @param dfa
+   * @param arena
+   * @return IndexedDFA
+   */
+  static IndexedDFA fromDFA(const DFA &dfa, Arena &arena);
+
+  /**
+   * @brief Build the part of the cross product of a and b that is reachable
+   *        from the pair of initial states, over alphabet (which must
+   *        contain both alphabets and outlive the result). A pair is final
+   *        if accept(a final, b final) is true. States are named "a,b".
+   *        A side with no transition on a symbol goes to its dead state,
+   *        named ""; pairs of two dead states become missing transitions.
+   *        States are numbered in breadth-first order, also when the pairs
+   *        are explored on pool. If a or b has a provenance, the pairs are
+   *        recorded in a product provenance.
+   *
+   * @param a
+   * @param b
+   * @param alphabet
+   * @param accept
+   * @param pool
+   * @return IndexedDFA
+   */
+  static IndexedDFA product(const IndexedDFA &a, const IndexedDFA &b,
+                            const InputSymbols &alphabet,
+                            bool (*accept)(bool, bool),
+                            ThreadPool *pool = nullptr);
+
+  /**
+   * @brief Return the sub-automaton of the states reachable from the initial
+   *        state. Relative state order is preserved.
+   *
+   * @return IndexedDFA
+   */
+  IndexedDFA reachablePart() const;
+
+  /**
+   * @brief Compute the coarsest partition of equivalent states with
+   *        Hopcroft's algorithm. Missing transitions lead to an implicit
+   *        dead state, which gets index getStateCount() in the result when
+   *        the table has any.
+   *
+   * @param classCount receives the number of classes
+   * @return ArenaVector<uint32_t> class of every state
+   */
+  ArenaVector<uint32_t> minimalPartition(uint32_t &classCount) const;
+
+  /**
+   * @brief Compute the same partition as minimalPartition(classCount) on
+   *        pool, classes numbered differently. Each round hashes every
+   *        state's (class, successor classes) signature in parallel and
+   *        regroups the states by signature in hash shards, numbering the
+   *        new classes by their first state, until no class splits.
+   *
+   * @param pool
+   * @param classCount receives the number of classes
+   * @return ArenaVector<uint32_t> class of every state
+   */
+  ArenaVector<uint32_t> minimalPartition(ThreadPool &pool,
+                                         uint32_t &classCount) const;
+
+  /**
+   * @brief Return the minimal DFA equivalent to this one, named like
+   *        DFA::minify names it. The partition is computed on pool if one
+   *        is given; the result does not depend on it.
+   *
+   * @param retainNames
+   * @param pool
+   * @return DFA
+   */
+  DFA toMinimalDFA(bool retainNames, ThreadPool *pool = nullptr) const;
+
+  uint32_t getStateCount() const { return stateCount; }
+  uint32_t getSymbolCount() const {
+    return static_cast<uint32_t>(symbols.size());
+  }
+  StateId getInitialState() const { return initialState; }
+  bool isFinal(StateId state) const { return finals[state] != 0; }
+  StateId next(StateId state, SymbolId symbol) const {
+    return table[static_cast<std::size_t>(state) * symbols.size() + symbol];
+  }
+
+private:
+  /**
+   * @brief Return the id of state in the provenance.
+   *
+   * @param state
+   * @return StateId
+   */
+  StateId provenanceId(StateId state) const {
+    return provenanceIds.empty() ? state : provenanceIds[state];
+  }
+
+  /**
+   * @brief Return the provenance, or a source provenance of the names.
+   *
+   * @return std::shared_ptr<const Provenance>
+   */
+  std::shared_ptr<const Provenance> provenanceOrSource() const;
+
+  /**
+   * @brief Return true if the table contains a missing transition.
+   *
+   * @return true
+   * @return false
+   */
+  bool hasMissingTransitions() const;
+
+  Arena *arena;
+  const InputSymbols *inputSymbols;
+  ArenaVector<const InputSymbol *> symbols;
+  ArenaVector<NameRef> names;
+  ArenaVector<StateId> table;
+  ArenaVector<uint8_t> finals;
+  uint32_t stateCount;
+  StateId initialState;
+  bool allowPartial;
+  std::shared_ptr<const Provenance> provenance;
+  /** id in provenance of every state, empty if it is the state itself */
+  ArenaVector<StateId> provenanceIds;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_INDEXED_DFA */
@@ -0,0 +1,187 @@
+#include "Lexer.hpp"
+#include "CompiledDFA.hpp"
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include <sstream>
+#include <unordered_map>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+struct TupleHash {
+  std::size_t operator()(const std::vector<StateId> &tuple) const {
+    // FNV-1a over the token states
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto state : tuple) {
+      hash = (hash ^ state) * 0x100000001b3ull;
+    }
+    return static_cast<std::size_t>(hash);
+  }
+};
+
+/**
+ * @brief Mark the states of dfa from which a final state can be reached.
+ *
+ */
+std::vector<uint8_t> liveStates(const CompiledDFA &dfa) {
+  uint32_t stateCount = dfa.getStateCount();
+  std::vector<std::vector<StateId>> predecessors(stateCount);
+  for (StateId state = 0; state < stateCount; state++) {
+    for (SymbolClass c = 0; c < dfa.getClassCount(); c++) {
+      StateId target = dfa.nextState(state, c);
+      if (target != NO_STATE) {
+        predecessors[target].push_back(state);
+      }
+    }
+  }
+  std::vector<uint8_t> live(stateCount, 0);
+  std::vector<StateId> queue;
+  for (StateId state = 0; state < stateCount; state++) {
+    if (dfa.isFinal(state)) {
+      live[state] = 1;
+      queue.push_back(state);
+    }
+  }
+  for (std::size_t i = 0; i < queue.size(); i++) {
+    for (auto predecessor : predecessors[queue[i]]) {
+      if (!live[predecessor]) {
+        live[predecessor] = 1;
+        queue.push_back(predecessor);
+      }
+    }
+  }
+  return live;
+}
+
+} // namespace
+
+Lexer::Lexer(const std::vector<DFA> &tokenTypes)
+    : columnCount(0), stateCount(0),
+      tokenTypeCount(static_cast<uint32_t>(tokenTypes.size())) {
+  InputSymbols alphabet;
+  for (auto &dfa : tokenTypes) {
+    for (auto &symbol : dfa.getInputSymbols()) {
+      if (symbol.size() != 1) {
+        std::stringstream msg;
+        msg << "lexer symbols must be single characters, got " << symbol;
+        throw InvalidSymbolException(msg.str());
+      }
+      alphabet.insert(symbol);
+    }
+  }
+  this->alphabet = AlphabetIndex(alphabet);
+  columnCount = this->alphabet.size();
+
+  std::vector<CompiledDFA> compiled;
+  std::vector<std::vector<uint8_t>> live;
+  // classes[t * columnCount + column], the class of a column in token t
+  std::vector<SymbolClass> classes;
+  compiled.reserve(tokenTypeCount);
+  for (auto &dfa : tokenTypes) {
+    compiled.emplace_back(dfa);
+    live.push_back(liveStates(compiled.back()));
+    for (auto &symbol : alphabet) {
+      classes.push_back(compiled.back().symbolClass(symbol));
+    }
+  }
+
+  // Breadth-first exploration of the tuples of live token states
+  std::unordered_map<std::vector<StateId>, StateId, TupleHash> ids;
+  std::vector<std::vector<StateId>> tuples;
+  std::vector<StateId> tuple(tokenTypeCount);
+  for (uint32_t t = 0; t < tokenTypeCount; t++) {
+    StateId initial = compiled[t].getInitialState();
+    tuple[t] = initial != NO_STATE && live[t][initial] ? initial : NO_STATE;
+  }
+  ids.emplace(tuple, 0);
+  tuples.push_back(tuple);
+  for (std::size_t i = 0; i < tuples.size(); i++) {
+    table.resize(table.size() + columnCount, NO_STATE);
+    for (uint32_t column = 0; column < columnCount; column++) {
+      bool alive = false;
+      for (uint32_t t = 0; t < tokenTypeCount; t++) {
+        StateId state = tuples[i][t];
+        SymbolClass c = classes[t * columnCount + column];
+        if (state != NO_STATE && c != NO_CLASS) {
+          state = compiled[t].nextState(state, c);
+        } else {
+          state = NO_STATE;
+        }
+        if (state != NO_STATE && !live[t][state]) {
+          state = NO_STATE;
+        }
+        tuple[t] = state;
+        alive = alive || state != NO_STATE;
+      }
+      if (alive) {
+        auto inserted =
+            ids.emplace(tuple, static_cast<StateId>(tuples.size()));
+        if (inserted.second) {
+          tuples.push_back(tuple);
+        }
+        table[i * columnCount + column] = inserted.first->second;
+      }
+    }
+  }
+
+  stateCount = static_cast<uint32_t>(tuples.size());
+  accepted.assign(stateCount, NO_TOKEN);
+  for (StateId state = 0; state < stateCount; state++) {
+    for (uint32_t t = 0; t < tokenTypeCount; t++) {
+      StateId tokenState = tuples[state][t];
+      if (tokenState != NO_STATE && compiled[t].isFinal(tokenState)) {
+        accepted[state] = t;
+        break;
+      }
+    }
+  }
+}
+
+bool Lexer::nextToken(const char *data, std::size_t size, std::size_t offset,
+                      Token &token) const {
+  StateId state = 0;
+  TokenType lastType = NO_TOKEN;
+  std::size_t lastEnd = offset;
+  for (std::size_t i = offset; i < size; i++) {
+    state = next(state, static_cast<unsigned char>(data[i]));
+    if (state == NO_STATE) {
+      break;
+    }
+    if (accepted[state] != NO_TOKEN) {
+      lastType = accepted[state];
+      lastEnd = i + 1;
+    }
+  }
+  if (lastType == NO_TOKEN) {
+    return false;
+  }
+  token.type = lastType;
+  token.offset = offset;
+  token.length = lastEnd - offset;
+  return true;
+}
+
+std::size_t Lexer::scan(const char *data, std::size_t size,
+                        std::vector<Token> &tokens) const {
+  std::size_t offset = 0;
+  Token token;
+  while (offset < size && nextToken(data, size, offset, token)) {
+    tokens.push_back(token);
+    offset += token.length;
+  }
+  return offset;
+}
+
+std::vector<Token> Lexer::tokenize(const std::string &buffer) const {
+  std::vector<Token> tokens;
+  std::size_t stop = scan(buffer.data(), buffer.size(), tokens);
+  if (stop < buffer.size()) {
+    std::stringstream msg;
+    msg << "no token starts at offset " << stop;
+    throw RejectionException(msg.str());
+  }
+  return tokens;
+}
+
+} // namespace CXXAUTOMATA
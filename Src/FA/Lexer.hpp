@@ -0,0 +1,123 @@
+#ifndef CXXAUTOMATA_LEXER
+#define CXXAUTOMATA_LEXER
+
+#include "AlphabetIndex.hpp"
+#include "IndexedDFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+class DFA;
+
+typedef uint32_t TokenType;
+
+/** Marks a lexer state that accepts no token type. */
+static const TokenType NO_TOKEN = 0xFFFFFFFFu;
+
+/**
+ * @brief A token found by a Lexer: its type and where it lies in the
+ *        scanned buffer. Tokens do not copy the text.
+ *
+ */
+struct Token {
+  TokenType type;
+  std::size_t offset;
+  std::size_t length;
+};
+
+/**
+ * @brief Maximal-munch scanner built from one DFA per token type.
+ *
+ *        The token DFAs are merged into a single automaton whose states are
+ *        tuples of token states, explored from the tuple of initial states.
+ *        A state is tagged with the first token type, in the order given,
+ *        that accepts in it, so earlier types take priority over later ones
+ *        on matches of equal length. Token states that cannot reach a final
+ *        state are dropped, which lets the scan stop as soon as no longer
+ *        match is possible: a buffer is read once, backing up at most the
+ *        distance to the last accepting position.
+ *
+ *        Every symbol of the token DFAs must be a single character, and the
+ *        buffer is scanned byte by byte. Empty matches never produce a
+ *        token. A Lexer is immutable and may be shared between threads.
+ */
+class Lexer {
+public:
+  /**
+   * @brief Merge the given token DFAs; token type i is tokenTypes[i].
+   *
+   * @param tokenTypes in decreasing order of priority
+   * @throw InvalidSymbolException if a symbol is not a single character
+   */
+  explicit Lexer(const std::vector<DFA> &tokenTypes);
+
+  /**
+   * @brief Find the longest token starting at offset, preferring the
+   *        earliest token type among matches of that length.
+   *
+   * @param data
+   * @param size
+   * @param offset
+   * @param token receives the token if there is one
+   * @return true if a non-empty token starts at offset
+   */
+  bool nextToken(const char *data, std::size_t size, std::size_t offset,
+                 Token &token) const;
+
+  /**
+   * @brief Split data into tokens from the start, appending them to tokens,
+   *        until the end of data or a position where no token starts.
+   *
+   * @param data
+   * @param size
+   * @param tokens
+   * @return std::size_t the offset where scanning stopped, size if all of
+   *         data was split
+   */
+  std::size_t scan(const char *data, std::size_t size,
+                   std::vector<Token> &tokens) const;
+
+  /**
+   * @brief Split buffer into tokens.
+   *
+   * @param buffer
+   * @return std::vector<Token>
+   * @throw RejectionException if some position of buffer starts no token
+   */
+  std::vector<Token> tokenize(const std::string &buffer) const;
+
+  uint32_t getStateCount() const { return stateCount; }
+  uint32_t getTokenTypeCount() const { return tokenTypeCount; }
+
+  /**
+   * @brief Return the token type accepted in state, or NO_TOKEN.
+   *
+   * @param state
+   * @return TokenType
+   */
+  TokenType getAcceptedType(StateId state) const { return accepted[state]; }
+
+private:
+  StateId next(StateId state, unsigned char byte) const {
+    uint32_t column = alphabet.findByte(byte);
+    return column == NO_SYMBOL
+               ? NO_STATE
+               : table[static_cast<std::size_t>(state) * columnCount + column];
+  }
+
+  /** from every symbol of the token DFAs to its column in table */
+  AlphabetIndex alphabet;
+  uint32_t columnCount;
+  uint32_t stateCount;
+  uint32_t tokenTypeCount;
+  std::vector<StateId> table;
+  std::vector<TokenType> accepted;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_LEXER */
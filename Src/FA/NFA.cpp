@@ -1,5 +1,180 @@
 #include "NFA.hpp"
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include "Utilities.hpp"
+#include <deque>
+#include <sstream>
+#include <utility>
 
-NFA::NFA() {}
+namespace CXXAUTOMATA {
 
-NFA::~NFA() {}
\ No newline at end of file
+const InputSymbol NFA::LAMBDA = "";
+
+NFA::NFA(States states, InputSymbols inputSymbols, NFATransitions transitions,
+         State initialState, States finalStates)
+    : FA() {
+  this->states = std::move(states);
+  this->inputSymbols = std::move(inputSymbols);
+  this->nfaTransitions = std::move(transitions);
+  this->initialState = std::move(initialState);
+  this->finalStates = std::move(finalStates);
+  this->validate();
+  updateMemoryAccount();
+}
+
+NFA::NFA(const NFA &nfa) {
+  this->states = nfa.states;
+  this->inputSymbols = nfa.inputSymbols;
+  this->nfaTransitions = nfa.nfaTransitions;
+  this->initialState = nfa.initialState;
+  this->finalStates = nfa.finalStates;
+  updateMemoryAccount();
+}
+
+NFA &NFA::operator=(const NFA &rhs) {
+  Automaton::operator=(rhs);
+  nfaTransitions = rhs.nfaTransitions;
+  updateMemoryAccount();
+  return *this;
+}
+
+NFA::~NFA() {}
+
+MemoryUsage NFA::memoryUsage() const {
+  MemoryUsage usage = FA::memoryUsage();
+  usage.transitions += MemoryUsage::of(nfaTransitions);
+  usage.auxiliary +=
+      sizeof(*this) - sizeof(Automaton) - sizeof(nfaTransitions);
+  return usage;
+}
+
+const NFATransitions &NFA::getNFATransitions() const { return nfaTransitions; }
+
+void NFA::validateTransitionStartStates() const {
+  for (auto &transition : nfaTransitions) {
+    if (states.find(transition.first) == states.end()) {
+      std::stringstream ss;
+      ss << "transition start state " << transition.first << " is invalid";
+      throw InvalidStateException(ss.str());
+    }
+  }
+}
+
+void NFA::validateTransitionInvalidSymbols(const State &start_state,
+                                           const NFAPaths &paths) const {
+  for (auto &path : paths) {
+    if (path.first != LAMBDA &&
+        inputSymbols.find(path.first) == inputSymbols.end()) {
+      std::stringstream ss;
+      ss << "state " << start_state << " has an invalid transition symbol "
+         << path.first;
+      throw InvalidSymbolException(ss.str());
+    }
+  }
+}
+
+void NFA::validateTransitionEndStates(const State &start_state,
+                                      const NFAPaths &paths) const {
+  for (auto &path : paths) {
+    for (auto &end_state : path.second) {
+      if (states.find(end_state) == states.end()) {
+        std::stringstream ss;
+        ss << "end state " << end_state << " for transition on "
+           << start_state << " is invalid";
+        throw InvalidStateException(ss.str());
+      }
+    }
+  }
+}
+
+bool NFA::validate() const {
+  validateTransitionStartStates();
+  for (auto &transition : nfaTransitions) {
+    validateTransitionInvalidSymbols(transition.first, transition.second);
+    validateTransitionEndStates(transition.first, transition.second);
+  }
+  ValidationResult result;
+  validateInitialState(result);
+  validateFinalStates(result);
+  result.throwIfInvalid();
+  return true;
+}
+
+States NFA::getLambdaClosure(const State &start_state) const {
+  States closure;
+  std::deque<State> statesToCheck;
+  closure.insert(start_state);
+  statesToCheck.push_back(start_state);
+  while (!statesToCheck.empty()) {
+    auto state = statesToCheck.front();
+    statesToCheck.pop_front();
+    auto transition = nfaTransitions.find(state);
+    if (transition == nfaTransitions.end()) {
+      continue;
+    }
+    auto lambdaPath = transition->second.find(LAMBDA);
+    if (lambdaPath == transition->second.end()) {
+      continue;
+    }
+    for (auto &end_state : lambdaPath->second) {
+      if (closure.insert(end_state).second) {
+        statesToCheck.push_back(end_state);
+      }
+    }
+  }
+  return closure;
+}
+
+States NFA::getNextCurrentStates(const States &current_states,
+                                 const InputSymbol &input_symbol) const {
+  States next_current_states;
+  for (auto &current_state : current_states) {
+    auto transition = nfaTransitions.find(current_state);
+    if (transition == nfaTransitions.end()) {
+      continue;
+    }
+    auto path = transition->second.find(input_symbol);
+    if (path == transition->second.end()) {
+      continue;
+    }
+    for (auto &end_state : path->second) {
+      auto closure = getLambdaClosure(end_state);
+      next_current_states.insert(closure.begin(), closure.end());
+    }
+  }
+  return next_current_states;
+}
+
+void NFA::checkForInputRejection(const States &current_states) const {
+  for (auto &state : current_states) {
+    if (finalStates.find(state) != finalStates.end()) {
+      return;
+    }
+  }
+  States_v current_states_v;
+  set2Vector(current_states, current_states_v);
+  std::stringstream ss;
+  ss << "the NFA stopped on all non-final states "
+     << DFA::stringifyStates(current_states_v);
+  throw RejectionException(ss.str());
+}
+
+States_v NFA::readInputStepwise(const InputSymbols_v &input_str) const {
+  States_v stateYield;
+  States current_states = getLambdaClosure(initialState);
+
+  States_v current_states_v;
+  set2Vector(current_states, current_states_v);
+  stateYield.push_back(DFA::stringifyStates(current_states_v));
+  for (auto &input_symbol : input_str) {
+    current_states = getNextCurrentStates(current_states, input_symbol);
+    current_states_v.clear();
+    set2Vector(current_states, current_states_v);
+    stateYield.push_back(DFA::stringifyStates(current_states_v));
+  }
+  checkForInputRejection(current_states);
+
+  return stateYield;
+}
+
+} // namespace CXXAUTOMATA
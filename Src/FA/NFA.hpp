@@ -1,23 +1,118 @@
 #ifndef CXXAUTOMATA_NFA
 #define CXXAUTOMATA_NFA
-#pragma once
+
 #include "FA.hpp"
+#include "Typedefs.hpp"
 
 namespace CXXAUTOMATA {
+/**
+ * @brief A nondeterministic finite automaton.
+ *
+ * Transitions map each state and symbol to a set of end states. The empty
+ * symbol LAMBDA denotes a lambda (epsilon) transition.
+ */
 class NFA : public FA {
-
-private:
 public:
-  NFA();
-  ~NFA();
+  /**
+   * @brief Construct a new NFA object. The arguments are taken by value so
+   *        that large automata built by the caller can be moved in.
+   *
+   */
+  NFA(States states, InputSymbols inputSymbols, NFATransitions transitions,
+      State initialState, States finalStates);
+
+  NFA(const NFA &nfa);
+  NFA &operator=(const NFA &rhs);
+  virtual ~NFA();
+
+  /**
+   * @brief Return the estimated memory held by this NFA, with its
+   *        nondeterministic transitions as transitions.
+   *
+   * @return MemoryUsage
+   */
+  MemoryUsage memoryUsage() const override;
+
+  /**
+   * @brief Return True if this NFA is internally consistent.
+   *
+   * @return true
+   * @return false
+   */
+  bool validate() const override;
+
+  /**
+   * @brief Check if the given string is accepted by this NFA.
+   *        Yield the current configuration of the NFA at each step, named
+   *        as the equivalent DFA state (see DFA::stringifyStates).
+   *
+   * @param input_str
+   * @return States_v
+   */
+  States_v readInputStepwise(const InputSymbols_v &input_str) const override;
 
-  State getNextCurrentState(const State &current_state,
-                               const InputSymbol &input_symbol) const{return State();};
+  /**
+   * @brief Return the states reachable from the given state using only
+   *        lambda transitions, including the state itself.
+   *
+   * @param start_state
+   * @return States
+   */
+  States getLambdaClosure(const State &start_state) const;
 
-  States getLambdaClosure(const State &current_state) const{return States();};
+  /**
+   * @brief Return the next set of current states given the current set.
+   *
+   * @param current_states
+   * @param input_symbol
+   * @return States
+   */
+  States getNextCurrentStates(const States &current_states,
+                              const InputSymbol &input_symbol) const;
+
+  const NFATransitions &getNFATransitions() const;
+
+  /**
+   * @brief The symbol used for lambda transitions.
+   *
+   */
+  static const InputSymbol LAMBDA;
 
 private:
-  
+  /**
+   * @brief Raise an error if transition start states are invalid.
+   *
+   */
+  void validateTransitionStartStates() const;
+
+  /**
+   * @brief Raise an error if transition input symbols are invalid.
+   *
+   * @param start_state
+   * @param paths
+   */
+  void validateTransitionInvalidSymbols(const State &start_state,
+                                        const NFAPaths &paths) const;
+
+  /**
+   * @brief Raise an error if transition end states are invalid.
+   *
+   * @param start_state
+   * @param paths
+   */
+  void validateTransitionEndStates(const State &start_state,
+                                   const NFAPaths &paths) const;
+
+  /**
+   * @brief Raise an error if the given config indicates rejected
+   * input.
+   *
+   * @param current_states
+   */
+  void checkForInputRejection(const States &current_states) const;
+
+  NFATransitions nfaTransitions;
 };
-}
-#endif // CXXAUTOMATA_NFA	
\ No newline at end of file
+} // namespace CXXAUTOMATA
+
+#endif // CXXAUTOMATA_NFA
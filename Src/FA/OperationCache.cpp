@@ -0,0 +1,165 @@
+#include "OperationCache.hpp"
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+// Hash of dfa as written, which tells apart DFAs that differ in any name
+Fingerprint structure(const DFA &dfa) {
+  FingerprintBuilder hash;
+  hash.add(dfa.getStates().size());
+  for (auto &state : dfa.getStates()) {
+    hash.add(state);
+  }
+  hash.add(dfa.getInputSymbols().size());
+  for (auto &symbol : dfa.getInputSymbols()) {
+    hash.add(symbol);
+  }
+  hash.add(dfa.getTransitions().size());
+  for (auto &transition : dfa.getTransitions()) {
+    hash.add(transition.first);
+    hash.add(transition.second.size());
+    for (auto &path : transition.second) {
+      hash.add(path.first);
+      hash.add(path.second);
+    }
+  }
+  hash.add(dfa.getFinalStates().size());
+  for (auto &state : dfa.getFinalStates()) {
+    hash.add(state);
+  }
+  hash.add(dfa.getInitialState());
+  hash.add(dfa.getAllowPartial());
+  return hash.finish();
+}
+
+} // namespace
+
+OperationCache::OperationCache(std::size_t capacity)
+    : capacity(capacity), hits(0), misses(0) {}
+
+bool OperationCache::find(const Key &key, Entry &entry) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = index.find(key);
+  if (found == index.end()) {
+    misses++;
+    return false;
+  }
+  hits++;
+  entries.splice(entries.begin(), entries, found->second);
+  entry = *found->second;
+  return true;
+}
+
+void OperationCache::insert(const Entry &entry) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (capacity == 0 || index.count(entry.key)) {
+    // Another thread computed the same result meanwhile
+    return;
+  }
+  entries.push_front(entry);
+  index.emplace(entry.key, entries.begin());
+  if (entries.size() > capacity) {
+    index.erase(entries.back().key);
+    entries.pop_back();
+  }
+}
+
+OperationCache::Entry OperationCache::canonicalEntry(const DFA &dfa) {
+  Key key = {MINIFY, structure(dfa), Fingerprint()};
+  Entry entry;
+  if (!find(key, entry)) {
+    entry.key = key;
+    entry.dfa = std::make_shared<const DFA>(dfa.canonical(&entry.canonical));
+    entry.answer = false;
+    insert(entry);
+  }
+  return entry;
+}
+
+DFA OperationCache::minify(const DFA &dfa) {
+  return *canonicalEntry(dfa).dfa;
+}
+
+DFA OperationCache::product(Operation operation, const DFA &a,
+                            const DFA &b) {
+  Entry left = canonicalEntry(a);
+  Entry right = canonicalEntry(b);
+  Key key = {operation, left.canonical, right.canonical};
+  Entry entry;
+  if (find(key, entry)) {
+    return *entry.dfa;
+  }
+  DFA result = *left.dfa;
+  switch (operation) {
+  case UNION:
+    result = left.dfa->unionJoin(*right.dfa);
+    break;
+  case INTERSECTION:
+    result = left.dfa->intersection(*right.dfa);
+    break;
+  case DIFFERENCE:
+    result = left.dfa->difference(*right.dfa);
+    break;
+  default:
+    result = left.dfa->symmetricDifference(*right.dfa);
+    break;
+  }
+  entry.key = key;
+  entry.dfa = std::make_shared<const DFA>(result.canonical(&entry.canonical));
+  entry.answer = false;
+  insert(entry);
+  return *entry.dfa;
+}
+
+DFA OperationCache::unionJoin(const DFA &a, const DFA &b) {
+  return product(UNION, a, b);
+}
+
+DFA OperationCache::intersection(const DFA &a, const DFA &b) {
+  return product(INTERSECTION, a, b);
+}
+
+DFA OperationCache::difference(const DFA &a, const DFA &b) {
+  return product(DIFFERENCE, a, b);
+}
+
+DFA OperationCache::symmetricDifference(const DFA &a, const DFA &b) {
+  return product(SYMMETRIC_DIFFERENCE, a, b);
+}
+
+bool OperationCache::isSubset(const DFA &a, const DFA &b) {
+  Entry left = canonicalEntry(a);
+  Entry right = canonicalEntry(b);
+  Key key = {IS_SUBSET, left.canonical, right.canonical};
+  Entry entry;
+  if (!find(key, entry)) {
+    entry.key = key;
+    entry.answer = left.dfa->isSubset(*right.dfa);
+    insert(entry);
+  }
+  return entry.answer;
+}
+
+std::size_t OperationCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+uint64_t OperationCache::getHits() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits;
+}
+
+uint64_t OperationCache::getMisses() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return misses;
+}
+
+void OperationCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  index.clear();
+}
+
+} // namespace CXXAUTOMATA
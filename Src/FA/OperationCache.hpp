@@ -0,0 +1,122 @@
+#ifndef CXXAUTOMATA_OPERATION_CACHE
+#define CXXAUTOMATA_OPERATION_CACHE
+
+#include "DFA.hpp"
+#include "Fingerprint.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Opt-in, size-bounded LRU cache of DFA operations keyed by the
+ *        operation and the fingerprints of its operands.
+ *
+ *        Minimizations are keyed by a hash of the operand as written, its
+ *        states, symbols, transitions and final states, which costs no
+ *        minimization, and hold its canonical form (see DFA::canonical)
+ *        with the fingerprint of that form. Products and inclusion tests
+ *        find their operands' canonical forms through these entries and
+ *        are keyed by the fingerprints, so operands that are equivalent,
+ *        however they are named or shaped, share one result, and an
+ *        operand seen before is not minimized again. Results are returned
+ *        in canonical form and do not depend on which operand was seen
+ *        first. A cache may be shared between threads.
+ */
+class OperationCache {
+public:
+  enum Operation {
+    MINIFY,
+    UNION,
+    INTERSECTION,
+    DIFFERENCE,
+    SYMMETRIC_DIFFERENCE,
+    IS_SUBSET
+  };
+
+  /**
+   * @brief Construct a cache holding at most capacity results.
+   *
+   * @param capacity
+   */
+  explicit OperationCache(std::size_t capacity);
+
+  /**
+   * @brief Return the canonical minimal DFA of dfa.
+   *
+   * @param dfa
+   * @return DFA
+   */
+  DFA minify(const DFA &dfa);
+
+  /**
+   * @brief Same as the DFA operations of the same names, returning the
+   *        canonical minimal result.
+   *
+   */
+  DFA unionJoin(const DFA &a, const DFA &b);
+  DFA intersection(const DFA &a, const DFA &b);
+  DFA difference(const DFA &a, const DFA &b);
+  DFA symmetricDifference(const DFA &a, const DFA &b);
+  bool isSubset(const DFA &a, const DFA &b);
+
+  std::size_t size() const;
+  std::size_t getCapacity() const { return capacity; }
+  uint64_t getHits() const;
+  uint64_t getMisses() const;
+
+  /**
+   * @brief Drop every result, keeping the counters.
+   *
+   */
+  void clear();
+
+private:
+  struct Key {
+    Operation operation;
+    Fingerprint a;
+    Fingerprint b;
+
+    bool operator==(const Key &other) const {
+      return operation == other.operation && a == other.a && b == other.b;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const {
+      FingerprintHash hash;
+      return hash(key.a) * 31 + hash(key.b) * 7 + key.operation;
+    }
+  };
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<const DFA> dfa;
+    /** the fingerprint of dfa, for minimizations */
+    Fingerprint canonical;
+    bool answer;
+  };
+
+  typedef std::list<Entry> Entries;
+
+  bool find(const Key &key, Entry &entry);
+  void insert(const Entry &entry);
+  Entry canonicalEntry(const DFA &dfa);
+  DFA product(Operation operation, const DFA &a, const DFA &b);
+
+  std::size_t capacity;
+  mutable std::mutex mutex;
+  /** most recently used first */
+  Entries entries;
+  std::unordered_map<Key, Entries::iterator, KeyHash> index;
+  uint64_t hits;
+  uint64_t misses;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_OPERATION_CACHE */
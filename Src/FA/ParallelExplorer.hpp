@@ -0,0 +1,160 @@
+#ifndef CXXAUTOMATA_PARALLEL_EXPLORER
+#define CXXAUTOMATA_PARALLEL_EXPLORER
+
+#include "IndexedDFA.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Breadth-first exploration of the states of a constructed DFA, such
+ *        as a product or a subset construction, on a ThreadPool.
+ *
+ *        Each level of the search is expanded by all workers, which steal
+ *        frontier ranges from each other, and discovered states are
+ *        interned in a hash table split into locked shards. A new state
+ *        remembers the first (parent, symbol) that reached it, and once the
+ *        level is done the new states are numbered in that order. States
+ *        therefore get exactly the ids a sequential breadth-first search
+ *        gives them, whatever the number of threads.
+ *
+ * @tparam Key identifies a state, e.g. a pair or a set of states
+ * @tparam Hash
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class ParallelExplorer {
+public:
+  ParallelExplorer(ThreadPool &pool, std::size_t symbolCount)
+      : pool(pool), symbolCount(symbolCount),
+        shards(4 * pool.getThreadCount()) {}
+
+  /**
+   * @brief Explore every state reachable from initial. expand(state,
+   *        symbol, successor) is called concurrently for every state and
+   *        symbol; it stores the successor and returns true, or returns
+   *        false if there is no transition.
+   *
+   * @param initial
+   * @param expand
+   */
+  template <typename Expand>
+  void explore(const Key &initial, const Expand &expand) {
+    Entry *first = &intern(initial, 0).first->second;
+    first->id = 0;
+    states.push_back(initial);
+    std::size_t levelBegin = 0;
+    while (levelBegin < states.size()) {
+      std::size_t levelEnd = states.size();
+      targets.resize(levelEnd * symbolCount, nullptr);
+      pool.parallelFor(
+          levelEnd - levelBegin, GRAIN,
+          [&](std::size_t begin, std::size_t end) {
+            Key successor;
+            for (std::size_t i = levelBegin + begin; i < levelBegin + end;
+                 i++) {
+              for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+                if (expand(states[i], symbol, successor)) {
+                  targets[i * symbolCount + symbol] =
+                      discover(successor, i * symbolCount + symbol);
+                }
+              }
+            }
+          });
+      number();
+      levelBegin = levelEnd;
+    }
+  }
+
+  const std::vector<Key> &getStates() const { return states; }
+
+  /**
+   * @brief Return the id of the successor of state on symbol, or NO_STATE.
+   *
+   * @param state
+   * @param symbol
+   * @return StateId
+   */
+  StateId next(StateId state, SymbolId symbol) const {
+    const Entry *target =
+        targets[static_cast<std::size_t>(state) * symbolCount + symbol];
+    return target == nullptr ? NO_STATE : target->id;
+  }
+
+private:
+  static const std::size_t GRAIN = 64;
+
+  struct Entry {
+    /** smallest parent * symbolCount + symbol that reached the state */
+    uint64_t rank;
+    StateId id;
+  };
+  typedef std::unordered_map<Key, Entry, Hash> Table;
+  struct Shard {
+    std::mutex mutex;
+    Table table;
+    /** states first seen during the current level */
+    std::vector<typename Table::value_type *> fresh;
+  };
+
+  std::pair<typename Table::iterator, bool> intern(const Key &key,
+                                                   uint64_t rank) {
+    Shard &shard = shards[hash(key) % shards.size()];
+    Entry entry = {rank, NO_STATE};
+    auto inserted = shard.table.emplace(key, entry);
+    if (inserted.second) {
+      shard.fresh.push_back(&*inserted.first);
+    }
+    return inserted;
+  }
+
+  Entry *discover(const Key &key, uint64_t rank) {
+    Shard &shard = shards[hash(key) % shards.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Entry entry = {rank, NO_STATE};
+    auto inserted = shard.table.emplace(key, entry);
+    Entry &found = inserted.first->second;
+    if (inserted.second) {
+      shard.fresh.push_back(&*inserted.first);
+    } else if (found.id == NO_STATE && rank < found.rank) {
+      found.rank = rank;
+    }
+    return &found;
+  }
+
+  void number() {
+    std::vector<typename Table::value_type *> fresh;
+    for (auto &shard : shards) {
+      fresh.insert(fresh.end(), shard.fresh.begin(), shard.fresh.end());
+      shard.fresh.clear();
+    }
+    std::sort(fresh.begin(), fresh.end(),
+              [](const typename Table::value_type *x,
+                 const typename Table::value_type *y) {
+                return x->second.rank < y->second.rank;
+              });
+    for (auto state : fresh) {
+      if (state->second.id == NO_STATE) {
+        state->second.id = static_cast<StateId>(states.size());
+        states.push_back(state->first);
+      }
+    }
+  }
+
+  ThreadPool &pool;
+  std::size_t symbolCount;
+  Hash hash;
+  std::vector<Shard> shards;
+  std::vector<Key> states;
+  std::vector<const Entry *> targets;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_PARALLEL_EXPLORER */
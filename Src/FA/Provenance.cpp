@@ -0,0 +1,104 @@
+#include "Provenance.hpp"
+#include "MemoryUsage.hpp"
+#include <utility>
+
+namespace CXXAUTOMATA {
+
+Provenance::Provenance(Kind kind) : kind(kind), stateCount(0) {}
+
+std::shared_ptr<const Provenance> Provenance::source(States_v names) {
+  std::shared_ptr<Provenance> result(new Provenance(SOURCE));
+  result->stateCount = names.size();
+  result->names = std::move(names);
+  return result;
+}
+
+std::shared_ptr<const Provenance>
+Provenance::product(std::shared_ptr<const Provenance> left,
+                    std::shared_ptr<const Provenance> right,
+                    std::vector<StateId> pairs) {
+  std::shared_ptr<Provenance> result(new Provenance(PRODUCT));
+  result->stateCount = pairs.size() / 2;
+  result->left = std::move(left);
+  result->right = std::move(right);
+  result->ids = std::move(pairs);
+  return result;
+}
+
+std::shared_ptr<const Provenance>
+Provenance::classes(std::shared_ptr<const Provenance> parent,
+                    std::vector<uint32_t> memberStart,
+                    std::vector<StateId> members) {
+  std::shared_ptr<Provenance> result(new Provenance(CLASSES));
+  result->stateCount = memberStart.empty() ? 0 : memberStart.size() - 1;
+  result->left = std::move(parent);
+  result->memberStart = std::move(memberStart);
+  result->ids = std::move(members);
+  return result;
+}
+
+std::shared_ptr<const Provenance>
+Provenance::inserted(std::shared_ptr<const Provenance> parent,
+                     StateId position, State name) {
+  std::shared_ptr<Provenance> result(new Provenance(INSERTED));
+  result->stateCount = parent->getStateCount() + 1;
+  result->left = std::move(parent);
+  result->names.push_back(std::move(name));
+  result->ids.push_back(position);
+  return result;
+}
+
+std::vector<StateId> Provenance::getMembers(StateId state) const {
+  return std::vector<StateId>(ids.begin() + memberStart[state],
+                              ids.begin() + memberStart[state + 1]);
+}
+
+std::string Provenance::name(StateId state) const {
+  std::string out;
+  appendName(state, out);
+  return out;
+}
+
+void Provenance::appendName(StateId state, std::string &out) const {
+  switch (kind) {
+  case SOURCE:
+    out += names[state];
+    break;
+  case PRODUCT:
+    if (ids[2 * state] != NO_STATE) {
+      left->appendName(ids[2 * state], out);
+    }
+    out += ',';
+    if (ids[2 * state + 1] != NO_STATE) {
+      right->appendName(ids[2 * state + 1], out);
+    }
+    break;
+  case CLASSES:
+    for (uint32_t m = memberStart[state]; m < memberStart[state + 1]; m++) {
+      if (m != memberStart[state]) {
+        out += ',';
+      }
+      left->appendName(ids[m], out);
+    }
+    break;
+  case INSERTED:
+    if (state == ids[0]) {
+      out += names[0];
+    } else {
+      left->appendName(state < ids[0] ? state : state - 1, out);
+    }
+    break;
+  }
+}
+
+std::size_t Provenance::memoryBytes() const {
+  std::size_t bytes = sizeof(*this) + names.capacity() * sizeof(State) +
+                      ids.capacity() * sizeof(StateId) +
+                      memberStart.capacity() * sizeof(uint32_t);
+  for (auto &name : names) {
+    bytes += MemoryUsage::of(name) - sizeof(name);
+  }
+  return bytes;
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,142 @@
+#ifndef CXXAUTOMATA_PROVENANCE
+#define CXXAUTOMATA_PROVENANCE
+
+#include "IndexedDFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Where the states of a derived DFA come from, recorded as state ids
+ *        instead of concatenated names.
+ *
+ *        A source provenance holds the names of an automaton. A product
+ *        provenance holds, for every state, the pair of parent states it
+ *        stands for, and a class provenance the parent states merged into
+ *        it; both point to the provenance of their parents, as does an
+ *        inserted provenance, which adds a single named state. Every record is
+ *        a fixed number of ids per state, however long the chain of
+ *        operations, and a readable name is only built by name(). States
+ *        are identified by their index in the sorted states of the DFA
+ *        they belong to. Provenances are immutable and shared between the
+ *        automata derived from them.
+ */
+class Provenance {
+public:
+  enum Kind { SOURCE, PRODUCT, CLASSES, INSERTED };
+
+  /**
+   * @brief Return a provenance naming state i by names[i].
+   *
+   * @param names
+   * @return std::shared_ptr<const Provenance>
+   */
+  static std::shared_ptr<const Provenance> source(States_v names);
+
+  /**
+   * @brief Return a provenance in which state i stands for the pair
+   *        (pairs[2 * i], pairs[2 * i + 1]) of a left and a right state.
+   *        NO_STATE stands for the implicit dead state of a side.
+   *
+   * @param left
+   * @param right
+   * @param pairs
+   * @return std::shared_ptr<const Provenance>
+   */
+  static std::shared_ptr<const Provenance>
+  product(std::shared_ptr<const Provenance> left,
+          std::shared_ptr<const Provenance> right,
+          std::vector<StateId> pairs);
+
+  /**
+   * @brief Return a provenance in which state i stands for the parent
+   *        states members[memberStart[i] .. memberStart[i + 1]).
+   *
+   * @param parent
+   * @param memberStart
+   * @param members
+   * @return std::shared_ptr<const Provenance>
+   */
+  static std::shared_ptr<const Provenance>
+  classes(std::shared_ptr<const Provenance> parent,
+          std::vector<uint32_t> memberStart, std::vector<StateId> members);
+
+  /**
+   * @brief Return a provenance with the states of parent and one more
+   *        state, named name, at index position; the parent states from
+   *        position on move up by one.
+   *
+   * @param parent
+   * @param position
+   * @param name
+   * @return std::shared_ptr<const Provenance>
+   */
+  static std::shared_ptr<const Provenance>
+  inserted(std::shared_ptr<const Provenance> parent, StateId position,
+           State name);
+
+  Kind getKind() const { return kind; }
+  std::size_t getStateCount() const { return stateCount; }
+  const std::shared_ptr<const Provenance> &getLeft() const { return left; }
+  const std::shared_ptr<const Provenance> &getRight() const { return right; }
+
+  /**
+   * @brief Return the pair of parent states of a product state.
+   *
+   * @param state
+   * @return std::pair<StateId, StateId>
+   */
+  std::pair<StateId, StateId> getPair(StateId state) const {
+    return std::make_pair(ids[2 * state], ids[2 * state + 1]);
+  }
+
+  /**
+   * @brief Return the parent states merged into a class state.
+   *
+   * @param state
+   * @return std::vector<StateId>
+   */
+  std::vector<StateId> getMembers(StateId state) const;
+
+  /**
+   * @brief Build the name the state would have had if every operation had
+   *        kept names: a source name, "left,right" for a pair, and the
+   *        members' names joined by "," for a class.
+   *
+   * @param state
+   * @return std::string
+   */
+  std::string name(StateId state) const;
+
+  /**
+   * @brief Return the estimated bytes of this record, not counting the
+   *        parent records it shares.
+   *
+   * @return std::size_t
+   */
+  std::size_t memoryBytes() const;
+
+private:
+  explicit Provenance(Kind kind);
+
+  void appendName(StateId state, std::string &out) const;
+
+  Kind kind;
+  std::size_t stateCount;
+  /** the parent of a class or inserted provenance is left */
+  std::shared_ptr<const Provenance> left;
+  std::shared_ptr<const Provenance> right;
+  States_v names;
+  /** pairs of a product, members of a class */
+  std::vector<StateId> ids;
+  std::vector<uint32_t> memberStart;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_PROVENANCE */
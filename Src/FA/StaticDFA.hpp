@@ -0,0 +1,190 @@
+#ifndef CXXAUTOMATA_STATIC_DFA
+#define CXXAUTOMATA_STATIC_DFA
+
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <string>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief A DFA over single-character symbols whose states, alphabet and
+ *        transition table are fixed at compile time.
+ *
+ *        States are numbered 0, ..., StateCount - 1 and a transition of -1
+ *        means there is none (only allowed when allowPartial is set).
+ *        Declared constexpr, an invalid automaton is a compile error and
+ *        inputs can be matched in static_assert. Matching is a branch-free
+ *        walk over a table with an extra column for symbols outside the
+ *        alphabet and an extra row for the dead state.
+ *
+ *        constexpr StaticDFA<3, 2> dfa({'0', '1'},
+ *                                      {{0, 1}, {0, 2}, {2, 1}},
+ *                                      {false, true, false}, 0);
+ *        static_assert(dfa.acceptsInput("0111"), "");
+ */
+template <std::size_t StateCount, std::size_t SymbolCount> class StaticDFA {
+  static_assert(StateCount > 0, "a StaticDFA needs at least one state");
+  static_assert(SymbolCount > 0, "a StaticDFA needs at least one symbol");
+  static_assert(SymbolCount <= 256, "symbols are single characters");
+  static_assert(StateCount < 65535, "states are indexed with 16 bits");
+
+public:
+  static constexpr int NO_TRANSITION = -1;
+
+  /**
+   * @brief Construct a new StaticDFA object. Throws (and so fails to
+   *        compile when evaluated as a constant) if it is invalid.
+   *
+   * @param symbols distinct input symbols
+   * @param transitions target of every state on every symbol, or -1
+   * @param finalStates
+   * @param initialState
+   * @param allowPartial
+   */
+  constexpr StaticDFA(const char (&symbols)[SymbolCount],
+                      const int (&transitions)[StateCount][SymbolCount],
+                      const bool (&finalStates)[StateCount], int initialState,
+                      bool allowPartial = false)
+      : symbols{}, symbolColumn{}, table{}, finalStates{}, initialState(0),
+        partial(false) {
+    for (std::size_t c = 0; c < 256; c++) {
+      symbolColumn[c] = SymbolCount;
+    }
+    for (std::size_t s = 0; s < SymbolCount; s++) {
+      auto c = static_cast<unsigned char>(symbols[s]);
+      if (symbolColumn[c] != SymbolCount) {
+        throw InvalidSymbolException("duplicate symbol " +
+                                     std::string(1, symbols[s]));
+      }
+      this->symbols[s] = symbols[s];
+      symbolColumn[c] = static_cast<unsigned short>(s);
+    }
+    for (std::size_t q = 0; q <= StateCount; q++) {
+      for (std::size_t s = 0; s <= SymbolCount; s++) {
+        table[q][s] = StateCount;
+      }
+    }
+    for (std::size_t q = 0; q < StateCount; q++) {
+      for (std::size_t s = 0; s < SymbolCount; s++) {
+        int end = transitions[q][s];
+        if (end == NO_TRANSITION) {
+          if (!allowPartial) {
+            throw MissingSymbolException("state " + std::to_string(q) +
+                                         " is missing a transition");
+          }
+          partial = true;
+          continue;
+        }
+        if (end < 0 || static_cast<std::size_t>(end) >= StateCount) {
+          throw InvalidStateException("invalid end state " +
+                                      std::to_string(end));
+        }
+        table[q][s] = static_cast<unsigned short>(end);
+      }
+      this->finalStates[q] = finalStates[q];
+    }
+    if (initialState < 0 ||
+        static_cast<std::size_t>(initialState) >= StateCount) {
+      throw InitialStateException("invalid initial state " +
+                                  std::to_string(initialState));
+    }
+    this->initialState = static_cast<unsigned short>(initialState);
+  }
+
+  /**
+   * @brief Return the state reached from state on symbol, or -1.
+   *
+   * @param state
+   * @param symbol
+   * @return int
+   */
+  constexpr int nextState(int state, char symbol) const {
+    unsigned short end =
+        table[state][symbolColumn[static_cast<unsigned char>(symbol)]];
+    return end == StateCount ? NO_TRANSITION : end;
+  }
+
+  /**
+   * @brief Return True if the given input is accepted.
+   *
+   * @param input
+   * @param length
+   * @return true
+   * @return false
+   */
+  constexpr bool acceptsInput(const char *input, std::size_t length) const {
+    unsigned short state = initialState;
+    for (std::size_t i = 0; i < length; i++) {
+      state = table[state][symbolColumn[static_cast<unsigned char>(input[i])]];
+    }
+    return finalStates[state];
+  }
+
+  template <std::size_t N>
+  constexpr bool acceptsInput(const char (&input)[N]) const {
+    return acceptsInput(input, N - 1);
+  }
+
+  bool acceptsInput(const std::string &input) const {
+    return acceptsInput(input.data(), input.size());
+  }
+
+  constexpr std::size_t getStateCount() const { return StateCount; }
+  constexpr std::size_t getSymbolCount() const { return SymbolCount; }
+  constexpr int getInitialState() const { return initialState; }
+  constexpr bool isFinal(int state) const { return finalStates[state]; }
+  constexpr bool getAllowPartial() const { return partial; }
+
+  /**
+   * @brief Return the equivalent runtime DFA. States are named 0, ..., n-1
+   *        and symbols are one-character strings.
+   *
+   * @return DFA
+   */
+  DFA toDFA() const {
+    States states;
+    InputSymbols inputSymbols;
+    Transitions transitions;
+    States finals;
+    for (std::size_t s = 0; s < SymbolCount; s++) {
+      inputSymbols.insert(std::string(1, symbols[s]));
+    }
+    for (std::size_t q = 0; q < StateCount; q++) {
+      auto name = std::to_string(q);
+      states.insert(name);
+      Paths &paths = transitions[name];
+      for (std::size_t s = 0; s < SymbolCount; s++) {
+        if (table[q][s] != StateCount) {
+          paths[std::string(1, symbols[s])] = std::to_string(table[q][s]);
+        }
+      }
+      if (finalStates[q]) {
+        finals.insert(name);
+      }
+    }
+    return DFA(std::move(states), std::move(inputSymbols),
+               std::move(transitions), std::to_string(initialState),
+               std::move(finals), partial);
+  }
+
+private:
+  char symbols[SymbolCount];
+  /** column of every character; SymbolCount for characters not in the
+      alphabet */
+  unsigned short symbolColumn[256];
+  /** row StateCount is the dead state, column SymbolCount leads to it */
+  unsigned short table[StateCount + 1][SymbolCount + 1];
+  bool finalStates[StateCount + 1];
+  unsigned short initialState;
+  bool partial;
+};
+
+template <std::size_t StateCount, std::size_t SymbolCount>
+constexpr int StaticDFA<StateCount, SymbolCount>::NO_TRANSITION;
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_STATIC_DFA */
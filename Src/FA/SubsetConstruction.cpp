@@ -0,0 +1,443 @@
+#include "SubsetConstruction.hpp"
+#include "Arena.hpp"
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include "Statistics.hpp"
+#include <algorithm>
+#include <deque>
+#include <string>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+/** Marks a transition that has not been computed yet. */
+const StateId UNEXPLORED = NO_STATE - 1;
+
+/** Per-state overhead of the subset map, as counted against the budget. */
+const std::size_t STATE_OVERHEAD = 64;
+
+void sortUnique(std::vector<StateId>::iterator begin,
+                std::vector<StateId> &subset) {
+  std::sort(begin, subset.end());
+  subset.erase(std::unique(begin, subset.end()), subset.end());
+}
+
+} // namespace
+
+std::size_t
+SubsetConstruction::SubsetHash::operator()(const Subset &subset) const {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (auto state : subset) {
+    hash = (hash ^ state) * 0x100000001b3ull;
+  }
+  return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+SubsetConstruction::SubsetConstruction(Kind kind,
+                                       const ConstructionBudget &budget,
+                                       const DFA &a, const DFA *b)
+    : kind(kind), budget(budget), bytes(0) {
+  InputSymbols alphabet = a.getInputSymbols();
+  if (b != nullptr) {
+    alphabet.insert(b->getInputSymbols().begin(),
+                    b->getInputSymbols().end());
+  }
+  symbols.assign(alphabet.begin(), alphabet.end());
+  operands.push_back(index(a));
+  if (b != nullptr) {
+    operands.push_back(index(*b));
+  }
+  for (auto &operand : operands) {
+    charge(operand.table.size() * sizeof(StateId) + operand.finals.size());
+  }
+}
+
+SubsetConstruction::Operand SubsetConstruction::index(const DFA &dfa) const {
+  DFA minimal = dfa.minify(false);
+  Arena arena;
+  IndexedDFA indexed = IndexedDFA::fromDFA(minimal, arena);
+  Operand operand;
+  operand.stateCount = indexed.getStateCount();
+  operand.initialState = indexed.getInitialState();
+  operand.finals.resize(operand.stateCount);
+  operand.table.assign(
+      static_cast<std::size_t>(operand.stateCount) * symbols.size(),
+      NO_STATE);
+  for (StateId state = 0; state < operand.stateCount; state++) {
+    operand.finals[state] = indexed.isFinal(state);
+  }
+  // Both alphabets are sorted, so the own symbol ids count up.
+  SymbolId own = 0;
+  for (auto &symbol : minimal.getInputSymbols()) {
+    std::size_t k =
+        std::lower_bound(symbols.begin(), symbols.end(), symbol) -
+        symbols.begin();
+    for (StateId state = 0; state < operand.stateCount; state++) {
+      operand.table[state * symbols.size() + k] = indexed.next(state, own);
+    }
+    own++;
+  }
+  return operand;
+}
+
+void SubsetConstruction::indexPredecessors(Operand &operand) {
+  std::size_t rows = operand.table.size();
+  operand.predecessorStart.assign(rows + 1, 0);
+  for (std::size_t row = 0; row < rows; row++) {
+    StateId target = operand.table[row];
+    if (target != NO_STATE) {
+      operand.predecessorStart[target * symbols.size() +
+                               row % symbols.size() + 1]++;
+    }
+  }
+  for (std::size_t row = 0; row < rows; row++) {
+    operand.predecessorStart[row + 1] += operand.predecessorStart[row];
+  }
+  operand.predecessors.resize(operand.predecessorStart[rows]);
+  std::vector<uint32_t> fill(operand.predecessorStart.begin(),
+                             operand.predecessorStart.end() - 1);
+  for (std::size_t row = 0; row < rows; row++) {
+    StateId target = operand.table[row];
+    if (target != NO_STATE) {
+      operand.predecessors[fill[target * symbols.size() +
+                                row % symbols.size()]++] =
+          static_cast<StateId>(row / symbols.size());
+    }
+  }
+  charge((operand.predecessorStart.size() + operand.predecessors.size()) *
+         sizeof(uint32_t));
+}
+
+std::vector<uint8_t> SubsetConstruction::pairsReachingFinals() {
+  const Operand &a = operands[0];
+  const Operand &b = operands[1];
+  std::size_t pairs = static_cast<std::size_t>(a.stateCount) * b.stateCount;
+  charge(pairs * (1 + sizeof(std::size_t)));
+  std::vector<uint8_t> reaching(pairs, 0);
+  std::deque<std::size_t> queue;
+  for (StateId x = 0; x < a.stateCount; x++) {
+    for (StateId y = 0; y < b.stateCount; y++) {
+      if (a.finals[x] && b.finals[y]) {
+        reaching[x * b.stateCount + y] = 1;
+        queue.push_back(x * b.stateCount + y);
+      }
+    }
+  }
+  // Backwards from the final pairs through pairs of predecessors
+  while (!queue.empty()) {
+    std::size_t pair = queue.front();
+    queue.pop_front();
+    std::size_t rowA = pair / b.stateCount * symbols.size();
+    std::size_t rowB = pair % b.stateCount * symbols.size();
+    for (std::size_t k = 0; k < symbols.size(); k++) {
+      for (uint32_t i = a.predecessorStart[rowA + k];
+           i < a.predecessorStart[rowA + k + 1]; i++) {
+        for (uint32_t j = b.predecessorStart[rowB + k];
+             j < b.predecessorStart[rowB + k + 1]; j++) {
+          std::size_t from = static_cast<std::size_t>(a.predecessors[i]) *
+                                 b.stateCount +
+                             b.predecessors[j];
+          if (!reaching[from]) {
+            reaching[from] = 1;
+            queue.push_back(from);
+          }
+        }
+      }
+    }
+  }
+  return reaching;
+}
+
+SubsetConstruction
+SubsetConstruction::concatenation(const DFA &a, const DFA &b,
+                                  const ConstructionBudget &budget) {
+  SubsetConstruction construction(CONCATENATION, budget, a, &b);
+  const Operand &left = construction.operands[0];
+  const Operand &right = construction.operands[1];
+  // The state of a, then the states of b started after a word of a
+  Subset initial(1, left.initialState);
+  if (left.finals[left.initialState]) {
+    initial.push_back(right.initialState);
+  }
+  construction.addState(initial);
+  return construction;
+}
+
+SubsetConstruction SubsetConstruction::star(const DFA &a,
+                                            const ConstructionBudget &budget) {
+  SubsetConstruction construction(STAR, budget, a, nullptr);
+  // A fresh final initial state, so that the empty word is accepted
+  // without making the initial state of a final.
+  construction.addState(Subset(1, NO_STATE));
+  return construction;
+}
+
+SubsetConstruction
+SubsetConstruction::reversal(const DFA &a, const ConstructionBudget &budget) {
+  SubsetConstruction construction(REVERSAL, budget, a, nullptr);
+  Operand &operand = construction.operands[0];
+  construction.indexPredecessors(operand);
+  Subset initial;
+  for (StateId state = 0; state < operand.stateCount; state++) {
+    if (operand.finals[state]) {
+      initial.push_back(state);
+    }
+  }
+  construction.addState(initial);
+  return construction;
+}
+
+SubsetConstruction
+SubsetConstruction::leftQuotient(const DFA &a, const DFA &b,
+                                 const ConstructionBudget &budget) {
+  SubsetConstruction construction(SUBSETS, budget, a, &b);
+  const Operand &left = construction.operands[0];
+  const Operand &right = construction.operands[1];
+  // Start in every state of a reached together with a final state of b.
+  std::size_t pairs =
+      static_cast<std::size_t>(left.stateCount) * right.stateCount;
+  construction.charge(pairs * (1 + sizeof(std::size_t)));
+  std::vector<uint8_t> seen(pairs, 0);
+  std::deque<std::size_t> queue;
+  seen[left.initialState * right.stateCount + right.initialState] = 1;
+  queue.push_back(left.initialState * right.stateCount + right.initialState);
+  Subset initial;
+  std::size_t symbolCount = construction.symbols.size();
+  while (!queue.empty()) {
+    std::size_t pair = queue.front();
+    queue.pop_front();
+    StateId x = static_cast<StateId>(pair / right.stateCount);
+    StateId y = static_cast<StateId>(pair % right.stateCount);
+    if (right.finals[y]) {
+      initial.push_back(x);
+    }
+    for (SymbolId k = 0; k < symbolCount; k++) {
+      StateId nextX = construction.next(left, x, k);
+      StateId nextY = construction.next(right, y, k);
+      if (nextX == NO_STATE || nextY == NO_STATE) {
+        continue;
+      }
+      std::size_t to =
+          static_cast<std::size_t>(nextX) * right.stateCount + nextY;
+      if (!seen[to]) {
+        seen[to] = 1;
+        queue.push_back(to);
+      }
+    }
+  }
+  sortUnique(initial.begin(), initial);
+  construction.addState(initial);
+  return construction;
+}
+
+SubsetConstruction
+SubsetConstruction::rightQuotient(const DFA &a, const DFA &b,
+                                  const ConstructionBudget &budget) {
+  SubsetConstruction construction(SUBSETS, budget, a, &b);
+  construction.indexPredecessors(construction.operands[0]);
+  construction.indexPredecessors(construction.operands[1]);
+  // A state of a becomes final if some word of b leads it to a final state.
+  std::vector<uint8_t> reaching = construction.pairsReachingFinals();
+  Operand &left = construction.operands[0];
+  const Operand &right = construction.operands[1];
+  for (StateId x = 0; x < left.stateCount; x++) {
+    left.finals[x] = reaching[x * right.stateCount + right.initialState];
+  }
+  construction.addState(Subset(1, left.initialState));
+  return construction;
+}
+
+void SubsetConstruction::step(const Subset &from, SymbolId symbol,
+                              Subset &to) const {
+  const Operand &first = operands[0];
+  to.clear();
+  switch (kind) {
+  case CONCATENATION: {
+    const Operand &second = operands[1];
+    StateId state =
+        from[0] == NO_STATE ? NO_STATE : next(first, from[0], symbol);
+    to.push_back(state);
+    for (std::size_t i = 1; i < from.size(); i++) {
+      StateId target = next(second, from[i], symbol);
+      if (target != NO_STATE) {
+        to.push_back(target);
+      }
+    }
+    if (state != NO_STATE && first.finals[state]) {
+      to.push_back(second.initialState);
+    }
+    sortUnique(to.begin() + 1, to);
+    break;
+  }
+  case STAR: {
+    bool fresh = from.size() == 1 && from[0] == NO_STATE;
+    const Subset start(1, first.initialState);
+    bool restart = false;
+    for (auto state : fresh ? start : from) {
+      StateId target = next(first, state, symbol);
+      if (target != NO_STATE) {
+        to.push_back(target);
+        restart = restart || first.finals[target];
+      }
+    }
+    // A word of a may end here and the next one begin.
+    if (restart) {
+      to.push_back(first.initialState);
+    }
+    sortUnique(to.begin(), to);
+    break;
+  }
+  case REVERSAL:
+    for (auto state : from) {
+      std::size_t row = state * symbols.size() + symbol;
+      to.insert(to.end(),
+                first.predecessors.begin() + first.predecessorStart[row],
+                first.predecessors.begin() + first.predecessorStart[row + 1]);
+    }
+    sortUnique(to.begin(), to);
+    break;
+  case SUBSETS:
+    for (auto state : from) {
+      StateId target = next(first, state, symbol);
+      if (target != NO_STATE) {
+        to.push_back(target);
+      }
+    }
+    sortUnique(to.begin(), to);
+    break;
+  }
+}
+
+bool SubsetConstruction::acceptsSubset(const Subset &subset) const {
+  const Operand &first = operands[0];
+  switch (kind) {
+  case CONCATENATION:
+    for (std::size_t i = 1; i < subset.size(); i++) {
+      if (operands[1].finals[subset[i]]) {
+        return true;
+      }
+    }
+    return false;
+  case STAR:
+    if (subset.size() == 1 && subset[0] == NO_STATE) {
+      return true;
+    }
+    break;
+  case REVERSAL:
+    return std::binary_search(subset.begin(), subset.end(),
+                              first.initialState);
+  case SUBSETS:
+    break;
+  }
+  for (auto state : subset) {
+    if (first.finals[state]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SubsetConstruction::isDead(const Subset &subset) const {
+  if (kind == CONCATENATION) {
+    return subset.size() == 1 && subset[0] == NO_STATE;
+  }
+  return subset.empty();
+}
+
+void SubsetConstruction::charge(std::size_t amount) {
+  bytes += amount;
+  if (budget.maxBytes != 0 && bytes > budget.maxBytes) {
+    throw BudgetExceededException("subset construction needs more than " +
+                                  std::to_string(budget.maxBytes) +
+                                  " bytes");
+  }
+}
+
+StateId SubsetConstruction::addState(const Subset &subset) {
+  auto found = ids.find(subset);
+  if (found != ids.end()) {
+    return found->second;
+  }
+  if (budget.maxStates != 0 && subsets.size() >= budget.maxStates) {
+    throw BudgetExceededException("subset construction needs more than " +
+                                  std::to_string(budget.maxStates) +
+                                  " states");
+  }
+  charge(2 * subset.size() * sizeof(StateId) +
+         symbols.size() * sizeof(StateId) + STATE_OVERHEAD);
+  CXXAUTOMATA_STATS_ADD(STATES_EXPLORED, 1);
+  StateId id = static_cast<StateId>(subsets.size());
+  subsets.push_back(subset);
+  ids.emplace(subset, id);
+  table.resize(table.size() + symbols.size(), UNEXPLORED);
+  finals.push_back(acceptsSubset(subset));
+  return id;
+}
+
+StateId SubsetConstruction::next(StateId state, SymbolId symbol) {
+  std::size_t row = static_cast<std::size_t>(state) * symbols.size() + symbol;
+  if (table[row] == UNEXPLORED) {
+    CXXAUTOMATA_STATS_ADD(TRANSITIONS_VISITED, subsets[state].size());
+    Subset target;
+    step(subsets[state], symbol, target);
+    table[row] = isDead(target) ? NO_STATE : addState(target);
+  }
+  return table[row];
+}
+
+bool SubsetConstruction::acceptsInput(const InputSymbols_v &input) {
+  StateId state = getInitialState();
+  for (auto &symbol : input) {
+    auto position = std::lower_bound(symbols.begin(), symbols.end(), symbol);
+    if (position == symbols.end() || *position != symbol) {
+      return false;
+    }
+    state = next(state, static_cast<SymbolId>(position - symbols.begin()));
+    if (state == NO_STATE) {
+      return false;
+    }
+  }
+  return isFinal(state);
+}
+
+DFA SubsetConstruction::toDFA(bool minimize) {
+  // States are appended while exploring, so the loop bound keeps growing.
+  for (StateId state = 0; state < subsets.size(); state++) {
+    for (SymbolId symbol = 0; symbol < symbols.size(); symbol++) {
+      next(state, symbol);
+    }
+  }
+
+  // The result is valid by construction and is not validated again.
+  DFA result;
+  result.inputSymbols.insert(symbols.begin(), symbols.end());
+  result.allowPartial = false;
+  States_v names;
+  names.reserve(subsets.size());
+  for (std::size_t i = 0; i < subsets.size(); i++) {
+    names.push_back(std::to_string(i));
+  }
+  for (std::size_t i = 0; i < subsets.size(); i++) {
+    result.states.insert(result.states.end(), names[i]);
+    if (finals[i]) {
+      result.finalStates.insert(names[i]);
+    }
+    Paths &paths = result.transitions[names[i]];
+    for (std::size_t k = 0; k < symbols.size(); k++) {
+      StateId target = table[i * symbols.size() + k];
+      if (target == NO_STATE) {
+        result.allowPartial = true;
+      } else {
+        paths.emplace_hint(paths.end(), symbols[k], names[target]);
+      }
+    }
+  }
+  result.initialState = names[getInitialState()];
+  if (!minimize) {
+    result.updateMemoryAccount();
+  }
+  return minimize ? result.minify(false) : result;
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,222 @@
+#ifndef CXXAUTOMATA_SUBSET_CONSTRUCTION
+#define CXXAUTOMATA_SUBSET_CONSTRUCTION
+
+#include "IndexedDFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+class DFA;
+
+/**
+ * @brief Limits on the automaton built by a subset construction. A limit
+ *        of 0 is no limit. Exceeding one throws BudgetExceededException.
+ *
+ */
+struct ConstructionBudget {
+  ConstructionBudget() : maxStates(0), maxBytes(0) {}
+  ConstructionBudget(std::size_t maxStates, std::size_t maxBytes)
+      : maxStates(maxStates), maxBytes(maxBytes) {}
+
+  /** states of the deterministic automaton */
+  std::size_t maxStates;
+  /** estimated bytes of its subsets and transition table */
+  std::size_t maxBytes;
+};
+
+/**
+ * @brief On-the-fly subset construction behind the DFA operations that are
+ *        not boolean: concatenation, Kleene star, reversal and quotients.
+ *
+ *        The operands are minimized and indexed over the union of their
+ *        alphabets, and every deterministic state is a subset of operand
+ *        states that is only created when a transition first reaches it,
+ *        so only reachable subsets are ever built. States can be explored
+ *        one transition at a time with next(), e.g. to match input without
+ *        building the whole automaton, or all at once with toDFA(), which
+ *        minimizes the result. The empty subset is the dead state and
+ *        becomes a missing transition. A construction is not synchronized.
+ */
+class SubsetConstruction {
+public:
+  /**
+   * @brief Words of a followed by words of b.
+   *
+   * @param a
+   * @param b
+   * @param budget
+   * @return SubsetConstruction
+   */
+  static SubsetConstruction concatenation(const DFA &a, const DFA &b,
+                                          const ConstructionBudget &budget);
+
+  /**
+   * @brief Any number of words of a, including none.
+   *
+   * @param a
+   * @param budget
+   * @return SubsetConstruction
+   */
+  static SubsetConstruction star(const DFA &a,
+                                 const ConstructionBudget &budget);
+
+  /**
+   * @brief The words of a spelled backwards.
+   *
+   * @param a
+   * @param budget
+   * @return SubsetConstruction
+   */
+  static SubsetConstruction reversal(const DFA &a,
+                                     const ConstructionBudget &budget);
+
+  /**
+   * @brief The words w such that uw is a word of a for some word u of b.
+   *
+   * @param a
+   * @param b
+   * @param budget
+   * @return SubsetConstruction
+   */
+  static SubsetConstruction leftQuotient(const DFA &a, const DFA &b,
+                                         const ConstructionBudget &budget);
+
+  /**
+   * @brief The words w such that wu is a word of a for some word u of b.
+   *
+   * @param a
+   * @param b
+   * @param budget
+   * @return SubsetConstruction
+   */
+  static SubsetConstruction rightQuotient(const DFA &a, const DFA &b,
+                                          const ConstructionBudget &budget);
+
+  StateId getInitialState() const { return 0; }
+
+  /**
+   * @brief Return the state reached from state on the symbol with index
+   *        symbol in getInputSymbols(), creating it on first use, or
+   *        NO_STATE for the dead state.
+   *
+   * @param state
+   * @param symbol
+   * @return StateId
+   */
+  StateId next(StateId state, SymbolId symbol);
+
+  bool isFinal(StateId state) const { return finals[state] != 0; }
+
+  /**
+   * @brief Return True if the input is accepted, creating only the states
+   *        it passes through.
+   *
+   * @param input
+   * @return true
+   * @return false
+   */
+  bool acceptsInput(const InputSymbols_v &input);
+
+  /**
+   * @brief Create every reachable state and return the automaton as a DFA,
+   *        minimized unless minimize is false. The states of an
+   *        unminimized result are named by creation order.
+   *
+   * @param minimize
+   * @return DFA
+   */
+  DFA toDFA(bool minimize = true);
+
+  /**
+   * @brief Return the number of states created so far.
+   *
+   * @return uint32_t
+   */
+  uint32_t getStateCount() const {
+    return static_cast<uint32_t>(subsets.size());
+  }
+  const InputSymbols_v &getInputSymbols() const { return symbols; }
+
+  /**
+   * @brief Return the estimated bytes used so far, as counted against the
+   *        budget.
+   *
+   * @return std::size_t
+   */
+  std::size_t getMemoryBytes() const { return bytes; }
+
+private:
+  enum Kind { CONCATENATION, STAR, REVERSAL, SUBSETS };
+
+  typedef std::vector<StateId> Subset;
+
+  struct SubsetHash {
+    std::size_t operator()(const Subset &subset) const;
+  };
+
+  /**
+   * @brief A minimized operand over the union alphabet. NO_STATE in table
+   *        is its dead state.
+   *
+   */
+  struct Operand {
+    uint32_t stateCount;
+    StateId initialState;
+    std::vector<StateId> table;
+    std::vector<uint8_t> finals;
+    /** predecessors on symbol k of state s, CSR over s * symbols + k */
+    std::vector<uint32_t> predecessorStart;
+    std::vector<StateId> predecessors;
+  };
+
+  SubsetConstruction(Kind kind, const ConstructionBudget &budget,
+                     const DFA &a, const DFA *b);
+
+  Operand index(const DFA &dfa) const;
+  StateId next(const Operand &operand, StateId state, SymbolId symbol) const {
+    return operand.table[static_cast<std::size_t>(state) * symbols.size() +
+                         symbol];
+  }
+
+  /**
+   * @brief Index the predecessors of every state of operand on every
+   *        symbol.
+   *
+   * @param operand
+   */
+  void indexPredecessors(Operand &operand);
+
+  /**
+   * @brief Return, for every pair of states of the operands, whether a pair
+   *        of final states is reachable from it by one word.
+   *
+   * @return std::vector<uint8_t> flags of pair a * stateCount(b) + b
+   */
+  std::vector<uint8_t> pairsReachingFinals();
+
+  void step(const Subset &from, SymbolId symbol, Subset &to) const;
+  bool acceptsSubset(const Subset &subset) const;
+  bool isDead(const Subset &subset) const;
+  StateId addState(const Subset &subset);
+  void charge(std::size_t amount);
+
+  Kind kind;
+  ConstructionBudget budget;
+  InputSymbols_v symbols;
+  std::vector<Operand> operands;
+
+  std::vector<Subset> subsets;
+  std::unordered_map<Subset, StateId, SubsetHash> ids;
+  /** transitions of the states, UNEXPLORED until computed */
+  std::vector<StateId> table;
+  std::vector<uint8_t> finals;
+  std::size_t bytes;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_SUBSET_CONSTRUCTION */
@@ -0,0 +1,42 @@
+#include "TraceRecorder.hpp"
+#include "Exceptions.hpp"
+
+namespace CXXAUTOMATA {
+
+TraceRecorder::TraceRecorder(Mode mode, std::size_t period)
+    : mode(mode), period(period), head(0), steps(0) {
+  if (mode != ALL && period == 0) {
+    throw AutomatonException("a trace needs a period or ring size above 0");
+  }
+}
+
+TraceRecorder TraceRecorder::all() { return TraceRecorder(ALL, 1); }
+
+TraceRecorder TraceRecorder::sampled(std::size_t every) {
+  return TraceRecorder(SAMPLED, every);
+}
+
+TraceRecorder TraceRecorder::last(std::size_t count) {
+  TraceRecorder recorder(LAST, count);
+  recorder.states.reserve(count);
+  recorder.positions.reserve(count);
+  return recorder;
+}
+
+std::vector<StateId> TraceRecorder::getStates() const {
+  std::vector<StateId> ordered;
+  ordered.reserve(states.size());
+  for (std::size_t i = 0; i < states.size(); i++) {
+    ordered.push_back(stateAt(i));
+  }
+  return ordered;
+}
+
+void TraceRecorder::clear() {
+  head = 0;
+  steps = 0;
+  states.clear();
+  positions.clear();
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,175 @@
+#ifndef CXXAUTOMATA_TRACE_RECORDER
+#define CXXAUTOMATA_TRACE_RECORDER
+
+#include "IndexedDFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Called by a trace after every symbol with the id of the state
+ *        entered, the position of the symbol in the input and the symbol.
+ */
+typedef std::function<void(StateId, std::size_t, const InputSymbol &)>
+    TraceVisitor;
+
+/**
+ * @brief Compact recorder of the states visited while tracing an input with
+ *        DFA::traceInput or CompiledDFA::trace.
+ *
+ *        A recorder keeps state ids, never names, in one of three modes:
+ *        every step, one step out of every n, or only the last n steps in a
+ *        ring buffer. The last two bound the memory of a trace whatever the
+ *        length of the input. Keeping every step costs one uint32_t per
+ *        symbol while the positions are implied, step i being at position
+ *        i. A recorder reused for another input without clear() keeps the
+ *        positions as well from then on.
+ */
+class TraceRecorder {
+public:
+  enum Mode { ALL, SAMPLED, LAST };
+
+  /**
+   * @brief Return a recorder keeping every step.
+   *
+   * @return TraceRecorder
+   */
+  static TraceRecorder all();
+
+  /**
+   * @brief Return a recorder keeping the steps at positions 0, every,
+   *        2 * every, ...
+   *
+   * @param every
+   * @return TraceRecorder
+   */
+  static TraceRecorder sampled(std::size_t every);
+
+  /**
+   * @brief Return a recorder keeping only the last count steps.
+   *
+   * @param count
+   * @return TraceRecorder
+   */
+  static TraceRecorder last(std::size_t count);
+
+  /**
+   * @brief Record that state was entered by reading the symbol at position.
+   *
+   * @param state
+   * @param position
+   */
+  void record(StateId state, std::size_t position) {
+    steps++;
+    switch (mode) {
+    case ALL:
+      if (!positions.empty() || position != states.size()) {
+        // Once a step is not at its index, the earlier implied positions
+        // are written out and every position is kept.
+        for (std::size_t i = positions.size(); i < states.size(); i++) {
+          positions.push_back(i);
+        }
+        positions.push_back(position);
+      }
+      states.push_back(state);
+      break;
+    case SAMPLED:
+      if (position % period == 0) {
+        states.push_back(state);
+        positions.push_back(position);
+      }
+      break;
+    case LAST:
+      if (states.size() < period) {
+        states.push_back(state);
+        positions.push_back(position);
+      } else {
+        states[head] = state;
+        positions[head] = position;
+        head = head + 1 == period ? 0 : head + 1;
+      }
+      break;
+    }
+  }
+
+  /**
+   * @brief Visitor form of record, for DFA::traceInput and
+   *        CompiledDFA::trace.
+   *
+   */
+  void operator()(StateId state, std::size_t position, const InputSymbol &) {
+    record(state, position);
+  }
+
+  /**
+   * @brief Return the number of steps kept.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const { return states.size(); }
+
+  /**
+   * @brief Return the state of the i-th kept step, oldest first.
+   *
+   * @param i
+   * @return StateId
+   */
+  StateId stateAt(std::size_t i) const { return states[slot(i)]; }
+
+  /**
+   * @brief Return the position of the i-th kept step, oldest first.
+   *
+   * @param i
+   * @return std::size_t
+   */
+  std::size_t positionAt(std::size_t i) const {
+    return mode == ALL && positions.empty() ? i : positions[slot(i)];
+  }
+
+  /**
+   * @brief Return the states of the kept steps, oldest first.
+   *
+   * @return std::vector<StateId>
+   */
+  std::vector<StateId> getStates() const;
+
+  /**
+   * @brief Return the number of steps recorded, kept or not.
+   *
+   * @return uint64_t
+   */
+  uint64_t getStepCount() const { return steps; }
+
+  Mode getMode() const { return mode; }
+
+  /**
+   * @brief Forget every step, keeping the mode.
+   *
+   */
+  void clear();
+
+private:
+  TraceRecorder(Mode mode, std::size_t period);
+
+  std::size_t slot(std::size_t i) const {
+    std::size_t slot = head + i;
+    return slot >= states.size() ? slot - states.size() : slot;
+  }
+
+  Mode mode;
+  /** sampling period, or ring size */
+  std::size_t period;
+  /** oldest slot of the ring */
+  std::size_t head;
+  uint64_t steps;
+  std::vector<StateId> states;
+  std::vector<std::size_t> positions;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_TRACE_RECORDER */
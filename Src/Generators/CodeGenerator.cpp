@@ -0,0 +1,376 @@
+#include "CodeGenerator.hpp"
+#include "Exceptions.hpp"
+#include <cctype>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+const int REJECT = -1;
+
+bool isIdentifier(const std::string &name) {
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+    return false;
+  }
+  for (char c : name) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Split "a::b" into its parts, all of which must be identifiers.
+ *
+ */
+std::vector<std::string> splitNamespace(const std::string &name) {
+  std::vector<std::string> parts;
+  if (name.empty()) {
+    return parts;
+  }
+  std::size_t start = 0;
+  while (true) {
+    std::size_t end = name.find("::", start);
+    parts.push_back(name.substr(start, end - start));
+    if (!isIdentifier(parts.back())) {
+      throw AutomatonException("invalid namespace " + name);
+    }
+    if (end == std::string::npos) {
+      return parts;
+    }
+    start = end + 2;
+  }
+}
+
+void writeStringLiteral(std::ostream &out, const std::string &str) {
+  static const char octal[] = "01234567";
+  out << '"';
+  for (char c : str) {
+    unsigned char byte = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\' || c == '?') {
+      out << '\\' << c;
+    } else if (byte < 0x20 || byte >= 0x7F) {
+      out << '\\' << octal[byte >> 6] << octal[(byte >> 3) & 7]
+          << octal[byte & 7];
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+/**
+ * @brief The DFA renumbered for code generation: the initial state is 0,
+ *        the other reachable states follow in breadth-first order, and
+ *        transitions into dead states are REJECT.
+ *
+ */
+struct MatcherTable {
+  std::vector<State> names;
+  std::vector<std::vector<int>> next;
+  std::vector<bool> finals;
+  bool singleCharacters;
+};
+
+MatcherTable buildTable(const DFA &dfa) {
+  const auto &symbols = dfa.getInputSymbols();
+  const auto &transitions = dfa.getTransitions();
+  MatcherTable table;
+  table.singleCharacters = true;
+  for (auto &symbol : symbols) {
+    table.singleCharacters = table.singleCharacters && symbol.size() == 1;
+  }
+
+  std::map<State, int> index;
+  index.emplace(dfa.getInitialState(), 0);
+  table.names.push_back(dfa.getInitialState());
+  for (std::size_t current = 0; current < table.names.size(); current++) {
+    auto paths = transitions.find(table.names[current]);
+    std::vector<int> row;
+    for (auto &symbol : symbols) {
+      int target = REJECT;
+      if (paths != transitions.end()) {
+        auto path = paths->second.find(symbol);
+        if (path != paths->second.end()) {
+          auto inserted = index.emplace(path->second, table.names.size());
+          if (inserted.second) {
+            table.names.push_back(path->second);
+          }
+          target = inserted.first->second;
+        }
+      }
+      row.push_back(target);
+    }
+    table.next.push_back(row);
+    table.finals.push_back(dfa.getFinalStates().count(table.names[current]) >
+                           0);
+  }
+
+  // Keep only transitions into states that can still reach a final state.
+  std::size_t count = table.names.size();
+  std::vector<bool> live(table.finals);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (std::size_t state = 0; state < count; state++) {
+      if (live[state]) {
+        continue;
+      }
+      for (int target : table.next[state]) {
+        if (target != REJECT && live[target]) {
+          live[state] = true;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+  for (auto &row : table.next) {
+    for (auto &target : row) {
+      if (target != REJECT && !live[target]) {
+        target = REJECT;
+      }
+    }
+  }
+  if (!live[0]) {
+    for (auto &target : table.next[0]) {
+      target = REJECT;
+    }
+  }
+  return table;
+}
+
+const char *indexType(std::size_t count) {
+  if (count < 0x80) {
+    return "std::int8_t";
+  }
+  if (count < 0x8000) {
+    return "std::int16_t";
+  }
+  return "std::int32_t";
+}
+
+void writeDirectRun(std::ostream &out, const MatcherTable &table,
+                    const std::string &name) {
+  std::vector<bool> targeted(table.names.size(), false);
+  for (auto &row : table.next) {
+    for (int target : row) {
+      if (target != REJECT) {
+        targeted[target] = true;
+      }
+    }
+  }
+  out << "template <typename Iterator, typename Column>\n"
+      << "inline bool " << name
+      << "_run(Iterator input, Iterator end, Column column) {\n";
+  for (std::size_t state = 0; state < table.names.size(); state++) {
+    bool reachable = state == 0 || targeted[state];
+    if (!reachable) {
+      continue;
+    }
+    out << "  // ";
+    writeStringLiteral(out, table.names[state]);
+    out << "\n";
+    if (targeted[state]) {
+      out << "state" << state << ":\n";
+    }
+    out << "  if (input == end) {\n"
+        << "    return " << (table.finals[state] ? "true" : "false") << ";\n"
+        << "  }\n";
+
+    std::map<int, std::vector<std::size_t>> byTarget;
+    const auto &row = table.next[state];
+    for (std::size_t symbol = 0; symbol < row.size(); symbol++) {
+      if (row[symbol] != REJECT) {
+        byTarget[row[symbol]].push_back(symbol);
+      }
+    }
+    if (byTarget.empty()) {
+      out << "  return false;\n";
+      continue;
+    }
+    out << "  switch (column(*input++)) {\n";
+    for (auto &target : byTarget) {
+      for (auto symbol : target.second) {
+        out << "  case " << symbol << ":\n";
+      }
+      out << "    goto state" << target.first << ";\n";
+    }
+    out << "  default:\n"
+        << "    return false;\n"
+        << "  }\n";
+  }
+  out << "}\n";
+}
+
+void writeTableRun(std::ostream &out, const MatcherTable &table,
+                   const std::string &name) {
+  std::size_t count = table.names.size();
+  std::size_t symbolCount = table.next[0].size();
+  out << "template <typename Iterator, typename Column>\n"
+      << "inline bool " << name
+      << "_run(Iterator input, Iterator end, Column column) {\n";
+  if (symbolCount > 0) {
+    out << "  // -1 rejects\n"
+        << "  static const " << indexType(count) << " next[" << count << "]["
+        << symbolCount << "] = {\n";
+    for (std::size_t state = 0; state < count; state++) {
+      out << "      {";
+      for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+        out << (symbol == 0 ? "" : ", ") << table.next[state][symbol];
+      }
+      out << "}, // ";
+      writeStringLiteral(out, table.names[state]);
+      out << "\n";
+    }
+    out << "  };\n";
+  }
+  out << "  static const bool finals[" << count << "] = {";
+  for (std::size_t state = 0; state < count; state++) {
+    out << (state == 0 ? "" : ", ") << (table.finals[state] ? "true" : "false");
+  }
+  out << "};\n"
+      << "  int state = 0;\n"
+      << "  while (input != end) {\n"
+      << "    int symbol = column(*input++);\n";
+  if (symbolCount > 0) {
+    out << "    if (symbol < 0 || symbol >= " << symbolCount << ") {\n"
+        << "      return false;\n"
+        << "    }\n"
+        << "    state = next[state][symbol];\n";
+  } else {
+    out << "    (void)symbol;\n"
+        << "    state = -1;\n";
+  }
+  out << "    if (state < 0) {\n"
+      << "      return false;\n"
+      << "    }\n"
+      << "  }\n"
+      << "  return finals[state];\n"
+      << "}\n";
+}
+
+void writeSymbolLookup(std::ostream &out, const DFA &dfa,
+                       const std::string &name) {
+  const auto &symbols = dfa.getInputSymbols();
+  out << "inline int " << name << "_symbol(const std::string &symbol) {\n";
+  if (symbols.empty()) {
+    out << "  (void)symbol;\n"
+        << "  return -1;\n"
+        << "}\n";
+    return;
+  }
+  out << "  static const std::string symbols[] = {\n";
+  for (auto &symbol : symbols) {
+    out << "      std::string(";
+    writeStringLiteral(out, symbol);
+    out << ", " << symbol.size() << "),\n";
+  }
+  out << "  };\n"
+      << "  auto found =\n"
+      << "      std::lower_bound(std::begin(symbols), std::end(symbols), "
+         "symbol);\n"
+      << "  if (found == std::end(symbols) || *found != symbol) {\n"
+      << "    return -1;\n"
+      << "  }\n"
+      << "  return static_cast<int>(found - std::begin(symbols));\n"
+      << "}\n";
+}
+
+void writeCharacterMatcher(std::ostream &out, const DFA &dfa,
+                           const std::string &name) {
+  std::vector<int> columns(256, -1);
+  int column = 0;
+  for (auto &symbol : dfa.getInputSymbols()) {
+    columns[static_cast<unsigned char>(symbol[0])] = column++;
+  }
+  out << "inline bool " << name
+      << "(const char *input, std::size_t length) {\n"
+      << "  static const std::int16_t columns[256] = {";
+  for (std::size_t c = 0; c < columns.size(); c++) {
+    out << (c % 16 == 0 ? "\n      " : " ") << columns[c] << ",";
+  }
+  out << "\n  };\n"
+      << "  return " << name << "_run(input, input + length, [](char c) {\n"
+      << "    return static_cast<int>(columns[static_cast<unsigned char>(c)]);"
+         "\n"
+      << "  });\n"
+      << "}\n";
+}
+
+} // namespace
+
+void writeCppMatcher(const DFA &dfa, std::ostream &out,
+                     const CodeGeneratorOptions &options) {
+  const std::string &name = options.functionName;
+  if (!isIdentifier(name)) {
+    throw AutomatonException("invalid function name " + name);
+  }
+  auto namespaces = splitNamespace(options.namespaceName);
+  auto table = buildTable(dfa);
+
+  std::string guard = "CXXAUTOMATA_GENERATED";
+  for (auto &part : namespaces) {
+    guard += "_" + part;
+  }
+  guard += "_" + name;
+  for (auto &c : guard) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  }
+
+  out << "// Generated by CXXAutomata from a DFA with " << table.names.size()
+      << " reachable states and " << dfa.getInputSymbols().size()
+      << " symbols.\n"
+      << "// Do not edit.\n"
+      << "#ifndef " << guard << "\n"
+      << "#define " << guard << "\n\n"
+      << "#include <algorithm>\n"
+      << "#include <cstddef>\n"
+      << "#include <cstdint>\n"
+      << "#include <iterator>\n"
+      << "#include <string>\n"
+      << "#include <vector>\n\n";
+  for (auto &part : namespaces) {
+    out << "namespace " << part << " {\n";
+  }
+  if (!namespaces.empty()) {
+    out << "\n";
+  }
+
+  writeSymbolLookup(out, dfa, name);
+  out << "\n";
+  if (options.style == CodeGeneratorOptions::DIRECT) {
+    writeDirectRun(out, table, name);
+  } else {
+    writeTableRun(out, table, name);
+  }
+  out << "\n"
+      << "inline bool " << name
+      << "_indices(const int *input, std::size_t length) {\n"
+      << "  return " << name
+      << "_run(input, input + length, [](int symbol) { return symbol; });\n"
+      << "}\n\n"
+      << "inline bool " << name
+      << "(const std::vector<std::string> &input) {\n"
+      << "  return " << name << "_run(input.begin(), input.end(), " << name
+      << "_symbol);\n"
+      << "}\n";
+  if (table.singleCharacters && !dfa.getInputSymbols().empty()) {
+    out << "\n";
+    writeCharacterMatcher(out, dfa, name);
+  }
+
+  if (!namespaces.empty()) {
+    out << "\n";
+  }
+  for (auto part = namespaces.rbegin(); part != namespaces.rend(); part++) {
+    out << "} // namespace " << *part << "\n";
+  }
+  out << "\n#endif\n";
+}
+
+} // namespace CXXAUTOMATA
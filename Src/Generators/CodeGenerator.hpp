@@ -0,0 +1,59 @@
+#ifndef CXXAUTOMATA_CODE_GENERATOR
+#define CXXAUTOMATA_CODE_GENERATOR
+
+#include "DFA.hpp"
+#include <ostream>
+#include <string>
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief Options of the generated matcher.
+ *
+ */
+struct CodeGeneratorOptions {
+  enum Style {
+    /** one label per state and a switch over the symbol, joined by goto */
+    DIRECT,
+    /** a loop over a constant transition table */
+    TABLE
+  };
+
+  CodeGeneratorOptions() : style(DIRECT), functionName("match") {}
+
+  Style style;
+  /** name of the matcher; must be a C++ identifier */
+  std::string functionName;
+  /** enclosing namespace, e.g. "app::lexer"; none if empty */
+  std::string namespaceName;
+};
+
+/**
+ * @brief Write a standalone, header-only C++ matcher equivalent to dfa.
+ *
+ * For a function name NAME the header defines, in the requested namespace:
+ *
+ *   int NAME_symbol(const std::string &symbol);
+ *   bool NAME_indices(const int *input, std::size_t length);
+ *   bool NAME(const std::vector<std::string> &input);
+ *
+ * where NAME_symbol returns the index of a symbol in the sorted alphabet
+ * or -1, and, if every symbol is a single character,
+ *
+ *   bool NAME(const char *input, std::size_t length);
+ *
+ * The initial state comes first and the others follow in breadth-first
+ * order. Transitions into states from which no final state is reachable
+ * reject at once. The output only depends on the standard library.
+ *
+ * @param dfa
+ * @param out
+ * @param options
+ */
+void writeCppMatcher(const DFA &dfa, std::ostream &out,
+                     const CodeGeneratorOptions &options =
+                         CodeGeneratorOptions());
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_CODE_GENERATOR */
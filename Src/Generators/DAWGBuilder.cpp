@@ -0,0 +1,236 @@
+#include "DAWGBuilder.hpp"
+#include "Exceptions.hpp"
+#include "RandomAutomata.hpp"
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+const uint32_t NO_ID = 0xFFFFFFFFu;
+
+inline void combine(std::size_t &seed, std::size_t value) {
+  seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+DAWGBuilder::DAWGBuilder()
+    : edgeBegin(1, 0), registry(16, NodeHash{this}, NodeEqual{this}),
+      path(1), pathLength(0), hasPrevious(false), wordCount(0) {
+  path[0].final = false;
+  for (auto &id : byteIds) {
+    id = NO_ID;
+  }
+}
+
+std::size_t DAWGBuilder::NodeHash::operator()(NodeId node) const {
+  std::size_t seed = builder->finals[node];
+  for (std::size_t i = builder->edgeBegin[node];
+       i < builder->edgeBegin[node + 1]; i++) {
+    combine(seed, builder->edges[i].symbol);
+    combine(seed, builder->edges[i].target);
+  }
+  return seed;
+}
+
+bool DAWGBuilder::NodeEqual::operator()(NodeId a, NodeId b) const {
+  if (builder->finals[a] != builder->finals[b]) {
+    return false;
+  }
+  std::size_t beginA = builder->edgeBegin[a];
+  std::size_t beginB = builder->edgeBegin[b];
+  std::size_t count = builder->edgeBegin[a + 1] - beginA;
+  if (builder->edgeBegin[b + 1] - beginB != count) {
+    return false;
+  }
+  for (std::size_t i = 0; i < count; i++) {
+    const Edge &x = builder->edges[beginA + i];
+    const Edge &y = builder->edges[beginB + i];
+    if (x.symbol != y.symbol || x.target != y.target) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DAWGBuilder::SymbolId DAWGBuilder::internSymbol(const InputSymbol &symbol) {
+  auto inserted = symbolIds.emplace(
+      symbol, static_cast<SymbolId>(symbolNames.size()));
+  if (inserted.second) {
+    symbolNames.push_back(symbol);
+  }
+  return inserted.first->second;
+}
+
+template <class Compare>
+void DAWGBuilder::checkOrder(std::size_t length, Compare compareAt) const {
+  if (!hasPrevious) {
+    return;
+  }
+  auto fail = [&]() {
+    std::stringstream msg;
+    msg << "word " << wordCount + 1
+        << " sorts before the previous word; words must be added in "
+           "sorted order";
+    throw AutomatonException(msg.str());
+  };
+  std::size_t common = std::min(length, previous.size());
+  for (std::size_t i = 0; i < common; i++) {
+    int order = compareAt(i);
+    if (order > 0) {
+      return;
+    }
+    if (order < 0) {
+      fail();
+    }
+  }
+  // An equal word is a repeat; a proper prefix sorts before the word.
+  if (length < previous.size()) {
+    fail();
+  }
+}
+
+void DAWGBuilder::add(const std::string &word) {
+  // Check before interning, so that a rejected word adds no symbols.
+  checkOrder(word.size(), [&](std::size_t i) {
+    return -symbolNames[previous[i]].compare(0, std::string::npos, &word[i],
+                                             1);
+  });
+  current.clear();
+  for (unsigned char byte : word) {
+    if (byteIds[byte] == NO_ID) {
+      byteIds[byte] = internSymbol(std::string(1, static_cast<char>(byte)));
+    }
+    current.push_back(byteIds[byte]);
+  }
+  addSymbols(current);
+}
+
+void DAWGBuilder::add(const InputSymbols_v &word) {
+  checkOrder(word.size(), [&](std::size_t i) {
+    return word[i].compare(symbolNames[previous[i]]);
+  });
+  current.clear();
+  for (auto &symbol : word) {
+    current.push_back(internSymbol(symbol));
+  }
+  addSymbols(current);
+}
+
+void DAWGBuilder::addSymbols(const std::vector<SymbolId> &word) {
+  std::size_t prefix = 0;
+  std::size_t common = std::min(word.size(), previous.size());
+  while (prefix < common && word[prefix] == previous[prefix]) {
+    prefix++;
+  }
+  if (hasPrevious && prefix == word.size() && prefix == previous.size()) {
+    return;
+  }
+  minimizePath(prefix);
+  if (path.size() <= word.size()) {
+    path.resize(word.size() + 1);
+  }
+  for (std::size_t i = prefix; i < word.size(); i++) {
+    Edge edge = {word[i], NO_ID};
+    path[i].edges.push_back(edge);
+    path[i + 1].final = false;
+    path[i + 1].edges.clear();
+  }
+  pathLength = word.size();
+  path[pathLength].final = true;
+  previous.assign(word.begin(), word.end());
+  hasPrevious = true;
+  wordCount++;
+}
+
+void DAWGBuilder::minimizePath(std::size_t depth) {
+  for (std::size_t i = pathLength; i > depth; i--) {
+    path[i - 1].edges.back().target = replaceOrRegister(path[i]);
+  }
+  pathLength = depth;
+}
+
+DAWGBuilder::NodeId DAWGBuilder::replaceOrRegister(const PathNode &node) {
+  // Append the node as a candidate and drop it again if it is a duplicate,
+  // so that the registry only ever holds states of the minimal automaton.
+  NodeId candidate = static_cast<NodeId>(finals.size());
+  finals.push_back(node.final);
+  edges.insert(edges.end(), node.edges.begin(), node.edges.end());
+  edgeBegin.push_back(edges.size());
+  auto inserted = registry.insert(candidate);
+  if (!inserted.second) {
+    edgeBegin.pop_back();
+    edges.resize(edgeBegin.back());
+    finals.pop_back();
+  }
+  return *inserted.first;
+}
+
+DFA DAWGBuilder::build() {
+  minimizePath(0);
+  NodeId root = replaceOrRegister(path[0]);
+
+  // Number the states breadth-first from the root
+  std::vector<NodeId> order(1, root);
+  std::vector<uint32_t> index(finals.size(), NO_ID);
+  index[root] = 0;
+  for (std::size_t i = 0; i < order.size(); i++) {
+    NodeId node = order[i];
+    for (std::size_t e = edgeBegin[node]; e < edgeBegin[node + 1]; e++) {
+      NodeId target = edges[e].target;
+      if (index[target] == NO_ID) {
+        index[target] = static_cast<uint32_t>(order.size());
+        order.push_back(target);
+      }
+    }
+  }
+
+  States_v names;
+  names.reserve(order.size());
+  for (std::size_t i = 0; i < order.size(); i++) {
+    names.push_back(RandomAutomatonGenerator::stateName(i, order.size()));
+  }
+  States states;
+  States finalStates;
+  Transitions transitions;
+  for (std::size_t i = 0; i < order.size(); i++) {
+    NodeId node = order[i];
+    states.insert(states.end(), names[i]);
+    if (finals[node]) {
+      finalStates.insert(finalStates.end(), names[i]);
+    }
+    // Edges were added in sorted symbol order
+    Paths &paths =
+        transitions.emplace_hint(transitions.end(), names[i], Paths())
+            ->second;
+    for (std::size_t e = edgeBegin[node]; e < edgeBegin[node + 1]; e++) {
+      paths.emplace_hint(paths.end(), symbolNames[edges[e].symbol],
+                         names[index[edges[e].target]]);
+    }
+  }
+  InputSymbols inputSymbols(symbolNames.begin(), symbolNames.end());
+
+  registry.clear();
+  finals.clear();
+  edgeBegin.assign(1, 0);
+  edges.clear();
+  path.assign(1, PathNode());
+  path[0].final = false;
+  pathLength = 0;
+  previous.clear();
+  hasPrevious = false;
+  wordCount = 0;
+  symbolNames.clear();
+  symbolIds.clear();
+  for (auto &id : byteIds) {
+    id = NO_ID;
+  }
+
+  return DFA(std::move(states), std::move(inputSymbols),
+             std::move(transitions), names[0], std::move(finalStates), true);
+}
+
+} // namespace CXXAUTOMATA
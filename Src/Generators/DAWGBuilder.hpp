@@ -0,0 +1,134 @@
+#ifndef CXXAUTOMATA_DAWG_BUILDER
+#define CXXAUTOMATA_DAWG_BUILDER
+
+#include "DFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace CXXAUTOMATA {
+/**
+ * @brief Incremental builder of the minimal acyclic DFA (DAWG) accepting a
+ *        finite list of words, after Daciuk, Mihov, Watson and Watson.
+ *
+ * Words must be added in lexicographic order of their symbols. Only the
+ * path of the last word is kept mutable; as soon as a word leaves a branch
+ * of it, the states of that branch are replaced by an equivalent state from
+ * a hash register, or registered themselves. Registered states are never
+ * modified again, so memory stays proportional to the minimal automaton
+ * plus the length of the longest word, never to the trie.
+ */
+class DAWGBuilder {
+public:
+  DAWGBuilder();
+  DAWGBuilder(const DAWGBuilder &) = delete;
+  DAWGBuilder &operator=(const DAWGBuilder &) = delete;
+
+  /**
+   * @brief Add a word in which every byte is a symbol. A word equal to the
+   *        previous one is ignored.
+   *
+   * @param word
+   * @throw AutomatonException if word sorts before the previous word
+   */
+  void add(const std::string &word);
+
+  /**
+   * @brief Add a word given as a sequence of symbols. A word equal to the
+   *        previous one is ignored.
+   *
+   * @param word
+   * @throw AutomatonException if word sorts before the previous word
+   */
+  void add(const InputSymbols_v &word);
+
+  /**
+   * @brief Return the minimal DFA accepting exactly the added words, and
+   *        start over with an empty builder. The DFA is partial; its states
+   *        are named q0, q1, ... in breadth-first order from the initial
+   *        state q0, zero-padded so that they sort in that order.
+   *
+   * @return DFA
+   */
+  DFA build();
+
+  /**
+   * @brief Return the number of distinct words added so far.
+   *
+   * @return std::size_t
+   */
+  std::size_t getWordCount() const { return wordCount; }
+
+  /**
+   * @brief Return the number of states currently held: the registered
+   *        states plus the path of the last word.
+   *
+   * @return std::size_t
+   */
+  std::size_t getStateCount() const {
+    return finals.size() + pathLength + 1;
+  }
+
+private:
+  typedef uint32_t SymbolId;
+  typedef uint32_t NodeId;
+
+  struct Edge {
+    SymbolId symbol;
+    NodeId target;
+  };
+
+  /** A state on the path of the last word, still open for new edges. */
+  struct PathNode {
+    bool final;
+    std::vector<Edge> edges;
+  };
+
+  struct NodeHash {
+    const DAWGBuilder *builder;
+    std::size_t operator()(NodeId node) const;
+  };
+
+  struct NodeEqual {
+    const DAWGBuilder *builder;
+    bool operator()(NodeId a, NodeId b) const;
+  };
+
+  SymbolId internSymbol(const InputSymbol &symbol);
+  /**
+   * @brief Throw if a word of length symbols sorts before the previous
+   *        word. compareAt(i) compares its i-th symbol with the name of
+   *        the previous word's i-th symbol, as std::string::compare.
+   *
+   */
+  template <class Compare>
+  void checkOrder(std::size_t length, Compare compareAt) const;
+  void addSymbols(const std::vector<SymbolId> &word);
+  void minimizePath(std::size_t depth);
+  NodeId replaceOrRegister(const PathNode &node);
+
+  // Registered states: node n has edges[edgeBegin[n] .. edgeBegin[n + 1])
+  std::vector<uint8_t> finals;
+  std::vector<std::size_t> edgeBegin;
+  std::vector<Edge> edges;
+  std::unordered_set<NodeId, NodeHash, NodeEqual> registry;
+
+  // path[0] is the initial state, path[i] the state after i symbols
+  std::vector<PathNode> path;
+  std::size_t pathLength;
+  std::vector<SymbolId> previous;
+  std::vector<SymbolId> current;
+  bool hasPrevious;
+  std::size_t wordCount;
+
+  InputSymbols_v symbolNames;
+  std::unordered_map<InputSymbol, SymbolId> symbolIds;
+  SymbolId byteIds[256];
+};
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_DAWG_BUILDER */
@@ -0,0 +1,158 @@
+#include "RandomAutomata.hpp"
+#include "Exceptions.hpp"
+#include <utility>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+std::string paddedName(char prefix, std::size_t index, std::size_t count) {
+  std::string digits = std::to_string(index);
+  std::size_t width = std::to_string(count > 0 ? count - 1 : 0).size();
+  std::string name(1, prefix);
+  name.append(width - digits.size(), '0');
+  name += digits;
+  return name;
+}
+
+} // namespace
+
+RandomAutomatonGenerator::RandomAutomatonGenerator(uint64_t seed)
+    : rng(seed) {}
+
+State RandomAutomatonGenerator::stateName(std::size_t index,
+                                          std::size_t stateCount) {
+  return paddedName('q', index, stateCount);
+}
+
+InputSymbol RandomAutomatonGenerator::symbolName(std::size_t index,
+                                                 std::size_t symbolCount) {
+  return paddedName('s', index, symbolCount);
+}
+
+States_v RandomAutomatonGenerator::makeNames(char prefix,
+                                             std::size_t count) const {
+  States_v names;
+  names.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    names.push_back(paddedName(prefix, i, count));
+  }
+  return names;
+}
+
+DFA RandomAutomatonGenerator::randomDFA(std::size_t stateCount,
+                                        std::size_t symbolCount,
+                                        double finalRatio, double density) {
+  if (stateCount == 0 || (symbolCount == 0 && stateCount > 1)) {
+    throw AutomatonException(
+        "an accessible DFA needs a state and, beyond one state, a symbol");
+  }
+  auto stateNames = makeNames('q', stateCount);
+  auto symbolNames = makeNames('s', symbolCount);
+
+  // targets[state * symbolCount + symbol], stateCount marks "no transition"
+  const std::size_t none = stateCount;
+  std::vector<std::size_t> targets(stateCount * symbolCount, none);
+  std::vector<std::size_t> freeSlots;
+  freeSlots.reserve(stateCount * symbolCount);
+  for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+    freeSlots.push_back(symbol);
+  }
+  for (std::size_t state = 1; state < stateCount; state++) {
+    std::uniform_int_distribution<std::size_t> pickSlot(0,
+                                                        freeSlots.size() - 1);
+    std::size_t i = pickSlot(rng);
+    targets[freeSlots[i]] = state;
+    freeSlots[i] = freeSlots.back();
+    freeSlots.pop_back();
+    for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+      freeSlots.push_back(state * symbolCount + symbol);
+    }
+  }
+  std::uniform_int_distribution<std::size_t> pickState(0, stateCount - 1);
+  std::bernoulli_distribution exists(density);
+  for (auto slot : freeSlots) {
+    if (exists(rng)) {
+      targets[slot] = pickState(rng);
+    }
+  }
+
+  std::bernoulli_distribution isFinal(finalRatio);
+  States states;
+  States finalStates;
+  Transitions transitions;
+  for (std::size_t state = 0; state < stateCount; state++) {
+    states.insert(states.end(), stateNames[state]);
+    if (isFinal(rng)) {
+      finalStates.insert(finalStates.end(), stateNames[state]);
+    }
+    Paths &paths =
+        transitions.emplace_hint(transitions.end(), stateNames[state], Paths())
+            ->second;
+    for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+      auto target = targets[state * symbolCount + symbol];
+      if (target != none) {
+        paths.emplace_hint(paths.end(), symbolNames[symbol],
+                           stateNames[target]);
+      }
+    }
+  }
+  InputSymbols inputSymbols(symbolNames.begin(), symbolNames.end());
+  bool partial = freeSlots.size() > 0 && density < 1.0;
+  return DFA(std::move(states), std::move(inputSymbols),
+             std::move(transitions), stateNames[0], std::move(finalStates),
+             partial);
+}
+
+NFA RandomAutomatonGenerator::randomNFA(std::size_t stateCount,
+                                        std::size_t symbolCount,
+                                        double finalRatio, double density,
+                                        double lambdaDensity) {
+  if (stateCount == 0) {
+    throw AutomatonException("an NFA needs at least one state");
+  }
+  auto stateNames = makeNames('q', stateCount);
+  auto symbolNames = makeNames('s', symbolCount);
+  std::uniform_int_distribution<std::size_t> pickState(0, stateCount - 1);
+  std::poisson_distribution<std::size_t> endCount(density);
+  std::poisson_distribution<std::size_t> lambdaCount(lambdaDensity);
+  std::bernoulli_distribution isFinal(finalRatio);
+
+  auto addEnds = [&](NFAPaths &paths, const InputSymbol &symbol,
+                     std::size_t count) {
+    if (count == 0) {
+      return;
+    }
+    States &ends = paths[symbol];
+    for (std::size_t i = 0; i < count; i++) {
+      ends.insert(stateNames[pickState(rng)]);
+    }
+  };
+
+  States states;
+  States finalStates;
+  NFATransitions transitions;
+  for (std::size_t state = 0; state < stateCount; state++) {
+    states.insert(states.end(), stateNames[state]);
+    if (isFinal(rng)) {
+      finalStates.insert(finalStates.end(), stateNames[state]);
+    }
+    NFAPaths paths;
+    if (lambdaDensity > 0) {
+      addEnds(paths, NFA::LAMBDA, lambdaCount(rng));
+    }
+    for (std::size_t symbol = 0; symbol < symbolCount; symbol++) {
+      addEnds(paths, symbolNames[symbol], endCount(rng));
+    }
+    if (!paths.empty()) {
+      transitions.emplace_hint(transitions.end(), stateNames[state],
+                               std::move(paths));
+    }
+  }
+  InputSymbols inputSymbols(symbolNames.begin(), symbolNames.end());
+  return NFA(std::move(states), std::move(inputSymbols),
+             std::move(transitions), stateNames[0], std::move(finalStates));
+}
+
+} // namespace CXXAUTOMATA
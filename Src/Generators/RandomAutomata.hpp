@@ -0,0 +1,84 @@
+#ifndef CXXAUTOMATA_RANDOM_AUTOMATA
+#define CXXAUTOMATA_RANDOM_AUTOMATA
+
+#include "DFA.hpp"
+#include "NFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace CXXAUTOMATA {
+/**
+ * @brief Seedable generator of random automata for stress and scaling
+ *        tests.
+ *
+ * States are named q0, q1, ... zero-padded to a common width, so that
+ * their names sort in the same order as their indexes; symbols are named
+ * s0, s1, ... in the same way. The same seed always yields the same
+ * automata.
+ */
+class RandomAutomatonGenerator {
+public:
+  explicit RandomAutomatonGenerator(uint64_t seed = 0);
+
+  /**
+   * @brief Return a random DFA in which every state is accessible.
+   *
+   *        A spanning tree is grown first: each new state is the target of
+   *        a transition drawn uniformly among the still unused transitions
+   *        of the states created before it. Every other transition exists
+   *        with probability density and then leads to a uniformly chosen
+   *        state. The result is partial unless density is 1.
+   *
+   * @param stateCount
+   * @param symbolCount
+   * @param finalRatio probability for each state to be final
+   * @param density probability for a non-tree transition to exist
+   * @return DFA
+   */
+  DFA randomDFA(std::size_t stateCount, std::size_t symbolCount,
+                double finalRatio = 0.5, double density = 1.0);
+
+  /**
+   * @brief Return a random NFA. For every state and symbol the number of
+   *        end states follows a Poisson distribution of mean density, and
+   *        each end state is chosen uniformly.
+   *
+   * @param stateCount
+   * @param symbolCount
+   * @param finalRatio probability for each state to be final
+   * @param density mean number of end states per state and symbol
+   * @param lambdaDensity mean number of lambda transitions per state
+   * @return NFA
+   */
+  NFA randomNFA(std::size_t stateCount, std::size_t symbolCount,
+                double finalRatio = 0.5, double density = 1.0,
+                double lambdaDensity = 0.0);
+
+  /**
+   * @brief Return the name given to the state with the given index.
+   *
+   * @param index
+   * @param stateCount
+   * @return State
+   */
+  static State stateName(std::size_t index, std::size_t stateCount);
+
+  /**
+   * @brief Return the name given to the symbol with the given index.
+   *
+   * @param index
+   * @param symbolCount
+   * @return InputSymbol
+   */
+  static InputSymbol symbolName(std::size_t index, std::size_t symbolCount);
+
+private:
+  States_v makeNames(char prefix, std::size_t count) const;
+
+  std::mt19937_64 rng;
+};
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_RANDOM_AUTOMATA */
@@ -0,0 +1,307 @@
+#include "WordGenerator.hpp"
+#include "Arena.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <utility>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+const uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+WordGenerator::WordGenerator(const DFA &dfa) : preparedLength(0) {
+  DFA minimal = dfa.minify(false);
+  symbols.assign(minimal.getInputSymbols().begin(),
+                 minimal.getInputSymbols().end());
+  Arena arena;
+  IndexedDFA indexed = IndexedDFA::fromDFA(minimal, arena);
+  stateCount = indexed.getStateCount();
+  initialState = indexed.getInitialState();
+  std::size_t symbolCount = symbols.size();
+  table.resize(static_cast<std::size_t>(stateCount) * symbolCount);
+  finals.resize(stateCount);
+  for (StateId state = 0; state < stateCount; state++) {
+    finals[state] = indexed.isFinal(state);
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      table[state * symbolCount + symbol] = indexed.next(state, symbol);
+    }
+  }
+
+  // Group the symbols of every state by successor.
+  successorStart.push_back(0);
+  std::vector<std::pair<StateId, SymbolId>> row;
+  for (StateId state = 0; state < stateCount; state++) {
+    row.clear();
+    for (SymbolId symbol = 0; symbol < symbolCount; symbol++) {
+      if (next(state, symbol) != NO_STATE) {
+        row.emplace_back(next(state, symbol), symbol);
+      }
+    }
+    std::sort(row.begin(), row.end());
+    for (std::size_t i = 0; i < row.size(); i++) {
+      if (i == 0 || row[i].first != row[i - 1].first) {
+        Successor successor = {
+            row[i].first, static_cast<uint32_t>(successorSymbols.size()), 0};
+        successors.push_back(successor);
+      }
+      successors.back().symbolCount++;
+      successorSymbols.push_back(row[i].second);
+    }
+    successorStart.push_back(static_cast<uint32_t>(successors.size()));
+  }
+
+  // Shortest distances to a final state, backwards from the final states
+  std::vector<uint32_t> predecessorStart(stateCount + 1, 0);
+  std::vector<StateId> predecessors(successors.size());
+  for (auto &successor : successors) {
+    predecessorStart[successor.target + 1]++;
+  }
+  for (StateId state = 0; state < stateCount; state++) {
+    predecessorStart[state + 1] += predecessorStart[state];
+  }
+  std::vector<uint32_t> fill(predecessorStart.begin(),
+                             predecessorStart.end() - 1);
+  for (StateId state = 0; state < stateCount; state++) {
+    for (uint32_t i = successorStart[state]; i < successorStart[state + 1];
+         i++) {
+      predecessors[fill[successors[i].target]++] = state;
+    }
+  }
+  distance.assign(stateCount, UNREACHABLE);
+  std::deque<StateId> queue;
+  for (StateId state = 0; state < stateCount; state++) {
+    if (finals[state]) {
+      distance[state] = 0;
+      queue.push_back(state);
+    }
+  }
+  while (!queue.empty()) {
+    StateId state = queue.front();
+    queue.pop_front();
+    for (uint32_t i = predecessorStart[state]; i < predecessorStart[state + 1];
+         i++) {
+      if (distance[predecessors[i]] == UNREACHABLE) {
+        distance[predecessors[i]] = distance[state] + 1;
+        queue.push_back(predecessors[i]);
+      }
+    }
+  }
+
+  // The language is finite if the states leading to a final state form no
+  // cycle: peel off the ones without live successors left.
+  std::vector<uint32_t> pending(stateCount, 0);
+  std::size_t live = 0;
+  for (StateId state = 0; state < stateCount; state++) {
+    if (distance[state] == UNREACHABLE) {
+      continue;
+    }
+    live++;
+    for (uint32_t i = successorStart[state]; i < successorStart[state + 1];
+         i++) {
+      pending[state] += distance[successors[i].target] != UNREACHABLE;
+    }
+    if (pending[state] == 0) {
+      queue.push_back(state);
+    }
+  }
+  std::size_t peeled = 0;
+  while (!queue.empty()) {
+    StateId state = queue.front();
+    queue.pop_front();
+    peeled++;
+    for (uint32_t i = predecessorStart[state]; i < predecessorStart[state + 1];
+         i++) {
+      if (--pending[predecessors[i]] == 0) {
+        queue.push_back(predecessors[i]);
+      }
+    }
+  }
+  finite = peeled == live;
+
+  // One word of length 0, 0.5 * 2^1, from every final state
+  counts.assign(stateCount, 0);
+  exponents.assign(stateCount, 0);
+  for (StateId state = 0; state < stateCount; state++) {
+    if (finals[state]) {
+      counts[state] = 0.5;
+      exponents[state] = 1;
+    }
+  }
+}
+
+bool WordGenerator::shortestWord(InputSymbols_v &word) const {
+  word.clear();
+  if (distance[initialState] == UNREACHABLE) {
+    return false;
+  }
+  StateId state = initialState;
+  while (distance[state] > 0) {
+    for (SymbolId symbol = 0; symbol < symbols.size(); symbol++) {
+      StateId target = next(state, symbol);
+      if (target != NO_STATE && distance[target] + 1 == distance[state]) {
+        word.push_back(symbols[symbol]);
+        state = target;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+void WordGenerator::appendWordsOfLength(
+    StateId state, std::size_t length,
+    const std::vector<std::vector<uint8_t>> &possible, std::size_t k,
+    InputSymbols_v &prefix, std::vector<InputSymbols_v> &out) const {
+  // Depth-first, with the next symbol to try at every depth
+  std::vector<std::pair<StateId, SymbolId>> path(1, std::make_pair(state, 0));
+  while (!path.empty() && out.size() < k) {
+    std::size_t remaining = length - (path.size() - 1);
+    if (remaining == 0) {
+      out.push_back(prefix);
+    } else {
+      auto &top = path.back();
+      bool descended = false;
+      while (top.second < symbols.size() && !descended) {
+        SymbolId symbol = top.second++;
+        StateId target = next(top.first, symbol);
+        if (target != NO_STATE && possible[remaining - 1][target]) {
+          prefix.push_back(symbols[symbol]);
+          path.emplace_back(target, 0);
+          descended = true;
+        }
+      }
+      if (descended) {
+        continue;
+      }
+    }
+    path.pop_back();
+    if (!path.empty()) {
+      prefix.pop_back();
+    }
+  }
+}
+
+std::vector<InputSymbols_v> WordGenerator::shortestWords(std::size_t k) const {
+  std::vector<InputSymbols_v> out;
+  if (k == 0 || distance[initialState] == UNREACHABLE) {
+    return out;
+  }
+  // possible[l][s]: some word of exactly l symbols leads s to a final state
+  std::vector<std::vector<uint8_t>> possible(1, finals);
+  InputSymbols_v prefix;
+  // A finite language has no word longer than the number of states.
+  for (std::size_t length = distance[initialState];
+       out.size() < k && (!finite || length < stateCount); length++) {
+    while (possible.size() <= length) {
+      const std::vector<uint8_t> &below = possible.back();
+      std::vector<uint8_t> level(stateCount, 0);
+      for (StateId state = 0; state < stateCount; state++) {
+        for (uint32_t i = successorStart[state];
+             i < successorStart[state + 1] && !level[state]; i++) {
+          level[state] = below[successors[i].target];
+        }
+      }
+      possible.push_back(std::move(level));
+    }
+    if (possible[length][initialState]) {
+      appendWordsOfLength(initialState, length, possible, k, prefix, out);
+    }
+  }
+  return out;
+}
+
+std::vector<InputSymbols_v>
+WordGenerator::lexicographicWords(std::size_t k,
+                                  std::size_t maxLength) const {
+  std::vector<InputSymbols_v> out;
+  if (k == 0 || distance[initialState] > maxLength) {
+    return out;
+  }
+  // Every state on the path can still reach a final state in time.
+  InputSymbols_v prefix;
+  std::vector<std::pair<StateId, SymbolId>> path(
+      1, std::make_pair(initialState, 0));
+  if (finals[initialState]) {
+    out.push_back(prefix);
+  }
+  while (!path.empty() && out.size() < k) {
+    auto &top = path.back();
+    bool descended = false;
+    while (top.second < symbols.size() && !descended) {
+      SymbolId symbol = top.second++;
+      StateId target = next(top.first, symbol);
+      if (target != NO_STATE && distance[target] != UNREACHABLE &&
+          path.size() + distance[target] <= maxLength) {
+        prefix.push_back(symbols[symbol]);
+        path.emplace_back(target, 0);
+        descended = true;
+        if (finals[target]) {
+          out.push_back(prefix);
+        }
+      }
+    }
+    if (!descended) {
+      path.pop_back();
+      if (!path.empty()) {
+        prefix.pop_back();
+      }
+    }
+  }
+  return out;
+}
+
+void WordGenerator::prepare(std::size_t maxLength) {
+  if (maxLength <= preparedLength) {
+    return;
+  }
+  // Move the rows apart to make room for the new lengths.
+  std::size_t oldStride = preparedLength + 1;
+  std::size_t stride = maxLength + 1;
+  counts.resize(stateCount * stride);
+  exponents.resize(stateCount * stride);
+  for (StateId state = stateCount; state-- > 0;) {
+    std::copy_backward(counts.begin() + state * oldStride,
+                       counts.begin() + (state + 1) * oldStride,
+                       counts.begin() + state * stride + oldStride);
+    std::copy_backward(exponents.begin() + state * oldStride,
+                       exponents.begin() + (state + 1) * oldStride,
+                       exponents.begin() + state * stride + oldStride);
+  }
+  for (std::size_t length = oldStride; length < stride; length++) {
+    for (StateId state = 0; state < stateCount; state++) {
+      // Add the successor counts on the scale of the largest one.
+      int32_t top = std::numeric_limits<int32_t>::min();
+      for (uint32_t i = successorStart[state]; i < successorStart[state + 1];
+           i++) {
+        std::size_t below = successors[i].target * stride + length - 1;
+        if (counts[below] > 0) {
+          top = std::max(top, exponents[below]);
+        }
+      }
+      std::size_t at = state * stride + length;
+      counts[at] = 0;
+      exponents[at] = 0;
+      if (top == std::numeric_limits<int32_t>::min()) {
+        continue;
+      }
+      double sum = 0;
+      for (uint32_t i = successorStart[state]; i < successorStart[state + 1];
+           i++) {
+        std::size_t below = successors[i].target * stride + length - 1;
+        sum += counts[below] * successors[i].symbolCount *
+               powerOfTwo(exponents[below] - top);
+      }
+      int shift;
+      counts[at] = std::frexp(sum, &shift);
+      exponents[at] = top + shift;
+    }
+  }
+  preparedLength = maxLength;
+}
+
+} // namespace CXXAUTOMATA
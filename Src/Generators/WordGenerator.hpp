@@ -0,0 +1,243 @@
+#ifndef CXXAUTOMATA_WORD_GENERATOR
+#define CXXAUTOMATA_WORD_GENERATOR
+
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include "IndexedDFA.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace CXXAUTOMATA {
+/**
+ * @brief Generator of words accepted by a DFA: the shortest ones, the first
+ *        ones in lexicographic order, and uniformly random ones of a given
+ *        length.
+ *
+ * The DFA is minimized and indexed once; symbols are ordered and numbered
+ * as in its sorted alphabet. Uniform sampling needs the number of accepted
+ * words of every length up to the longest one sampled, from every state,
+ * which prepare() computes in one pass over the transitions per length and
+ * stores in (length + 1) * states doubles and exponents, a row per state.
+ * Each count keeps its own binary exponent, so counts neither overflow on
+ * long words nor vanish next to much larger counts of the same length,
+ * and every non-zero count keeps 53 bits of precision. After that a
+ * sample of length n walks n transitions, choosing among the distinct
+ * successors of each state in proportion to their counts, and allocates
+ * nothing when symbol ids are requested. A prepared generator may be
+ * shared between threads that each use their own random engine.
+ */
+class WordGenerator {
+public:
+  explicit WordGenerator(const DFA &dfa);
+
+  /**
+   * @brief Return the shortest accepted word, the lexicographically first
+   *        one among those of the same length.
+   *
+   * @param word receives the word
+   * @return true
+   * @return false if the DFA accepts no word
+   */
+  bool shortestWord(InputSymbols_v &word) const;
+
+  /**
+   * @brief Return the first k accepted words ordered by length, then
+   *        lexicographically; fewer if the language is smaller.
+   *
+   * @param k
+   * @return std::vector<InputSymbols_v>
+   */
+  std::vector<InputSymbols_v> shortestWords(std::size_t k) const;
+
+  /**
+   * @brief Return the first k accepted words of at most maxLength symbols
+   *        in lexicographic order, a word before its extensions.
+   *
+   * @param k
+   * @param maxLength
+   * @return std::vector<InputSymbols_v>
+   */
+  std::vector<InputSymbols_v> lexicographicWords(std::size_t k,
+                                                 std::size_t maxLength) const;
+
+  /**
+   * @brief Compute the count tables for sampling words of up to maxLength
+   *        symbols. Tables for shorter lengths are kept.
+   *
+   * @param maxLength
+   */
+  void prepare(std::size_t maxLength);
+
+  std::size_t getPreparedLength() const { return preparedLength; }
+
+  /**
+   * @brief Return True if some word of the given length is accepted.
+   *
+   * @param length at most getPreparedLength()
+   * @return true
+   * @return false
+   */
+  bool hasWords(std::size_t length) const {
+    checkPrepared(length);
+    return counts[index(initialState, length)] > 0;
+  }
+
+  /**
+   * @brief Draw an accepted word of the given length uniformly at random,
+   *        as ids into getInputSymbols().
+   *
+   * @param length at most getPreparedLength()
+   * @param rng a random engine, such as std::mt19937_64
+   * @param word receives the word
+   * @return true
+   * @return false if no word of that length is accepted
+   */
+  template <class Rng>
+  bool sampleIds(std::size_t length, Rng &rng,
+                 std::vector<SymbolId> &word) const {
+    word.clear();
+    if (!hasWords(length)) {
+      return false;
+    }
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    StateId state = initialState;
+    for (std::size_t remaining = length; remaining > 0; remaining--) {
+      std::size_t at = index(state, remaining);
+      double draw = unit(rng) * counts[at];
+      const Successor *begin = &successors[successorStart[state]];
+      const Successor *end = &successors[successorStart[state + 1]];
+      const Successor *chosen = end - 1;
+      for (const Successor *i = begin; i != end; i++) {
+        std::size_t below = index(i->target, remaining - 1);
+        // The weight on the scale of the count of state
+        double weight = counts[below] * i->symbolCount *
+                        powerOfTwo(exponents[below] - exponents[at]);
+        if (draw < weight) {
+          chosen = i;
+          break;
+        }
+        draw -= weight;
+      }
+      // Rounding may leave the draw over the last successor that counts.
+      while (counts[index(chosen->target, remaining - 1)] == 0) {
+        chosen--;
+      }
+      uint32_t pick = chosen->symbolCount == 1
+                          ? 0
+                          : std::uniform_int_distribution<uint32_t>(
+                                0, chosen->symbolCount - 1)(rng);
+      word.push_back(successorSymbols[chosen->symbolStart + pick]);
+      state = chosen->target;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Same as sampleIds(length, rng, ids), returning the symbols.
+   *
+   * @param length
+   * @param rng
+   * @param word
+   * @return true
+   * @return false
+   */
+  template <class Rng>
+  bool sample(std::size_t length, Rng &rng, InputSymbols_v &word) const {
+    std::vector<SymbolId> ids;
+    word.clear();
+    if (!sampleIds(length, rng, ids)) {
+      return false;
+    }
+    for (auto id : ids) {
+      word.push_back(symbols[id]);
+    }
+    return true;
+  }
+
+  const InputSymbols_v &getInputSymbols() const { return symbols; }
+  uint32_t getStateCount() const { return stateCount; }
+
+private:
+  /**
+   * @brief A successor of a state and the symbols leading to it.
+   *
+   */
+  struct Successor {
+    StateId target;
+    uint32_t symbolStart;
+    uint32_t symbolCount;
+  };
+
+  /**
+   * @brief Return 2^shift for shift <= 0, or 0 below the normal doubles,
+   *        faster than std::ldexp.
+   *
+   */
+  static double powerOfTwo(int32_t shift) {
+    if (shift < -1022) {
+      return 0;
+    }
+    uint64_t bits = static_cast<uint64_t>(shift + 1023) << 52;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+
+  std::size_t index(StateId state, std::size_t length) const {
+    return state * (preparedLength + 1) + length;
+  }
+
+  StateId next(StateId state, SymbolId symbol) const {
+    return table[static_cast<std::size_t>(state) * symbols.size() + symbol];
+  }
+
+  void checkPrepared(std::size_t length) const {
+    if (length > preparedLength) {
+      throw AutomatonException("word length " + std::to_string(length) +
+                               " is longer than the prepared length " +
+                               std::to_string(preparedLength));
+    }
+  }
+
+  /**
+   * @brief Append to out, in lexicographic order, the words of exactly
+   *        length symbols leading from state to a final state, following
+   *        prefix, until out holds k words.
+   *
+   */
+  void appendWordsOfLength(StateId state, std::size_t length,
+                           const std::vector<std::vector<uint8_t>> &possible,
+                           std::size_t k, InputSymbols_v &prefix,
+                           std::vector<InputSymbols_v> &out) const;
+
+  InputSymbols_v symbols;
+  uint32_t stateCount;
+  StateId initialState;
+  std::vector<StateId> table;
+  std::vector<uint8_t> finals;
+  /** length of the shortest word from a state, UINT32_MAX if none */
+  std::vector<uint32_t> distance;
+  bool finite;
+
+  /** distinct successors of state s: successors[successorStart[s] ..] */
+  std::vector<uint32_t> successorStart;
+  std::vector<Successor> successors;
+  std::vector<SymbolId> successorSymbols;
+
+  /**
+   * the number of words of length l from state s is
+   * counts[i] * 2^exponents[i], at i = s * (preparedLength + 1) + l, so
+   * that a sample reads the counts of one state from one row; counts[i] is
+   * in [0.5, 1), or 0 if there are no such words
+   */
+  std::vector<double> counts;
+  std::vector<int32_t> exponents;
+  std::size_t preparedLength;
+};
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_WORD_GENERATOR */
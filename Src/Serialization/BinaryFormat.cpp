@@ -0,0 +1,220 @@
+#include "BinaryFormat.hpp"
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+BinaryChecksum::BinaryChecksum()
+    : hash(0xcbf29ce484222325ULL), pending(0), pendingBytes(0) {}
+
+void BinaryChecksum::mix(uint64_t word) {
+  hash ^= word;
+  hash *= 0x9E3779B97F4A7C15ULL;
+  hash ^= hash >> 32;
+}
+
+void BinaryChecksum::update(const void *data, std::size_t len) {
+  auto bytes = static_cast<const unsigned char *>(data);
+  while (len > 0 && pendingBytes != 0) {
+    pending |= static_cast<uint64_t>(*bytes) << (8 * pendingBytes);
+    bytes++;
+    len--;
+    if (++pendingBytes == 8) {
+      mix(pending);
+      pending = 0;
+      pendingBytes = 0;
+    }
+  }
+  while (len >= 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    mix(word);
+    bytes += 8;
+    len -= 8;
+  }
+  while (len > 0) {
+    pending |= static_cast<uint64_t>(*bytes) << (8 * pendingBytes);
+    pendingBytes++;
+    bytes++;
+    len--;
+  }
+}
+
+uint64_t BinaryChecksum::digest() const {
+  if (pendingBytes == 0) {
+    return hash;
+  }
+  BinaryChecksum copy = *this;
+  copy.mix(copy.pending);
+  return copy.hash;
+}
+
+namespace {
+
+uint64_t alignUp(uint64_t offset, uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Sequential writer that tracks the offset and the checksum of the
+ * payload written after the header.
+ *
+ */
+class SectionWriter {
+public:
+  SectionWriter(std::ostream &out, uint64_t offset)
+      : out(out), offset(offset) {}
+
+  void write(const void *data, std::size_t len) {
+    out.write(static_cast<const char *>(data), len);
+    checksum.update(data, len);
+    offset += len;
+  }
+
+  void padTo(uint64_t target) {
+    static const char zeros[BINARY_SECTION_ALIGNMENT] = {};
+    while (offset < target) {
+      auto len = std::min<uint64_t>(target - offset, sizeof(zeros));
+      write(zeros, len);
+    }
+  }
+
+  template <typename Container>
+  void writeStrings(const Container &names, uint64_t indexOffset,
+                    uint64_t blobOffset) {
+    padTo(indexOffset);
+    uint64_t position = 0;
+    write(&position, sizeof(position));
+    for (auto &name : names) {
+      position += name.size();
+      write(&position, sizeof(position));
+    }
+    padTo(blobOffset);
+    for (auto &name : names) {
+      write(name.data(), name.size());
+    }
+  }
+
+  uint64_t getOffset() const { return offset; }
+  uint64_t digest() const { return checksum.digest(); }
+
+private:
+  std::ostream &out;
+  uint64_t offset;
+  BinaryChecksum checksum;
+};
+
+template <typename Container> uint64_t blobSize(const Container &names) {
+  uint64_t size = 0;
+  for (auto &name : names) {
+    size += name.size();
+  }
+  return size;
+}
+
+} // namespace
+
+void writeBinaryDFA(const DFA &dfa, std::ostream &out) {
+  const States &states = dfa.getStates();
+  const InputSymbols &inputSymbols = dfa.getInputSymbols();
+  const Transitions &transitions = dfa.getTransitions();
+  if (states.size() >= BINARY_NO_TRANSITION ||
+      inputSymbols.size() >= BINARY_NO_TRANSITION) {
+    throw SerializationException("DFA is too large for the binary format");
+  }
+
+  std::unordered_map<State, uint32_t> stateIds;
+  stateIds.reserve(states.size());
+  for (auto &state : states) {
+    stateIds.emplace(state, static_cast<uint32_t>(stateIds.size()));
+  }
+  std::unordered_map<InputSymbol, uint32_t> symbolIds;
+  symbolIds.reserve(inputSymbols.size());
+  for (auto &symbol : inputSymbols) {
+    symbolIds.emplace(symbol, static_cast<uint32_t>(symbolIds.size()));
+  }
+
+  BinaryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+  header.version = BINARY_VERSION;
+  header.endianMark = BINARY_ENDIAN_MARK;
+  header.stateCount = static_cast<uint32_t>(states.size());
+  header.symbolCount = static_cast<uint32_t>(inputSymbols.size());
+  header.initialState = stateIds.at(dfa.getInitialState());
+  header.flags = dfa.getAllowPartial() ? BINARY_FLAG_PARTIAL : 0;
+
+  const uint64_t a = BINARY_SECTION_ALIGNMENT;
+  const uint64_t finalWords = (states.size() + 63) / 64;
+  header.symbolIndexOffset = alignUp(sizeof(BinaryHeader), a);
+  header.symbolBlobOffset = alignUp(
+      header.symbolIndexOffset + (inputSymbols.size() + 1) * sizeof(uint64_t),
+      a);
+  header.stateIndexOffset =
+      alignUp(header.symbolBlobOffset + blobSize(inputSymbols), a);
+  header.stateBlobOffset = alignUp(
+      header.stateIndexOffset + (states.size() + 1) * sizeof(uint64_t), a);
+  header.tableOffset = alignUp(header.stateBlobOffset + blobSize(states), a);
+  header.finalOffset =
+      alignUp(header.tableOffset + static_cast<uint64_t>(states.size()) *
+                                       inputSymbols.size() * sizeof(uint32_t),
+              a);
+  header.fileSize = header.finalOffset + finalWords * sizeof(uint64_t);
+
+  auto start = out.tellp();
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  SectionWriter writer(out, sizeof(header));
+  writer.writeStrings(inputSymbols, header.symbolIndexOffset,
+                      header.symbolBlobOffset);
+  writer.writeStrings(states, header.stateIndexOffset, header.stateBlobOffset);
+
+  writer.padTo(header.tableOffset);
+  std::vector<uint32_t> row(inputSymbols.size());
+  for (auto &state : states) {
+    std::fill(row.begin(), row.end(), BINARY_NO_TRANSITION);
+    auto transition = transitions.find(state);
+    if (transition != transitions.end()) {
+      for (auto &path : transition->second) {
+        row[symbolIds.at(path.first)] = stateIds.at(path.second);
+      }
+    }
+    writer.write(row.data(), row.size() * sizeof(uint32_t));
+  }
+
+  writer.padTo(header.finalOffset);
+  const States &finalStates = dfa.getFinalStates();
+  std::vector<uint64_t> finals(finalWords, 0);
+  for (auto &state : finalStates) {
+    auto id = stateIds.at(state);
+    finals[id / 64] |= uint64_t(1) << (id % 64);
+  }
+  writer.write(finals.data(), finals.size() * sizeof(uint64_t));
+
+  header.checksum = writer.digest();
+  out.seekp(start);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.seekp(start + static_cast<std::streamoff>(header.fileSize));
+  if (!out) {
+    throw SerializationException(
+        "failed to write DFA, the output stream must be seekable");
+  }
+}
+
+void saveBinaryDFA(const DFA &dfa, const std::string &path) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw SerializationException("cannot open " + path + " for writing");
+  }
+  writeBinaryDFA(dfa, file);
+  file.close();
+  if (!file) {
+    throw SerializationException("failed to write " + path);
+  }
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,105 @@
+#ifndef CXXAUTOMATA_BINARY_FORMAT
+#define CXXAUTOMATA_BINARY_FORMAT
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace CXXAUTOMATA {
+class DFA;
+
+/**
+ * @brief On-disk layout of a compiled DFA.
+ *
+ * The file starts with a BinaryHeader followed by sections, each aligned to
+ * BINARY_SECTION_ALIGNMENT bytes so that they can be used in place once the
+ * file is memory mapped:
+ *  - symbol index: uint64_t[symbolCount + 1] offsets into the symbol blob
+ *  - symbol blob: the symbol names, sorted, without terminators
+ *  - state index: uint64_t[stateCount + 1] offsets into the state blob
+ *  - state blob: the state names, sorted, without terminators
+ *  - table: uint32_t[stateCount * symbolCount], row-major by state,
+ *    BINARY_NO_TRANSITION where a partial DFA has no transition
+ *  - finals: uint64_t[(stateCount + 63) / 64] bitmap of final states
+ *
+ * The checksum covers every byte after the header and the total file size
+ * is always a multiple of 8 bytes. Integers are stored in host byte order;
+ * endianMark lets a reader reject a file produced on another architecture.
+ */
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t endianMark;
+  uint32_t stateCount;
+  uint32_t symbolCount;
+  uint32_t initialState;
+  uint32_t flags;
+  uint64_t symbolIndexOffset;
+  uint64_t symbolBlobOffset;
+  uint64_t stateIndexOffset;
+  uint64_t stateBlobOffset;
+  uint64_t tableOffset;
+  uint64_t finalOffset;
+  uint64_t fileSize;
+  uint64_t checksum;
+};
+
+static const char BINARY_MAGIC[8] = {'C', 'X', 'X', 'A', 'D', 'F', 'A', '\0'};
+static const uint32_t BINARY_VERSION = 1;
+static const uint32_t BINARY_ENDIAN_MARK = 0x01020304u;
+static const uint32_t BINARY_FLAG_PARTIAL = 0x1u;
+static const uint32_t BINARY_NO_TRANSITION = 0xFFFFFFFFu;
+static const std::size_t BINARY_SECTION_ALIGNMENT = 64;
+
+/**
+ * @brief Incremental 64-bit checksum used by the binary format.
+ *
+ */
+class BinaryChecksum {
+public:
+  BinaryChecksum();
+  /**
+   * @brief Feed len bytes starting at data into the checksum.
+   *
+   * @param data
+   * @param len
+   */
+  void update(const void *data, std::size_t len);
+  /**
+   * @brief Return the checksum of all bytes fed so far.
+   *
+   * @return uint64_t
+   */
+  uint64_t digest() const;
+
+private:
+  void mix(uint64_t word);
+
+  uint64_t hash;
+  uint64_t pending;
+  unsigned pendingBytes;
+};
+
+/**
+ * @brief Write the given DFA to a seekable stream in the binary format.
+ *
+ * Rows are produced one state at a time, so the extra memory needed is
+ * proportional to the number of states and symbols, not to the table.
+ *
+ * @param dfa
+ * @param out
+ */
+void writeBinaryDFA(const DFA &dfa, std::ostream &out);
+
+/**
+ * @brief Write the given DFA to the file at path in the binary format.
+ *
+ * @param dfa
+ * @param path
+ */
+void saveBinaryDFA(const DFA &dfa, const std::string &path);
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_BINARY_FORMAT */
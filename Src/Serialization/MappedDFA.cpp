@@ -0,0 +1,254 @@
+#include "MappedDFA.hpp"
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CXXAUTOMATA {
+
+MappedDFA::MappedDFA(const std::string &path, bool verifyChecksum)
+    : path(path), data(nullptr), size(0), header(nullptr), table(nullptr),
+      finals(nullptr), stateCount(0), symbolCount(0), initialState(0) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw SerializationException("cannot open " + path);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(BinaryHeader)) {
+    close(fd);
+    throw SerializationException(path + " is not a binary DFA");
+  }
+  size = static_cast<std::size_t>(info.st_size);
+  void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    throw SerializationException("cannot map " + path);
+  }
+  data = static_cast<const unsigned char *>(mapped);
+  header = reinterpret_cast<const BinaryHeader *>(data);
+
+  try {
+    checkLayout();
+    if (verifyChecksum) {
+      checkChecksum();
+    }
+  } catch (...) {
+    munmap(const_cast<unsigned char *>(data), size);
+    throw;
+  }
+  stateCount = header->stateCount;
+  symbolCount = header->symbolCount;
+  initialState = header->initialState;
+  table = reinterpret_cast<const uint32_t *>(data + header->tableOffset);
+  finals = reinterpret_cast<const uint64_t *>(data + header->finalOffset);
+}
+
+MappedDFA::~MappedDFA() {
+  if (data != nullptr) {
+    munmap(const_cast<unsigned char *>(data), size);
+  }
+}
+
+void MappedDFA::checkLayout() const {
+  auto fail = [&](const std::string &reason) {
+    throw SerializationException(path + ": " + reason);
+  };
+  if (std::memcmp(header->magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+    fail("not a binary DFA");
+  }
+  if (header->version != BINARY_VERSION) {
+    std::stringstream ss;
+    ss << "unsupported format version " << header->version;
+    fail(ss.str());
+  }
+  if (header->endianMark != BINARY_ENDIAN_MARK) {
+    fail("file was written with a different byte order");
+  }
+  if (header->fileSize != size) {
+    fail("file is truncated");
+  }
+  if (header->stateCount == 0 || header->initialState >= header->stateCount) {
+    fail("invalid initial state");
+  }
+  const uint64_t offsets[] = {header->symbolIndexOffset,
+                              header->symbolBlobOffset,
+                              header->stateIndexOffset,
+                              header->stateBlobOffset,
+                              header->tableOffset,
+                              header->finalOffset,
+                              header->fileSize};
+  uint64_t previous = sizeof(BinaryHeader);
+  for (auto offset : offsets) {
+    if (offset < previous || offset % sizeof(uint64_t) != 0) {
+      fail("corrupted section table");
+    }
+    previous = offset;
+  }
+  const uint64_t stateCount = header->stateCount;
+  const uint64_t symbolCount = header->symbolCount;
+  // Compares count * size against the section by division, so that a
+  // forged count cannot overflow the product.
+  auto fits = [&](uint64_t begin, uint64_t end, uint64_t count,
+                  uint64_t size) { return count <= (end - begin) / size; };
+  if (!fits(header->symbolIndexOffset, header->symbolBlobOffset,
+            symbolCount + 1, sizeof(uint64_t)) ||
+      !fits(header->stateIndexOffset, header->stateBlobOffset,
+            stateCount + 1, sizeof(uint64_t)) ||
+      (symbolCount != 0 &&
+       !fits(header->tableOffset, header->finalOffset, stateCount,
+             symbolCount * sizeof(uint32_t))) ||
+      !fits(header->finalOffset, header->fileSize, (stateCount + 63) / 64,
+            sizeof(uint64_t))) {
+    fail("corrupted section sizes");
+  }
+  auto symbolIndex =
+      reinterpret_cast<const uint64_t *>(data + header->symbolIndexOffset);
+  auto stateIndex =
+      reinterpret_cast<const uint64_t *>(data + header->stateIndexOffset);
+  if (symbolIndex[symbolCount] >
+          header->stateIndexOffset - header->symbolBlobOffset ||
+      stateIndex[stateCount] > header->tableOffset - header->stateBlobOffset) {
+    fail("corrupted name tables");
+  }
+}
+
+void MappedDFA::checkChecksum() const {
+  BinaryChecksum checksum;
+  checksum.update(data + sizeof(BinaryHeader), size - sizeof(BinaryHeader));
+  if (checksum.digest() != header->checksum) {
+    throw SerializationException(path + ": checksum mismatch");
+  }
+}
+
+std::string MappedDFA::readName(uint64_t indexOffset, uint64_t blobOffset,
+                                uint64_t blobEnd, uint32_t id) const {
+  auto index = reinterpret_cast<const uint64_t *>(data + indexOffset);
+  uint64_t begin = index[id];
+  uint64_t end = index[id + 1];
+  if (begin > end || end > blobEnd - blobOffset) {
+    throw SerializationException(path + ": corrupted name tables");
+  }
+  return std::string(reinterpret_cast<const char *>(data + blobOffset + begin),
+                     end - begin);
+}
+
+State MappedDFA::getStateName(uint32_t state) const {
+  return readName(header->stateIndexOffset, header->stateBlobOffset,
+                  header->tableOffset, state);
+}
+
+InputSymbol MappedDFA::getSymbolName(uint32_t symbol) const {
+  return readName(header->symbolIndexOffset, header->symbolBlobOffset,
+                  header->stateIndexOffset, symbol);
+}
+
+uint32_t MappedDFA::findSymbol(const InputSymbol &symbol) const {
+  auto index =
+      reinterpret_cast<const uint64_t *>(data + header->symbolIndexOffset);
+  auto blob =
+      reinterpret_cast<const char *>(data + header->symbolBlobOffset);
+  uint64_t blobSize = header->stateIndexOffset - header->symbolBlobOffset;
+  // Symbols are stored in the order of InputSymbols, so a binary search on
+  // the raw bytes finds them without building any lookup structure.
+  uint32_t low = 0;
+  uint32_t high = symbolCount;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    uint64_t begin = index[mid];
+    uint64_t end = index[mid + 1];
+    // Index entries are not checked when the file is opened.
+    if (begin > end || end > blobSize) {
+      throw SerializationException(path + ": corrupted name tables");
+    }
+    uint64_t len = end - begin;
+    int cmp = symbol.compare(0, symbol.size(), blob + begin, len);
+    if (cmp == 0) {
+      return mid;
+    } else if (cmp > 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return BINARY_NO_TRANSITION;
+}
+
+State MappedDFA::readInput(const InputSymbols_v &input_str) const {
+  uint32_t current = initialState;
+  for (auto &inputSymbol : input_str) {
+    uint32_t symbol = findSymbol(inputSymbol);
+    if (symbol == BINARY_NO_TRANSITION) {
+      std::stringstream ss;
+      ss << inputSymbol << " is not a valid input symbol";
+      throw RejectionException(ss.str());
+    }
+    uint32_t next = nextState(current, symbol);
+    if (next == BINARY_NO_TRANSITION) {
+      std::stringstream ss;
+      ss << "state " << getStateName(current) << " has no transition on "
+         << inputSymbol;
+      throw RejectionException(ss.str());
+    }
+    current = next;
+  }
+  if (!isFinal(current)) {
+    std::stringstream ss;
+    ss << "the DFA stopped on a non-final state " << getStateName(current);
+    throw RejectionException(ss.str());
+  }
+  return getStateName(current);
+}
+
+bool MappedDFA::acceptsInput(const InputSymbols_v &input_str) const {
+  uint32_t current = initialState;
+  for (auto &inputSymbol : input_str) {
+    uint32_t symbol = findSymbol(inputSymbol);
+    if (symbol == BINARY_NO_TRANSITION) {
+      return false;
+    }
+    current = nextState(current, symbol);
+    if (current == BINARY_NO_TRANSITION) {
+      return false;
+    }
+  }
+  return isFinal(current);
+}
+
+DFA MappedDFA::toDFA() const {
+  States_v stateNames;
+  stateNames.reserve(stateCount);
+  States states;
+  for (uint32_t state = 0; state < stateCount; state++) {
+    stateNames.push_back(getStateName(state));
+    states.insert(states.end(), stateNames.back());
+  }
+  InputSymbols_v symbolNames;
+  symbolNames.reserve(symbolCount);
+  InputSymbols inputSymbols;
+  for (uint32_t symbol = 0; symbol < symbolCount; symbol++) {
+    symbolNames.push_back(getSymbolName(symbol));
+    inputSymbols.insert(inputSymbols.end(), symbolNames.back());
+  }
+  Transitions transitions;
+  States finalStates;
+  for (uint32_t state = 0; state < stateCount; state++) {
+    Paths &paths = transitions[stateNames[state]];
+    for (uint32_t symbol = 0; symbol < symbolCount; symbol++) {
+      uint32_t next = nextState(state, symbol);
+      if (next != BINARY_NO_TRANSITION) {
+        paths.emplace_hint(paths.end(), symbolNames[symbol], stateNames[next]);
+      }
+    }
+    if (isFinal(state)) {
+      finalStates.insert(finalStates.end(), stateNames[state]);
+    }
+  }
+  return DFA(states, inputSymbols, transitions, stateNames[initialState],
+             finalStates, (header->flags & BINARY_FLAG_PARTIAL) != 0);
+}
+
+} // namespace CXXAUTOMATA
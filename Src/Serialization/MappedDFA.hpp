@@ -0,0 +1,131 @@
+#ifndef CXXAUTOMATA_MAPPED_DFA
+#define CXXAUTOMATA_MAPPED_DFA
+
+#include "BinaryFormat.hpp"
+#include "Typedefs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CXXAUTOMATA {
+class DFA;
+
+/**
+ * @brief A read-only DFA backed by a memory mapped file written by
+ *        saveBinaryDFA.
+ *
+ * Opening the file only checks the header and, optionally, the checksum.
+ * Matching walks the transition table directly in the mapped pages, so
+ * several processes mapping the same file share it through the page cache.
+ * A MappedDFA is immutable and may be used from several threads at once.
+ */
+class MappedDFA {
+public:
+  /**
+   * @brief Map the binary DFA stored at path.
+   *
+   * @param path
+   * @param verifyChecksum if true, the whole payload is read once to check
+   * that the file is not corrupted.
+   */
+  explicit MappedDFA(const std::string &path, bool verifyChecksum = true);
+  ~MappedDFA();
+
+  MappedDFA(const MappedDFA &) = delete;
+  MappedDFA &operator=(const MappedDFA &) = delete;
+
+  /**
+   * @brief Check if the given string is accepted by this DFA.
+   *        Return the DFA's final state if this string is valid.
+   *
+   * @param input_str
+   * @return State
+   */
+  State readInput(const InputSymbols_v &input_str) const;
+
+  /**
+   * @brief validate input to the DFA
+   *
+   * @param input_str
+   * @return true if this DFA accepts the given input.
+   * @return false otherwise
+   */
+  bool acceptsInput(const InputSymbols_v &input_str) const;
+
+  /**
+   * @brief Follow the transition on the given symbol index.
+   *
+   * @param state
+   * @param symbol
+   * @return uint32_t the next state, or BINARY_NO_TRANSITION
+   */
+  uint32_t nextState(uint32_t state, uint32_t symbol) const {
+    uint32_t next = table[static_cast<uint64_t>(state) * symbolCount + symbol];
+    return next < stateCount ? next : BINARY_NO_TRANSITION;
+  }
+
+  /**
+   * @brief Return the index of the given symbol, or BINARY_NO_TRANSITION if
+   *        it is not part of the alphabet.
+   *
+   * @param symbol
+   * @return uint32_t
+   * @throw SerializationException if the symbol index is corrupted
+   */
+  uint32_t findSymbol(const InputSymbol &symbol) const;
+
+  /**
+   * @brief Return True if the state with the given index is final.
+   *
+   * @param state
+   * @return true
+   * @return false
+   */
+  bool isFinal(uint32_t state) const {
+    return (finals[state / 64] >> (state % 64)) & 1;
+  }
+
+  uint32_t getStateCount() const { return stateCount; }
+  uint32_t getSymbolCount() const { return symbolCount; }
+  uint32_t getInitialState() const { return initialState; }
+  State getStateName(uint32_t state) const;
+  InputSymbol getSymbolName(uint32_t symbol) const;
+
+  /**
+   * @brief Rebuild a regular DFA from the mapped data.
+   *
+   * @return DFA
+   */
+  DFA toDFA() const;
+
+private:
+  /**
+   * @brief Raise an error if the header does not describe a well formed
+   * file of the mapped size.
+   *
+   */
+  void checkLayout() const;
+
+  /**
+   * @brief Raise an error if the payload checksum does not match.
+   *
+   */
+  void checkChecksum() const;
+
+  std::string readName(uint64_t indexOffset, uint64_t blobOffset,
+                       uint64_t blobEnd, uint32_t id) const;
+
+  std::string path;
+  const unsigned char *data;
+  std::size_t size;
+  const BinaryHeader *header;
+  const uint32_t *table;
+  const uint64_t *finals;
+  uint32_t stateCount;
+  uint32_t symbolCount;
+  uint32_t initialState;
+};
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_MAPPED_DFA */
@@ -0,0 +1,639 @@
+#include "TextFormat.hpp"
+#include "DFA.hpp"
+#include "Exceptions.hpp"
+#include "NFA.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+/**
+ * @brief Names written per line for the state, symbol and final state
+ * records of the edge list format.
+ *
+ */
+const std::size_t EDGE_LIST_NAMES_PER_LINE = 16;
+
+void writeJSONString(std::ostream &out, const std::string &str) {
+  static const char hex[] = "0123456789abcdef";
+  out << '"';
+  for (char c : str) {
+    unsigned char byte = static_cast<unsigned char>(c);
+    switch (c) {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\r':
+      out << "\\r";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      if (byte < 0x20) {
+        out << "\\u00" << hex[byte >> 4] << hex[byte & 0xF];
+      } else {
+        out << c;
+      }
+    }
+  }
+  out << '"';
+}
+
+template <typename Container>
+void writeJSONArray(std::ostream &out, const Container &names) {
+  out << '[';
+  bool first = true;
+  for (auto &name : names) {
+    if (!first) {
+      out << ", ";
+    }
+    first = false;
+    writeJSONString(out, name);
+  }
+  out << ']';
+}
+
+/**
+ * @brief Write every member of the JSON object but the closing brace, so
+ * that callers can append their own members.
+ *
+ */
+template <typename TransitionMap, typename WriteEnd>
+void writeJSONAutomaton(std::ostream &out, const char *type,
+                        const FA &automaton, const TransitionMap &transitions,
+                        WriteEnd writeEnd) {
+  out << "{\n  \"type\": \"" << type << "\",\n  \"states\": ";
+  writeJSONArray(out, automaton.getStates());
+  out << ",\n  \"input_symbols\": ";
+  writeJSONArray(out, automaton.getInputSymbols());
+  out << ",\n  \"transitions\": {";
+  bool firstState = true;
+  for (auto &transition : transitions) {
+    out << (firstState ? "\n    " : ",\n    ");
+    firstState = false;
+    writeJSONString(out, transition.first);
+    out << ": {";
+    bool firstPath = true;
+    for (auto &path : transition.second) {
+      out << (firstPath ? "" : ", ");
+      firstPath = false;
+      writeJSONString(out, path.first);
+      out << ": ";
+      writeEnd(path.second);
+    }
+    out << '}';
+  }
+  out << "\n  },\n  \"initial_state\": ";
+  writeJSONString(out, automaton.getInitialState());
+  out << ",\n  \"final_states\": ";
+  writeJSONArray(out, automaton.getFinalStates());
+}
+
+/**
+ * @brief Pull parser reading JSON values straight from a stream buffer.
+ *
+ */
+class JSONReader {
+public:
+  explicit JSONReader(std::istream &in) : buf(in.rdbuf()), line(1) {}
+
+  void fail(const std::string &reason) const {
+    std::stringstream ss;
+    ss << "JSON line " << line << ": " << reason;
+    throw SerializationException(ss.str());
+  }
+
+  int peek() {
+    skipWhitespace();
+    return buf->sgetc();
+  }
+
+  bool consume(char c) {
+    if (peek() == c) {
+      buf->sbumpc();
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) {
+      fail(std::string("expected '") + c + "'");
+    }
+  }
+
+  std::string readString() {
+    expect('"');
+    std::string str;
+    while (true) {
+      int c = buf->sbumpc();
+      if (c == std::char_traits<char>::eof()) {
+        fail("unterminated string");
+      } else if (c == '"') {
+        return str;
+      } else if (c == '\\') {
+        readEscape(str);
+      } else {
+        if (c == '\n') {
+          line++;
+        }
+        str.push_back(static_cast<char>(c));
+      }
+    }
+  }
+
+  bool readBool() {
+    if (peek() == 't') {
+      expectWord("true");
+      return true;
+    }
+    expectWord("false");
+    return false;
+  }
+
+  template <typename F> void readArray(F onElement) {
+    expect('[');
+    if (consume(']')) {
+      return;
+    }
+    do {
+      onElement();
+    } while (consume(','));
+    expect(']');
+  }
+
+  template <typename F> void readObject(F onMember) {
+    expect('{');
+    if (consume('}')) {
+      return;
+    }
+    do {
+      std::string key = readString();
+      expect(':');
+      onMember(key);
+    } while (consume(','));
+    expect('}');
+  }
+
+  void skipValue() {
+    int c = peek();
+    if (c == '"') {
+      readString();
+    } else if (c == '[') {
+      readArray([this] { skipValue(); });
+    } else if (c == '{') {
+      readObject([this](const std::string &) { skipValue(); });
+    } else if (c == 't' || c == 'f') {
+      readBool();
+    } else if (c == 'n') {
+      expectWord("null");
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+      while ((c = buf->sgetc()) == '-' || c == '+' || c == '.' || c == 'e' ||
+             c == 'E' || (c >= '0' && c <= '9')) {
+        buf->sbumpc();
+      }
+    } else {
+      fail("unexpected character");
+    }
+  }
+
+  void expectEnd() {
+    if (peek() != std::char_traits<char>::eof()) {
+      fail("trailing characters after the automaton");
+    }
+  }
+
+private:
+  void skipWhitespace() {
+    int c;
+    while ((c = buf->sgetc()) == ' ' || c == '\t' || c == '\n' || c == '\r') {
+      if (c == '\n') {
+        line++;
+      }
+      buf->sbumpc();
+    }
+  }
+
+  void expectWord(const char *word) {
+    for (const char *p = word; *p; p++) {
+      if (buf->sbumpc() != *p) {
+        fail(std::string("expected ") + word);
+      }
+    }
+  }
+
+  unsigned readHex4() {
+    unsigned value = 0;
+    for (int i = 0; i < 4; i++) {
+      int c = buf->sbumpc();
+      value <<= 4;
+      if (c >= '0' && c <= '9') {
+        value |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        value |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        value |= c - 'A' + 10;
+      } else {
+        fail("invalid unicode escape");
+      }
+    }
+    return value;
+  }
+
+  void readEscape(std::string &str) {
+    int c = buf->sbumpc();
+    switch (c) {
+    case '"':
+    case '\\':
+    case '/':
+      str.push_back(static_cast<char>(c));
+      return;
+    case 'b':
+      str.push_back('\b');
+      return;
+    case 'f':
+      str.push_back('\f');
+      return;
+    case 'n':
+      str.push_back('\n');
+      return;
+    case 'r':
+      str.push_back('\r');
+      return;
+    case 't':
+      str.push_back('\t');
+      return;
+    case 'u':
+      break;
+    default:
+      fail("invalid escape sequence");
+    }
+    unsigned code = readHex4();
+    if (code >= 0xD800 && code < 0xDC00) {
+      if (buf->sbumpc() != '\\' || buf->sbumpc() != 'u') {
+        fail("unpaired surrogate");
+      }
+      unsigned low = readHex4();
+      if (low < 0xDC00 || low >= 0xE000) {
+        fail("unpaired surrogate");
+      }
+      code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+    }
+    if (code < 0x80) {
+      str.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      str.push_back(static_cast<char>(0xC0 | (code >> 6)));
+      str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+      str.push_back(static_cast<char>(0xE0 | (code >> 12)));
+      str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+      str.push_back(static_cast<char>(0xF0 | (code >> 18)));
+      str.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+  }
+
+  std::streambuf *buf;
+  std::size_t line;
+};
+
+/**
+ * @brief The parts of an automaton shared by the DFA and NFA readers.
+ *
+ */
+struct AutomatonDefinition {
+  AutomatonDefinition() : hasInitialState(false), allowPartial(false) {}
+
+  States states;
+  InputSymbols inputSymbols;
+  State initialState;
+  bool hasInitialState;
+  States finalStates;
+  bool allowPartial;
+};
+
+template <typename TransitionMap, typename ReadEnd>
+void readJSONAutomaton(std::istream &in, const std::string &type,
+                       AutomatonDefinition &definition,
+                       TransitionMap &transitions, ReadEnd readEnd) {
+  JSONReader reader(in);
+  reader.readObject([&](const std::string &key) {
+    if (key == "type") {
+      if (reader.readString() != type) {
+        reader.fail("expected an automaton of type " + type);
+      }
+    } else if (key == "states") {
+      reader.readArray(
+          [&] { definition.states.insert(reader.readString()); });
+    } else if (key == "input_symbols") {
+      reader.readArray(
+          [&] { definition.inputSymbols.insert(reader.readString()); });
+    } else if (key == "transitions") {
+      reader.readObject([&](const std::string &start) {
+        auto &paths = transitions[start];
+        reader.readObject([&](const std::string &symbol) {
+          readEnd(reader, paths[symbol]);
+        });
+      });
+    } else if (key == "initial_state") {
+      definition.initialState = reader.readString();
+      definition.hasInitialState = true;
+    } else if (key == "final_states") {
+      reader.readArray(
+          [&] { definition.finalStates.insert(reader.readString()); });
+    } else if (key == "allow_partial") {
+      definition.allowPartial = reader.readBool();
+    } else {
+      reader.skipValue();
+    }
+  });
+  reader.expectEnd();
+  if (!definition.hasInitialState) {
+    reader.fail("missing initial_state");
+  }
+}
+
+void writeEdgeListToken(std::ostream &out, const std::string &token) {
+  static const char hex[] = "0123456789ABCDEF";
+  if (token.empty()) {
+    out << '%';
+    return;
+  }
+  for (char c : token) {
+    unsigned char byte = static_cast<unsigned char>(c);
+    if (byte <= ' ' || c == '%' || c == '#' || c == '@' || byte == 0x7F) {
+      out << '%' << hex[byte >> 4] << hex[byte & 0xF];
+    } else {
+      out << c;
+    }
+  }
+}
+
+template <typename Container>
+void writeEdgeListNames(std::ostream &out, const char *record,
+                        const Container &names) {
+  std::size_t count = 0;
+  for (auto &name : names) {
+    if (count % EDGE_LIST_NAMES_PER_LINE == 0) {
+      if (count != 0) {
+        out << '\n';
+      }
+      out << record;
+    }
+    out << ' ';
+    writeEdgeListToken(out, name);
+    count++;
+  }
+  if (count != 0) {
+    out << '\n';
+  }
+}
+
+void writeEdgeListHeader(std::ostream &out, const char *header,
+                         const FA &automaton) {
+  out << header << '\n';
+  out << "@initial ";
+  writeEdgeListToken(out, automaton.getInitialState());
+  out << '\n';
+  writeEdgeListNames(out, "@symbols", automaton.getInputSymbols());
+  writeEdgeListNames(out, "@states", automaton.getStates());
+  writeEdgeListNames(out, "@final", automaton.getFinalStates());
+}
+
+void writeEdge(std::ostream &out, const State &start, const InputSymbol &symbol,
+               const State &end) {
+  writeEdgeListToken(out, start);
+  out << ' ';
+  writeEdgeListToken(out, symbol);
+  out << ' ';
+  writeEdgeListToken(out, end);
+  out << '\n';
+}
+
+/**
+ * @brief Line reader splitting records of the edge list format into
+ * decoded tokens.
+ *
+ */
+class EdgeListReader {
+public:
+  explicit EdgeListReader(std::istream &in) : in(in), line(0) {}
+
+  void fail(const std::string &reason) const {
+    std::stringstream ss;
+    ss << "edge list line " << line << ": " << reason;
+    throw SerializationException(ss.str());
+  }
+
+  /**
+   * @brief Read the next non-empty record into tokens.
+   *
+   * @param tokens
+   * @return false at the end of the stream
+   */
+  bool next(std::vector<std::string> &tokens) {
+    tokens.clear();
+    while (tokens.empty() && std::getline(in, text)) {
+      line++;
+      std::size_t pos = 0;
+      while (pos < text.size() && text[pos] != '#') {
+        if (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r') {
+          pos++;
+          continue;
+        }
+        std::size_t end = pos;
+        while (end < text.size() && text[end] != ' ' && text[end] != '\t' &&
+               text[end] != '\r' && text[end] != '#') {
+          end++;
+        }
+        tokens.push_back(decode(pos, end));
+        pos = end;
+      }
+    }
+    return !tokens.empty();
+  }
+
+private:
+  static int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  }
+
+  std::string decode(std::size_t begin, std::size_t end) const {
+    if (end - begin == 1 && text[begin] == '%') {
+      return std::string();
+    }
+    std::string token;
+    token.reserve(end - begin);
+    for (std::size_t i = begin; i < end; i++) {
+      if (text[i] != '%') {
+        token.push_back(text[i]);
+        continue;
+      }
+      int high = i + 2 < end ? hexValue(text[i + 1]) : -1;
+      int low = i + 2 < end ? hexValue(text[i + 2]) : -1;
+      if (high < 0 || low < 0) {
+        fail("invalid escape in " + text.substr(begin, end - begin));
+      }
+      token.push_back(static_cast<char>(high * 16 + low));
+      i += 2;
+    }
+    return token;
+  }
+
+  std::istream &in;
+  std::string text;
+  std::size_t line;
+};
+
+template <typename TransitionMap, typename AddEdge>
+void readEdgeListAutomaton(std::istream &in, const std::string &type,
+                           AutomatonDefinition &definition,
+                           TransitionMap &transitions, AddEdge addEdge) {
+  EdgeListReader reader(in);
+  std::vector<std::string> tokens;
+  if (!reader.next(tokens) || tokens[0] != type ||
+      (tokens.size() == 2 && tokens[1] != "partial") || tokens.size() > 2) {
+    reader.fail("expected header '" + type + "'");
+  }
+  definition.allowPartial = tokens.size() == 2;
+
+  while (reader.next(tokens)) {
+    const std::string &record = tokens[0];
+    if (record.empty() || record[0] != '@') {
+      if (tokens.size() != 3) {
+        reader.fail("an edge needs a start state, a symbol and an end state");
+      }
+      addEdge(reader, transitions[tokens[0]], tokens[1], tokens[2]);
+    } else if (record == "@states") {
+      definition.states.insert(tokens.begin() + 1, tokens.end());
+    } else if (record == "@symbols") {
+      definition.inputSymbols.insert(tokens.begin() + 1, tokens.end());
+    } else if (record == "@final") {
+      definition.finalStates.insert(tokens.begin() + 1, tokens.end());
+    } else if (record == "@initial") {
+      if (tokens.size() != 2) {
+        reader.fail("@initial needs exactly one state");
+      }
+      definition.initialState = tokens[1];
+      definition.hasInitialState = true;
+    } else {
+      reader.fail("unknown record " + record);
+    }
+  }
+  if (!definition.hasInitialState) {
+    reader.fail("missing @initial");
+  }
+}
+
+} // namespace
+
+void writeJSON(const DFA &dfa, std::ostream &out) {
+  writeJSONAutomaton(out, "DFA", dfa, dfa.getTransitions(),
+                     [&out](const State &end) { writeJSONString(out, end); });
+  out << ",\n  \"allow_partial\": "
+      << (dfa.getAllowPartial() ? "true" : "false") << "\n}\n";
+}
+
+void writeJSON(const NFA &nfa, std::ostream &out) {
+  writeJSONAutomaton(out, "NFA", nfa, nfa.getNFATransitions(),
+                     [&out](const States &ends) { writeJSONArray(out, ends); });
+  out << "\n}\n";
+}
+
+DFA readDFAFromJSON(std::istream &in) {
+  AutomatonDefinition definition;
+  Transitions transitions;
+  readJSONAutomaton(in, "DFA", definition, transitions,
+                    [](JSONReader &reader, State &end) {
+                      end = reader.readString();
+                    });
+  return DFA(definition.states, definition.inputSymbols, transitions,
+             definition.initialState, definition.finalStates,
+             definition.allowPartial);
+}
+
+NFA readNFAFromJSON(std::istream &in) {
+  AutomatonDefinition definition;
+  NFATransitions transitions;
+  readJSONAutomaton(in, "NFA", definition, transitions,
+                    [](JSONReader &reader, States &ends) {
+                      reader.readArray(
+                          [&] { ends.insert(reader.readString()); });
+                    });
+  return NFA(definition.states, definition.inputSymbols, transitions,
+             definition.initialState, definition.finalStates);
+}
+
+void writeEdgeList(const DFA &dfa, std::ostream &out) {
+  writeEdgeListHeader(out, dfa.getAllowPartial() ? "dfa partial" : "dfa", dfa);
+  for (auto &transition : dfa.getTransitions()) {
+    for (auto &path : transition.second) {
+      writeEdge(out, transition.first, path.first, path.second);
+    }
+  }
+}
+
+void writeEdgeList(const NFA &nfa, std::ostream &out) {
+  writeEdgeListHeader(out, "nfa", nfa);
+  for (auto &transition : nfa.getNFATransitions()) {
+    for (auto &path : transition.second) {
+      for (auto &end : path.second) {
+        writeEdge(out, transition.first, path.first, end);
+      }
+    }
+  }
+}
+
+DFA readDFAFromEdgeList(std::istream &in) {
+  AutomatonDefinition definition;
+  Transitions transitions;
+  readEdgeListAutomaton(
+      in, "dfa", definition, transitions,
+      [](const EdgeListReader &reader, Paths &paths, const InputSymbol &symbol,
+         const State &end) {
+        auto inserted = paths.emplace(symbol, end);
+        if (!inserted.second && inserted.first->second != end) {
+          reader.fail("a DFA state has two transitions on the same symbol");
+        }
+      });
+  // States without outgoing edges still need an entry in the transitions.
+  for (auto &state : definition.states) {
+    transitions[state];
+  }
+  return DFA(definition.states, definition.inputSymbols, transitions,
+             definition.initialState, definition.finalStates,
+             definition.allowPartial);
+}
+
+NFA readNFAFromEdgeList(std::istream &in) {
+  AutomatonDefinition definition;
+  NFATransitions transitions;
+  readEdgeListAutomaton(
+      in, "nfa", definition, transitions,
+      [](const EdgeListReader &, NFAPaths &paths, const InputSymbol &symbol,
+         const State &end) { paths[symbol].insert(end); });
+  return NFA(definition.states, definition.inputSymbols, transitions,
+             definition.initialState, definition.finalStates);
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,60 @@
+#ifndef CXXAUTOMATA_TEXT_FORMAT
+#define CXXAUTOMATA_TEXT_FORMAT
+
+#include <istream>
+#include <ostream>
+
+namespace CXXAUTOMATA {
+class DFA;
+class NFA;
+
+/**
+ * @brief Text formats for exchanging automata.
+ *
+ * JSON: a single object with the keys below, in any order. Unknown keys are
+ * skipped. For an NFA every transition maps to an array of end states and
+ * the empty symbol "" denotes a lambda transition.
+ *
+ *   {
+ *     "type": "DFA",
+ *     "states": ["q0", "q1"],
+ *     "input_symbols": ["0", "1"],
+ *     "transitions": {"q0": {"0": "q0", "1": "q1"},
+ *                     "q1": {"0": "q0", "1": "q1"}},
+ *     "initial_state": "q0",
+ *     "final_states": ["q1"],
+ *     "allow_partial": false
+ *   }
+ *
+ * Edge list: one record per line, tokens separated by blanks, '#' starts a
+ * comment. The first record is "dfa", "dfa partial" or "nfa". Then, in any
+ * order and possibly repeated:
+ *
+ *   @states q0 q1
+ *   @symbols 0 1
+ *   @initial q0
+ *   @final q1
+ *   q0 1 q1
+ *
+ * where every line that does not start with '@' is an edge
+ * "start symbol end". Inside tokens, blanks, '%', '#' and '@' are written
+ * as %XX (hexadecimal byte) and a lone '%' is the empty string.
+ *
+ * Readers consume the stream once and build the automaton's containers
+ * directly, without an intermediate document; writers emit each state as
+ * they visit it and use no extra memory beyond the output buffer.
+ */
+
+void writeJSON(const DFA &dfa, std::ostream &out);
+void writeJSON(const NFA &nfa, std::ostream &out);
+DFA readDFAFromJSON(std::istream &in);
+NFA readNFAFromJSON(std::istream &in);
+
+void writeEdgeList(const DFA &dfa, std::ostream &out);
+void writeEdgeList(const NFA &nfa, std::ostream &out);
+DFA readDFAFromEdgeList(std::istream &in);
+NFA readNFAFromEdgeList(std::istream &in);
+
+} // namespace CXXAUTOMATA
+
+#endif /* CXXAUTOMATA_TEXT_FORMAT */
@@ -0,0 +1,189 @@
+#include "Statistics.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <sys/resource.h>
+
+namespace CXXAUTOMATA {
+
+namespace {
+
+const int OPERATION_COUNT = static_cast<int>(Operation::COUNT);
+const int COUNTER_COUNT = static_cast<int>(Counter::COUNT);
+
+struct AtomicTotals {
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> nanoseconds;
+  std::atomic<uint64_t> counters[COUNTER_COUNT];
+};
+
+AtomicTotals totals[OPERATION_COUNT];
+std::mutex callbackMutex;
+Statistics::Callback callback;
+thread_local ScopedOperation *innermost = nullptr;
+
+int64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t peakMemoryBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  // ru_maxrss is reported in kilobytes on Linux.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+} // namespace
+
+OperationStatistics::OperationStatistics() : calls(0), nanoseconds(0) {
+  for (auto &counter : counters) {
+    counter = 0;
+  }
+}
+
+bool Statistics::isEnabled() {
+#ifdef CXXAUTOMATA_ENABLE_STATISTICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+StatisticsSnapshot Statistics::snapshot() {
+  StatisticsSnapshot snapshot;
+  for (int op = 0; op < OPERATION_COUNT; op++) {
+    auto &stats = snapshot.operations[op];
+    stats.calls = totals[op].calls.load(std::memory_order_relaxed);
+    stats.nanoseconds = totals[op].nanoseconds.load(std::memory_order_relaxed);
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+      stats.counters[c] = totals[op].counters[c].load(std::memory_order_relaxed);
+    }
+  }
+  snapshot.peakMemoryBytes = isEnabled() ? peakMemoryBytes() : 0;
+  return snapshot;
+}
+
+void Statistics::reset() {
+  for (auto &total : totals) {
+    total.calls = 0;
+    total.nanoseconds = 0;
+    for (auto &counter : total.counters) {
+      counter = 0;
+    }
+  }
+}
+
+void Statistics::setCallback(Callback newCallback) {
+  std::lock_guard<std::mutex> lock(callbackMutex);
+  callback = std::move(newCallback);
+}
+
+const char *Statistics::operationName(Operation operation) {
+  switch (operation) {
+  case Operation::MINIFY:
+    return "minify";
+  case Operation::CROSS_PRODUCT:
+    return "cross_product";
+  case Operation::VALIDATE:
+    return "validate";
+  case Operation::FROM_NFA:
+    return "from_nfa";
+  case Operation::SUBSET_CONSTRUCTION:
+    return "subset_construction";
+  default:
+    return "unknown";
+  }
+}
+
+const char *Statistics::counterName(Counter counter) {
+  switch (counter) {
+  case Counter::STATES_EXPLORED:
+    return "states_explored";
+  case Counter::PARTITIONS_SPLIT:
+    return "partitions_split";
+  case Counter::TRANSITIONS_VISITED:
+    return "transitions_visited";
+  case Counter::ALLOCATIONS:
+    return "allocations";
+  default:
+    return "unknown";
+  }
+}
+
+void Statistics::writePrometheus(std::ostream &out) {
+  auto stats = snapshot();
+  auto family = [&out](const std::string &name, const char *help,
+                       const char *type) {
+    out << "# HELP cxxautomata_" << name << ' ' << help << '\n';
+    out << "# TYPE cxxautomata_" << name << ' ' << type << '\n';
+  };
+  auto sample = [&out](const std::string &name, int op) {
+    out << "cxxautomata_" << name << "{operation=\""
+        << operationName(static_cast<Operation>(op)) << "\"} ";
+  };
+
+  family("operation_calls_total", "Completed calls of each operation.",
+         "counter");
+  for (int op = 0; op < OPERATION_COUNT; op++) {
+    sample("operation_calls_total", op);
+    out << stats.operations[op].calls << '\n';
+  }
+  family("operation_seconds_total", "Time spent in each operation.",
+         "counter");
+  for (int op = 0; op < OPERATION_COUNT; op++) {
+    sample("operation_seconds_total", op);
+    out << stats.operations[op].nanoseconds / 1e9 << '\n';
+  }
+  for (int c = 0; c < COUNTER_COUNT; c++) {
+    std::string name = std::string(counterName(static_cast<Counter>(c))) +
+                       "_total";
+    family(name, "Work counter of each operation.", "counter");
+    for (int op = 0; op < OPERATION_COUNT; op++) {
+      sample(name, op);
+      out << stats.operations[op].counters[c] << '\n';
+    }
+  }
+  family("peak_memory_bytes", "Peak resident set size of the process.",
+         "gauge");
+  out << "cxxautomata_peak_memory_bytes " << stats.peakMemoryBytes << '\n';
+}
+
+ScopedOperation::ScopedOperation(Operation operation)
+    : operation(operation), parent(innermost), start(now()) {
+  innermost = this;
+}
+
+ScopedOperation::~ScopedOperation() {
+  innermost = parent;
+  current.calls = 1;
+  current.nanoseconds = static_cast<uint64_t>(now() - start);
+  auto &total = totals[static_cast<int>(operation)];
+  total.calls.fetch_add(1, std::memory_order_relaxed);
+  total.nanoseconds.fetch_add(current.nanoseconds, std::memory_order_relaxed);
+  for (int c = 0; c < COUNTER_COUNT; c++) {
+    total.counters[c].fetch_add(current.counters[c],
+                                std::memory_order_relaxed);
+  }
+
+  Statistics::Callback notify;
+  {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    notify = callback;
+  }
+  if (notify) {
+    notify(operation, current);
+  }
+}
+
+void ScopedOperation::add(Counter counter, uint64_t value) {
+  if (innermost != nullptr) {
+    innermost->current.counters[static_cast<int>(counter)] += value;
+  }
+}
+
+} // namespace CXXAUTOMATA
@@ -0,0 +1,172 @@
+#ifndef CXXAUTOMATA_STATISTICS
+#define CXXAUTOMATA_STATISTICS
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Opt-in instrumentation of the expensive automaton operations.
+ *
+ * The probes below only exist when the library is compiled with
+ * CXXAUTOMATA_ENABLE_STATISTICS (CMake option CXXAUTOMATA_STATISTICS);
+ * otherwise they expand to nothing and every counter stays at zero.
+ */
+
+namespace CXXAUTOMATA {
+
+/**
+ * @brief The instrumented operations.
+ *
+ */
+enum class Operation {
+  MINIFY,
+  CROSS_PRODUCT,
+  VALIDATE,
+  FROM_NFA,
+  SUBSET_CONSTRUCTION,
+  COUNT
+};
+
+/**
+ * @brief The counters recorded for each operation.
+ *
+ */
+enum class Counter {
+  /** states dequeued, created or checked */
+  STATES_EXPLORED,
+  /** equivalence classes split during minimization */
+  PARTITIONS_SPLIT,
+  /** transitions followed or checked */
+  TRANSITIONS_VISITED,
+  /** states and transitions stored in new containers */
+  ALLOCATIONS,
+  COUNT
+};
+
+/**
+ * @brief Totals for one operation, or for a single call of it.
+ *
+ */
+struct OperationStatistics {
+  OperationStatistics();
+
+  uint64_t calls;
+  uint64_t nanoseconds;
+  uint64_t counters[static_cast<int>(Counter::COUNT)];
+
+  uint64_t get(Counter counter) const {
+    return counters[static_cast<int>(counter)];
+  }
+};
+
+/**
+ * @brief Totals of every operation since the last reset.
+ *
+ */
+struct StatisticsSnapshot {
+  OperationStatistics operations[static_cast<int>(Operation::COUNT)];
+  /** Peak resident set size of the process, in bytes. */
+  uint64_t peakMemoryBytes;
+
+  const OperationStatistics &get(Operation operation) const {
+    return operations[static_cast<int>(operation)];
+  }
+};
+
+/**
+ * @brief Process-wide access to the recorded statistics.
+ *
+ */
+class Statistics {
+public:
+  /**
+   * @brief Called once per completed operation with what that call did.
+   *
+   */
+  typedef std::function<void(Operation, const OperationStatistics &)>
+      Callback;
+
+  /**
+   * @brief Return True if the library was built with statistics.
+   *
+   * @return true
+   * @return false
+   */
+  static bool isEnabled();
+
+  /**
+   * @brief Return the totals recorded so far.
+   *
+   * @return StatisticsSnapshot
+   */
+  static StatisticsSnapshot snapshot();
+
+  /**
+   * @brief Set every total back to zero.
+   *
+   */
+  static void reset();
+
+  /**
+   * @brief Register the callback invoked after each operation; an empty
+   *        function removes it. The callback may run on any thread.
+   *
+   * @param callback
+   */
+  static void setCallback(Callback callback);
+
+  /**
+   * @brief Write the totals in the Prometheus text exposition format.
+   *
+   * @param out
+   */
+  static void writePrometheus(std::ostream &out);
+
+  static const char *operationName(Operation operation);
+  static const char *counterName(Counter counter);
+};
+
+/**
+ * @brief Times one operation and collects its counters until it goes out of
+ *        scope. Scopes nest per thread; counters go to the innermost one.
+ *
+ */
+class ScopedOperation {
+public:
+  explicit ScopedOperation(Operation operation);
+  ~ScopedOperation();
+
+  ScopedOperation(const ScopedOperation &) = delete;
+  ScopedOperation &operator=(const ScopedOperation &) = delete;
+
+  /**
+   * @brief Add to a counter of the innermost operation of this thread.
+   *
+   * @param counter
+   * @param value
+   */
+  static void add(Counter counter, uint64_t value);
+
+private:
+  Operation operation;
+  ScopedOperation *parent;
+  int64_t start;
+  OperationStatistics current;
+};
+
+} // namespace CXXAUTOMATA
+
+#ifdef CXXAUTOMATA_ENABLE_STATISTICS
+#define CXXAUTOMATA_STATS_SCOPE(operation)                                     \
+  ::CXXAUTOMATA::ScopedOperation cxxautomataStatsScope(                        \
+      ::CXXAUTOMATA::Operation::operation)
+#define CXXAUTOMATA_STATS_ADD(counter, value)                                  \
+  ::CXXAUTOMATA::ScopedOperation::add(::CXXAUTOMATA::Counter::counter, (value))
+#else
+#define CXXAUTOMATA_STATS_SCOPE(operation) ((void)0)
+#define CXXAUTOMATA_STATS_ADD(counter, value) ((void)0)
+#endif
+
+#endif /* CXXAUTOMATA_STATISTICS */
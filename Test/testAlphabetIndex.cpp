@@ -0,0 +1,51 @@
+#include "AlphabetIndex.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+TEST(AlphabetIndexTest, test_single_bytes) {
+  // Should number the symbols in sorted order and index them by byte.
+  AlphabetIndex alphabet({"b", "a", "c"});
+  ASSERT_TRUE(alphabet.isByteIndexed());
+  ASSERT_EQ(alphabet.size(), 3u);
+  ASSERT_EQ(alphabet.find("a"), 0u);
+  ASSERT_EQ(alphabet.findByte('c'), 2u);
+  ASSERT_EQ(alphabet.find("d"), NO_SYMBOL);
+  ASSERT_EQ(alphabet.find("ab"), NO_SYMBOL);
+  ASSERT_EQ(alphabet.find(""), NO_SYMBOL);
+  ASSERT_EQ(alphabet.denseTableBytes(10), 10 * 3 * sizeof(StateId));
+
+  alphabet.setValues({7, 7, 1});
+  ASSERT_EQ(alphabet.find("b"), 7u);
+  ASSERT_EQ(alphabet.find("c"), 1u);
+}
+
+TEST(AlphabetIndexTest, test_names) {
+  // Should fall back to a hash table for longer symbols.
+  AlphabetIndex alphabet({"if", "x", ""});
+  ASSERT_FALSE(alphabet.isByteIndexed());
+  ASSERT_EQ(alphabet.find(""), 0u);
+  ASSERT_EQ(alphabet.find("x"), 2u);
+  ASSERT_EQ(alphabet.find("else"), NO_SYMBOL);
+  ASSERT_GT(alphabet.lookupBytes(), 0u);
+}
+
+TEST(AlphabetIndexTest, test_walk_input) {
+  // Should follow next until the input ends or leaves the automaton.
+  AlphabetIndex alphabet({"0", "1"});
+  // Counts the 1s up to 2, then has no transition
+  auto next = [](StateId state, uint32_t symbol) {
+    return state == 2 && symbol == 1 ? NO_STATE : state + symbol;
+  };
+  std::vector<StateId> visited;
+  auto visit = [&](StateId state, std::size_t, const InputSymbol &) {
+    visited.push_back(state);
+  };
+  ASSERT_EQ(walkInput(alphabet, 0, {"1", "0", "1"}, next, visit), 2u);
+  ASSERT_EQ(visited, std::vector<StateId>({1, 1, 2}));
+  ASSERT_EQ(walkInput(alphabet, 0, {"1", "1", "1"}, next, visit), NO_STATE);
+  ASSERT_EQ(walkInput(alphabet, 0, {"2"}, next, visit), NO_STATE);
+  ASSERT_EQ(findSorted({"a", "c"}, "c"), 1u);
+  ASSERT_EQ(findSorted({"a", "c"}, "b"), NO_STATE);
+}
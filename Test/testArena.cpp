@@ -0,0 +1,45 @@
+#include "Arena.hpp"
+#include "gtest/gtest.h"
+#include <map>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+TEST(ArenaTest, test_alignment) {
+  // Should honour the requested alignment.
+  Arena arena(128);
+  arena.allocate(1, 1);
+  auto pointer = reinterpret_cast<uintptr_t>(arena.allocate(8, 8));
+  ASSERT_EQ(pointer % 8, 0u);
+  pointer = reinterpret_cast<uintptr_t>(arena.allocate(3, 64));
+  ASSERT_EQ(pointer % 64, 0u);
+}
+
+TEST(ArenaTest, test_large_allocation) {
+  // Should serve requests larger than a block.
+  Arena arena(64);
+  auto data = static_cast<char *>(arena.allocate(1000, 1));
+  data[999] = 'x';
+  ASSERT_EQ(arena.bytesAllocated(), 1000u);
+  arena.release();
+  ASSERT_EQ(arena.bytesAllocated(), 0u);
+}
+
+TEST(ArenaTest, test_containers) {
+  // Should back standard containers.
+  Arena arena(256);
+  ArenaVector<int> numbers{ArenaAllocator<int>(arena)};
+  for (int i = 0; i < 1000; i++) {
+    numbers.push_back(i);
+  }
+  ASSERT_EQ(numbers[999], 999);
+
+  typedef std::map<int, ArenaString, std::less<int>,
+                   ArenaAllocator<std::pair<const int, ArenaString>>>
+      ArenaMap;
+  ArenaMap names{std::less<int>(), ArenaAllocator<int>(arena)};
+  names.emplace(1, ArenaString("a long name that does not fit inline",
+                               ArenaAllocator<char>(arena)));
+  ASSERT_EQ(names.at(1).size(), 36u);
+  ASSERT_GT(arena.bytesAllocated(), 1000 * sizeof(int));
+}
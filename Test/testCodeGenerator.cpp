@@ -0,0 +1,108 @@
+#include "CodeGenerator.hpp"
+#include "DirectMatcher.hpp"
+#include "Exceptions.hpp"
+#include "TableMatcher.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <functional>
+#include <sstream>
+
+using namespace CXXAUTOMATA;
+
+class CodeGeneratorTest : public FATest {
+protected:
+  CodeGeneratorTest()
+      : noConsecutive11({"q0", "q1", "q2"}, {"0", "1"},
+                        {
+                            {"q0", {{"0", "q0"}, {"1", "q1"}}},
+                            {"q1", {{"0", "q0"}, {"1", "q2"}}},
+                            {"q2", {{"0", "q2"}, {"1", "q2"}}},
+                        },
+                        "q0", {"q0", "q1"}) {}
+
+  // Test/Automata/no_consecutive_11.txt, from which the matchers are built
+  DFA noConsecutive11;
+};
+
+TEST_F(CodeGeneratorTest, test_generated_matchers) {
+  // Should accept the same words as the DFA they were generated from.
+  std::function<void(std::string)> check = [&](std::string word) {
+    InputSymbols_v symbols;
+    std::vector<int> indices;
+    for (char c : word) {
+      symbols.push_back(std::string(1, c));
+      indices.push_back(c - '0');
+    }
+    bool expected = noConsecutive11.acceptsInput(symbols);
+    ASSERT_EQ(directMatcher(word.data(), word.size()), expected);
+    ASSERT_EQ(tableMatcher(word.data(), word.size()), expected);
+    ASSERT_EQ(directMatcher(symbols), expected);
+    ASSERT_EQ(tableMatcher(symbols), expected);
+    ASSERT_EQ(directMatcher_indices(indices.data(), indices.size()), expected);
+    ASSERT_EQ(tableMatcher_indices(indices.data(), indices.size()), expected);
+    if (word.size() < 8) {
+      check(word + "0");
+      check(word + "1");
+    }
+  };
+  check("");
+  ASSERT_FALSE(directMatcher("012", 3));
+  ASSERT_FALSE(tableMatcher(InputSymbols_v({"0", "x"})));
+  ASSERT_EQ(directMatcher_symbol("1"), 1);
+  ASSERT_EQ(tableMatcher_symbol("2"), -1);
+  // Ids outside the alphabet reject rather than index past a row.
+  std::vector<int> outOfRange = {0, 2};
+  ASSERT_FALSE(tableMatcher_indices(outOfRange.data(), outOfRange.size()));
+  ASSERT_FALSE(directMatcher_indices(outOfRange.data(), outOfRange.size()));
+  outOfRange = {1, 1000};
+  ASSERT_FALSE(tableMatcher_indices(outOfRange.data(), outOfRange.size()));
+}
+
+TEST_F(CodeGeneratorTest, test_write_direct) {
+  // Should write labelled states and skip dead ones.
+  CodeGeneratorOptions options;
+  options.functionName = "noConsecutive11";
+  options.namespaceName = "app::lexer";
+  std::stringstream ss;
+  writeCppMatcher(noConsecutive11, ss, options);
+  auto code = ss.str();
+  ASSERT_NE(code.find("#ifndef CXXAUTOMATA_GENERATED_APP_LEXER_NOCONSECUTIVE11"),
+            std::string::npos);
+  ASSERT_NE(code.find("namespace app {\nnamespace lexer {"), std::string::npos);
+  ASSERT_NE(code.find("inline bool noConsecutive11(const char *input"),
+            std::string::npos);
+  ASSERT_NE(code.find("state0:"), std::string::npos);
+  // q2 is dead, so moving into it rejects at once.
+  ASSERT_EQ(code.find("state2"), std::string::npos);
+  ASSERT_EQ(code.find("\"q2\""), std::string::npos);
+}
+
+TEST_F(CodeGeneratorTest, test_write_table) {
+  // Should write a table and no character matcher for longer symbols.
+  auto dfa = DFA({"a", "b"}, {"x", "yy"},
+                 {{"a", {{"x", "b"}, {"yy", "a"}}},
+                  {"b", {{"x", "a"}, {"yy", "b"}}}},
+                 "a", {"b"});
+  CodeGeneratorOptions options;
+  options.style = CodeGeneratorOptions::TABLE;
+  std::stringstream ss;
+  writeCppMatcher(dfa, ss, options);
+  auto code = ss.str();
+  ASSERT_NE(code.find("static const std::int8_t next[2][2] = {"),
+            std::string::npos);
+  ASSERT_NE(code.find("if (symbol < 0 || symbol >= 2) {"),
+            std::string::npos);
+  ASSERT_NE(code.find("std::string(\"yy\", 2)"), std::string::npos);
+  ASSERT_EQ(code.find("const char *input"), std::string::npos);
+}
+
+TEST_F(CodeGeneratorTest, test_invalid_names) {
+  // Should reject names that are not identifiers.
+  CodeGeneratorOptions options;
+  options.functionName = "1match";
+  std::stringstream ss;
+  ASSERT_THROW(writeCppMatcher(dfa, ss, options), AutomatonException);
+  options.functionName = "match";
+  options.namespaceName = "a::";
+  ASSERT_THROW(writeCppMatcher(dfa, ss, options), AutomatonException);
+}
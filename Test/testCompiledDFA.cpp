@@ -0,0 +1,77 @@
+#include "CompiledDFA.hpp"
+#include "RandomAutomata.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+
+using namespace CXXAUTOMATA;
+
+class CompiledDFATest : public FATest {
+protected:
+  /**
+   * @brief Words over {0, 1, 2, 3} whose last symbol is 0 or 1, where 2
+   *        and 3 (and 0 and 1) are interchangeable.
+   *
+   */
+  static DFA lastLow() {
+    Paths paths = {{"0", "low"}, {"1", "low"}, {"2", "high"}, {"3", "high"}};
+    return DFA({"start", "low", "high"}, {"0", "1", "2", "3"},
+               {{"start", paths}, {"low", paths}, {"high", paths}}, "start",
+               {"low"});
+  }
+};
+
+TEST_F(CompiledDFATest, test_symbol_classes) {
+  // Should group symbols that lead every state to the same state.
+  std::vector<InputSymbols> expected = {{"0", "1"}, {"2", "3"}};
+  ASSERT_EQ(lastLow().symbolClasses(), expected);
+  std::vector<InputSymbols> separate = {{"0"}, {"1"}};
+  ASSERT_EQ(dfa.symbolClasses(), separate);
+}
+
+TEST_F(CompiledDFATest, test_rows_deduplicated) {
+  // Should store identical rows once.
+  CompiledDFA compiled(lastLow());
+  ASSERT_EQ(compiled.getStateCount(), 3u);
+  ASSERT_EQ(compiled.getClassCount(), 2u);
+  ASSERT_EQ(compiled.getRowCount(), 1u);
+  ASSERT_EQ(compiled.denseTableBytes(), 3 * 4 * sizeof(StateId));
+  ASSERT_TRUE(compiled.acceptsInput({"3", "1"}));
+  ASSERT_FALSE(compiled.acceptsInput({"0", "2"}));
+  ASSERT_FALSE(compiled.acceptsInput({"4"}));
+  ASSERT_EQ(compiled.getStateName(compiled.readInput({"2"})), "high");
+}
+
+TEST_F(CompiledDFATest, test_same_language) {
+  // Should accept exactly the words the DFA accepts.
+  for (uint64_t seed = 0; seed < 10; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    double density = seed % 2 == 0 ? 1.0 : 0.5;
+    auto random = generator.randomDFA(5 + seed, 3, 0.4, density);
+    CompiledDFA compiled(random);
+    std::function<void(InputSymbols_v &)> check = [&](InputSymbols_v &word) {
+      ASSERT_EQ(compiled.acceptsInput(word), random.acceptsInput(word));
+      if (word.size() == 5) {
+        return;
+      }
+      for (auto &symbol : random.getInputSymbols()) {
+        word.push_back(symbol);
+        check(word);
+        word.pop_back();
+      }
+    };
+    InputSymbols_v word;
+    check(word);
+  }
+}
+
+TEST_F(CompiledDFATest, test_long_symbols) {
+  // Should look up symbols longer than one character.
+  auto dfa = DFA({"a", "b"}, {"x", "yy"},
+                 {{"a", {{"x", "b"}, {"yy", "a"}}},
+                  {"b", {{"x", "a"}, {"yy", "b"}}}},
+                 "a", {"b"});
+  CompiledDFA compiled(dfa);
+  ASSERT_TRUE(compiled.acceptsInput({"yy", "x", "yy"}));
+  ASSERT_EQ(compiled.symbolClass("y"), NO_CLASS);
+  ASSERT_EQ(compiled.getRowCount(), 2u);
+}
@@ -0,0 +1,111 @@
+#include "CompiledDFA.hpp"
+#include "Exceptions.hpp"
+#include "RandomAutomata.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class ConcurrentMatchingTest : public FATest {
+protected:
+  static const std::size_t THREADS = 16;
+
+  /**
+   * @brief Random words over inputSymbols, some of them with a symbol
+   *        outside it.
+   *
+   */
+  static std::vector<InputSymbols_v>
+  randomWords(const InputSymbols &inputSymbols, std::size_t count) {
+    InputSymbols_v symbols(inputSymbols.begin(), inputSymbols.end());
+    std::mt19937_64 rng(7);
+    std::vector<InputSymbols_v> words(count);
+    for (auto &word : words) {
+      word.resize(rng() % 24);
+      for (auto &symbol : word) {
+        symbol = rng() % 50 == 0 ? "?" : symbols[rng() % symbols.size()];
+      }
+    }
+    return words;
+  }
+
+  /**
+   * @brief Run match on every word from THREADS threads at once and return
+   *        the number of results that differ from expected.
+   *
+   */
+  template <typename Match>
+  static std::size_t mismatches(const std::vector<InputSymbols_v> &words,
+                                const std::vector<bool> &expected,
+                                Match match) {
+    std::vector<std::size_t> counts(THREADS, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < THREADS; t++) {
+      threads.emplace_back([&, t]() {
+        for (std::size_t round = 0; round < 4; round++) {
+          for (std::size_t i = 0; i < words.size(); i++) {
+            counts[t] += match(words[i]) != expected[i];
+          }
+        }
+      });
+    }
+    std::size_t total = 0;
+    for (std::size_t t = 0; t < THREADS; t++) {
+      threads[t].join();
+      total += counts[t];
+    }
+    return total;
+  }
+};
+
+TEST_F(ConcurrentMatchingTest, test_shared_dfa) {
+  // Should give every thread the sequential results on one const DFA.
+  RandomAutomatonGenerator generator(3);
+  const DFA shared = generator.randomDFA(200, 4, 0.5, 0.9);
+  auto words = randomWords(shared.getInputSymbols(), 500);
+  std::vector<bool> expected;
+  for (auto &word : words) {
+    expected.push_back(shared.acceptsInput(word));
+  }
+  ASSERT_EQ(mismatches(words, expected,
+                       [&](const InputSymbols_v &word) {
+                         return shared.acceptsInput(word);
+                       }),
+            0u);
+  ASSERT_EQ(mismatches(words, expected,
+                       [&](const InputSymbols_v &word) {
+                         try {
+                           State last = shared.readInput(word);
+                           return shared.getFinalStates().count(last) > 0;
+                         } catch (const RejectionException &) {
+                           return false;
+                         }
+                       }),
+            0u);
+  const CompiledDFA compiled(shared);
+  ASSERT_EQ(mismatches(words, expected,
+                       [&](const InputSymbols_v &word) {
+                         return compiled.acceptsInput(word);
+                       }),
+            0u);
+}
+
+TEST_F(ConcurrentMatchingTest, test_shared_nfa) {
+  // Should give every thread the sequential results on one const NFA.
+  RandomAutomatonGenerator generator(5);
+  const NFA shared = generator.randomNFA(20, 3, 0.3, 1.2, 0.2);
+  auto words = randomWords(shared.getInputSymbols(), 200);
+  std::vector<bool> expected;
+  for (auto &word : words) {
+    expected.push_back(shared.acceptsInput(word));
+  }
+  const Automaton &automaton = shared;
+  ASSERT_EQ(mismatches(words, expected,
+                       [&](const InputSymbols_v &word) {
+                         return automaton.acceptsInput(word);
+                       }),
+            0u);
+}
@@ -0,0 +1,126 @@
+#include "DAWGBuilder.hpp"
+#include "Exceptions.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class DAWGBuilderTest : public FATest {
+public:
+  static InputSymbols_v symbolsOf(const std::string &word) {
+    InputSymbols_v symbols;
+    for (char c : word) {
+      symbols.push_back(std::string(1, c));
+    }
+    return symbols;
+  }
+};
+
+TEST_F(DAWGBuilderTest, test_build_minimal_dawg) {
+  // Should build the minimal DFA accepting exactly the given words.
+  DAWGBuilder builder;
+  for (std::string word : {"tap", "taps", "top", "tops"}) {
+    builder.add(word);
+  }
+  ASSERT_EQ(builder.getWordCount(), 4u);
+  DFA dawg = builder.build();
+  ASSERT_EQ(dawg.getStates().size(), 5u);
+  ASSERT_EQ(dawg.getInitialState(), "q0");
+  ASSERT_TRUE(dawg.getAllowPartial());
+  ASSERT_EQ(dawg.getInputSymbols(), InputSymbols({"a", "o", "p", "s", "t"}));
+  for (std::string word : {"tap", "taps", "top", "tops"}) {
+    ASSERT_TRUE(dawg.acceptsInput(symbolsOf(word)));
+  }
+  for (std::string word : {"", "t", "ta", "to", "tas", "tapss", "pot"}) {
+    ASSERT_FALSE(dawg.acceptsInput(symbolsOf(word)));
+  }
+  ASSERT_EQ(builder.getWordCount(), 0u);
+}
+
+TEST_F(DAWGBuilderTest, test_empty_and_empty_word) {
+  // Should accept nothing without words, and the empty word if added.
+  DAWGBuilder builder;
+  DFA empty = builder.build();
+  ASSERT_EQ(empty.getStates(), States({"q0"}));
+  ASSERT_TRUE(empty.isEmpty());
+
+  builder.add(std::string());
+  builder.add(InputSymbols_v({"ab", "cd"}));
+  DFA dawg = builder.build();
+  ASSERT_TRUE(dawg.acceptsInput({}));
+  ASSERT_TRUE(dawg.acceptsInput({"ab", "cd"}));
+  ASSERT_FALSE(dawg.acceptsInput({"ab"}));
+  ASSERT_EQ(dawg.getInputSymbols(), InputSymbols({"ab", "cd"}));
+}
+
+TEST_F(DAWGBuilderTest, test_unsorted_words) {
+  // Should ignore repeated words and reject words out of order.
+  DAWGBuilder builder;
+  builder.add("ab");
+  builder.add("ab");
+  ASSERT_EQ(builder.getWordCount(), 1u);
+  ASSERT_THROW(builder.add("aa"), AutomatonException);
+  ASSERT_THROW(builder.add("a"), AutomatonException);
+  builder.add("abc");
+  builder.add("b");
+  DFA dawg = builder.build();
+  ASSERT_TRUE(dawg.acceptsInput({"a", "b"}));
+  ASSERT_TRUE(dawg.acceptsInput({"a", "b", "c"}));
+  ASSERT_TRUE(dawg.acceptsInput({"b"}));
+  ASSERT_FALSE(dawg.acceptsInput({"a", "a"}));
+}
+
+TEST_F(DAWGBuilderTest, test_rejected_words_add_no_symbols) {
+  // Should leave the alphabet unchanged when a word is rejected.
+  DAWGBuilder builder;
+  builder.add("bc");
+  ASSERT_THROW(builder.add("ax"), AutomatonException);
+  ASSERT_THROW(builder.add(InputSymbols_v({"a", "yy"})), AutomatonException);
+  builder.add("bcd");
+  ASSERT_EQ(builder.build().getInputSymbols(),
+            InputSymbols({"b", "c", "d"}));
+}
+
+TEST_F(DAWGBuilderTest, test_random_word_lists_are_minimal) {
+  // Should accept exactly the word list with no more states than the
+  // minimized DFA of the same language.
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<int> length(0, 8);
+  std::uniform_int_distribution<int> letter('a', 'c');
+  for (int round = 0; round < 10; round++) {
+    std::set<std::string> words;
+    for (int i = 0; i < 300; i++) {
+      std::string word;
+      for (int n = length(rng); n > 0; n--) {
+        word += static_cast<char>(letter(rng));
+      }
+      words.insert(word);
+    }
+    DAWGBuilder builder;
+    for (auto &word : words) {
+      builder.add(word);
+    }
+    DFA dawg = builder.build();
+    ASSERT_EQ(dawg.minify(false).getStates().size(), dawg.getStates().size());
+    ASSERT_TRUE(dawg.isFinite());
+
+    // Every word of length up to 8 over {a, b, c}
+    std::vector<std::string> all(1, "");
+    for (std::size_t i = 0; i < all.size(); i++) {
+      if (all[i].size() < 8) {
+        for (char c : {'a', 'b', 'c'}) {
+          all.push_back(all[i] + c);
+        }
+      }
+    }
+    for (auto &word : all) {
+      ASSERT_EQ(dawg.acceptsInput(symbolsOf(word)), words.count(word) == 1)
+          << word;
+    }
+  }
+}
@@ -2,6 +2,8 @@
 #include "Typedefs.hpp"
 #include "testFA.cpp"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <sstream>
 
 class DFATest : public FATest {};
 
@@ -99,6 +101,44 @@ TEST_F(DFATest, test_validate_invalid_final_state) {
                InvalidStateException);
 }
 
+TEST_F(DFATest, test_validate_all) {
+  // Should report every violation, the first one being what validate throws.
+  auto result = DFA::tryCreate({"q0", "q1", "q2"}, {"0", "1"},
+                               {{"q0", {{"0", "q0"}, {"1", "q1"}}},
+                                {"q1", {{"0", "q3"}, {"2", "q1"}}}},
+                               "q4", {"q1", "q5"});
+  ASSERT_FALSE(result.isValid());
+  ASSERT_EQ(result.release(), nullptr);
+  auto &issues = result.getValidation().getIssues();
+  std::vector<ValidationError> errors;
+  for (auto &issue : issues) {
+    errors.push_back(issue.error);
+  }
+  ASSERT_EQ(errors, std::vector<ValidationError>(
+                        {MISSING_TRANSITION_START_STATE,
+                         MISSING_TRANSITION_SYMBOL, INVALID_TRANSITION_SYMBOL,
+                         INVALID_TRANSITION_END_STATE, INVALID_INITIAL_STATE,
+                         INVALID_FINAL_STATE}));
+  ASSERT_EQ(issues[3].state, "q1");
+  ASSERT_EQ(issues[3].symbol, "0");
+  ASSERT_EQ(issues[3].endState, "q3");
+  ASSERT_EQ(issues[3].message(),
+            "end state q3 for transition on q1 is invalid");
+  ASSERT_THROW(result.get(), MissingStateException);
+  ASSERT_EQ(result.getValidation().messages().front(),
+            "transition start state q2 is missing");
+
+  auto valid = DFA::tryCreate({"q0"}, {"0"}, {{"q0", {{"0", "q0"}}}}, "q0",
+                              {"q0"});
+  ASSERT_TRUE(valid.isValid());
+  ASSERT_TRUE(valid.getValidation().isValid());
+  ASSERT_TRUE(valid.get().acceptsInput({"0", "0"}));
+  ASSERT_NE(valid.release(), nullptr);
+  ASSERT_FALSE(valid.isValid());
+  ASSERT_THROW(valid.get(), AutomatonException);
+  ASSERT_TRUE(dfa.validateAll().isValid());
+}
+
 TEST_F(DFATest, test_read_input_accepted) {
   // Should return correct state if acceptable DFA input is given.
   InputSymbols_v inputSymbols = {"0", "1", "1", "1"};
@@ -423,4 +463,189 @@ TEST_F(DFATest, test_symmetric_difference) {
   States expected_final_states = {"q0,p0", "q0,p1", "q1,p0", "q1,p1", "q2,p0",
                                   "q2,p1", "q3,p0", "q3,p1", "q4,p2"};
   ASSERT_EQ(new_dfa.getFinalStates(), expected_final_states);
-}
\ No newline at end of file
+}
+
+TEST_F(DFATest, test_diagram_merges_parallel_edges) {
+  // Should draw one edge per state pair with symbol-range labels.
+  auto letters = DFA({"q0", "q1"}, {"a", "b", "c", "d", "x"},
+                     {{"q0",
+                       {{"a", "q1"},
+                        {"b", "q1"},
+                        {"c", "q1"},
+                        {"d", "q0"},
+                        {"x", "q1"}}},
+                      {"q1",
+                       {{"a", "q0"},
+                        {"b", "q0"},
+                        {"c", "q1"},
+                        {"d", "q1"},
+                        {"x", "q1"}}}},
+                     "q0", {"q1"});
+  auto dot = letters.toDot();
+  ASSERT_NE(dot.find("\"q0\" -> \"q1\" [label = \"a-c,x\"];"),
+            std::string::npos);
+  ASSERT_NE(dot.find("\"q0\" -> \"q0\" [label = \"d\"];"), std::string::npos);
+  ASSERT_NE(dot.find("\"q1\" -> \"q0\" [label = \"a,b\"];"),
+            std::string::npos);
+  ASSERT_NE(dot.find("\"q1\" [shape = doublecircle];"), std::string::npos);
+  ASSERT_EQ(std::count(dot.begin(), dot.end(), '>'), 5);
+}
+
+TEST_F(DFATest, test_diagram_core) {
+  // Should only draw states that are accessible and co-accessible.
+  auto partial = DFA({"q0", "q1", "q2", "q3"}, {"0", "1"},
+                     {{"q0", {{"0", "q1"}, {"1", "q2"}}},
+                      {"q1", {{"0", "q1"}}},
+                      {"q2", {}},
+                      {"q3", {{"0", "q1"}}}},
+                     "q0", {"q1"}, true);
+  DiagramOptions options;
+  options.scope = DiagramOptions::CORE;
+  auto dot = partial.toDot(options);
+  ASSERT_NE(dot.find("\"q0\" -> \"q1\""), std::string::npos);
+  ASSERT_EQ(dot.find("q2"), std::string::npos);
+  ASSERT_EQ(dot.find("q3"), std::string::npos);
+}
+
+TEST_F(DFATest, test_diagram_neighbourhood) {
+  // Should only draw states close to the center state.
+  auto chain = DFA({"q0", "q1", "q2", "q3"}, {"0"},
+                   {{"q0", {{"0", "q1"}}},
+                    {"q1", {{"0", "q2"}}},
+                    {"q2", {{"0", "q3"}}},
+                    {"q3", {{"0", "q3"}}}},
+                   "q0", {"q3"});
+  DiagramOptions options;
+  options.scope = DiagramOptions::NEIGHBOURHOOD;
+  options.center = "q2";
+  options.radius = 1;
+  std::stringstream ss;
+  chain.writeDiagram(ss, options);
+  auto dot = ss.str();
+  ASSERT_EQ(dot.find("q0"), std::string::npos);
+  ASSERT_EQ(dot.find("__start"), std::string::npos);
+  ASSERT_NE(dot.find("\"q1\" -> \"q2\""), std::string::npos);
+  ASSERT_NE(dot.find("\"q3\" -> \"q3\""), std::string::npos);
+  options.center = "q4";
+  EXPECT_THROW(chain.toDot(options), InvalidStateException);
+}
+
+TEST_F(DFATest, test_is_finite) {
+  // Should detect whether the accepted language is finite.
+  auto finite = DFA({"q0", "q1", "q2"}, {"0", "1"},
+                    {{"q0", {{"0", "q1"}, {"1", "q2"}}},
+                     {"q1", {{"0", "q2"}, {"1", "q2"}}},
+                     {"q2", {{"0", "q2"}, {"1", "q2"}}}},
+                    "q0", {"q0", "q1"});
+  ASSERT_TRUE(finite.isFinite());
+  ASSERT_FALSE(dfa.isFinite());
+}
+
+TEST_F(DFATest, test_union_different_alphabets) {
+  // Should join over the union alphabet with an implicit dead state.
+  auto even = DFA({"q0", "q1"}, {"a"},
+                  {{"q0", {{"a", "q1"}}}, {"q1", {{"a", "q0"}}}}, "q0",
+                  {"q0"});
+  auto hasB = DFA({"p0", "p1"}, {"a", "b"},
+                  {{"p0", {{"a", "p0"}, {"b", "p1"}}},
+                   {"p1", {{"a", "p1"}, {"b", "p1"}}}},
+                  "p0", {"p1"});
+  auto new_dfa = even.unionJoin(hasB, false, false);
+  States expected_states = {",p0", ",p1", "q0,p0",
+                            "q0,p1", "q1,p0", "q1,p1"};
+  ASSERT_EQ(new_dfa.getStates(), expected_states);
+  InputSymbols expected_input_symbols = {"a", "b"};
+  ASSERT_EQ(new_dfa.getInputSymbols(), expected_input_symbols);
+  Transitions expected_transition = {
+      {",p0", {{"a", ",p0"}, {"b", ",p1"}}},
+      {",p1", {{"a", ",p1"}, {"b", ",p1"}}},
+      {"q0,p0", {{"a", "q1,p0"}, {"b", ",p1"}}},
+      {"q0,p1", {{"a", "q1,p1"}, {"b", ",p1"}}},
+      {"q1,p0", {{"a", "q0,p0"}, {"b", ",p1"}}},
+      {"q1,p1", {{"a", "q0,p1"}, {"b", ",p1"}}}};
+  ASSERT_EQ(new_dfa.getTransitions(), expected_transition);
+  ASSERT_EQ(new_dfa.getInitialState(), "q0,p0");
+  States expected_final_states = {",p1", "q0,p0", "q0,p1", "q1,p1"};
+  ASSERT_EQ(new_dfa.getFinalStates(), expected_final_states);
+}
+
+TEST_F(DFATest, test_products_different_alphabets) {
+  // Should agree with and without minify and skip pairs of dead states.
+  auto even = DFA({"q0", "q1"}, {"a"},
+                  {{"q0", {{"a", "q1"}}}, {"q1", {{"a", "q0"}}}}, "q0",
+                  {"q0"});
+  auto bThenC = DFA({"p0", "p1", "p2"}, {"b", "c"},
+                    {{"p0", {{"b", "p1"}}}, {"p1", {{"c", "p2"}}}, {"p2", {}}},
+                    "p0", {"p2"}, true);
+  std::vector<InputSymbols_v> words = {
+      {}, {"a"}, {"a", "a"}, {"b"}, {"b", "c"}, {"a", "b"}, {"b", "a"}};
+  for (bool minify : {false, true}) {
+    auto joined = even.unionJoin(bThenC, false, minify);
+    auto both = even.intersection(bThenC, false, minify);
+    auto left = even.difference(bThenC, false, minify);
+    auto right = bThenC.difference(even, false, minify);
+    auto either = even.symmetricDifference(bThenC, false, minify);
+    InputSymbols expected_input_symbols = {"a", "b", "c"};
+    ASSERT_EQ(joined.getInputSymbols(), expected_input_symbols);
+    ASSERT_EQ(both.getInputSymbols(), expected_input_symbols);
+    ASSERT_FALSE(joined.getStates().count(","));
+    for (auto &word : words) {
+      bool inEven = even.acceptsInput(word);
+      bool inBThenC = bThenC.acceptsInput(word);
+      ASSERT_EQ(joined.acceptsInput(word), inEven || inBThenC);
+      ASSERT_EQ(both.acceptsInput(word), inEven && inBThenC);
+      ASSERT_EQ(left.acceptsInput(word), inEven && !inBThenC);
+      ASSERT_EQ(right.acceptsInput(word), inBThenC && !inEven);
+      ASSERT_EQ(either.acceptsInput(word), inEven != inBThenC);
+    }
+  }
+  // (aa)* or bc needs five live states; the dead state is never added.
+  ASSERT_EQ(even.unionJoin(bThenC, true).getStates().size(), 5u);
+  // The cross product pairs each side's dead state with the other's states.
+  ASSERT_EQ(even.unionJoin(bThenC, false, false).getStates().size(), 11u);
+
+  // The complement names its sink "", the name of a dead side.
+  auto as = DFA({"q0"}, {"a"}, {}, "q0", {}, true).complement();
+  auto bs = DFA({"p0"}, {"b"}, {{"p0", {{"b", "p0"}}}}, "p0", {"p0"});
+  ASSERT_TRUE(as.getStates().count(""));
+  for (bool minify : {false, true}) {
+    auto both = as.intersection(bs, false, minify);
+    auto either = as.unionJoin(bs, true, minify);
+    ASSERT_TRUE(both.acceptsInput({}));
+    ASSERT_FALSE(both.acceptsInput({"b"}));
+    ASSERT_TRUE(either.acceptsInput({"b", "b"}));
+    ASSERT_FALSE(either.acceptsInput({"b", "a"}));
+  }
+  ASSERT_TRUE(as.unionJoin(bs, true, false).getStates().count(",'"));
+}
+
+TEST_F(DFATest, test_partial_operations) {
+  // Should treat missing transitions and states as an implicit dead state.
+  auto sparse = DFA({"q0", "q1", "q2"}, {"a", "b", "c"},
+                    {{"q0", {{"a", "q1"}}}, {"q1", {{"b", "q0"}, {"c", "q2"}}}},
+                    "q0", {"q2"}, true);
+  ASSERT_TRUE(sparse.acceptsInput({"a", "c"}));
+  ASSERT_TRUE(sparse.acceptsInput({"a", "b", "a", "c"}));
+  EXPECT_THROW(sparse.readInput({"a", "c", "a"}), RejectionException);
+  EXPECT_THROW(sparse.readInput({"b"}), RejectionException);
+  ASSERT_FALSE(sparse.isEmpty());
+  ASSERT_FALSE(sparse.isFinite());
+  ASSERT_TRUE(sparse.difference(sparse).isEmpty());
+
+  auto minimal = sparse.minify();
+  ASSERT_EQ(minimal.getStates().size(), 3u);
+  ASSERT_TRUE(minimal.getAllowPartial());
+  ASSERT_TRUE(minimal == sparse);
+
+  auto complement = sparse.complement();
+  ASSERT_EQ(complement.getStates().size(), 4u);
+  ASSERT_FALSE(complement.getAllowPartial());
+  ASSERT_TRUE(complement.acceptsInput({"b"}));
+  ASSERT_TRUE(complement.acceptsInput({"a", "c", "a"}));
+  ASSERT_FALSE(complement.acceptsInput({"a", "b", "a", "c"}));
+  ASSERT_TRUE(sparse.isDisjoint(complement));
+
+  auto dot = sparse.toDot();
+  ASSERT_NE(dot.find("\"q1\" -> \"q2\" [label = \"c\"];"),
+            std::string::npos);
+}
@@ -3,6 +3,8 @@
 #include "DFA.hpp"
 #include "FA.hpp"
 #include "NFA.hpp"
+#include <cstddef>
+#include <vector>
 
 using CXXAUTOMATA::DFA;
 
@@ -56,6 +58,27 @@ public:
         ASSERT_EQ(first.getFinalStates(), second.getFinalStates());
     }
 
+    /**
+     * @brief Return every word over alphabet of at most maxLength symbols,
+     *        ordered by length, then lexicographically.
+     *
+     */
+    static std::vector<CXXAUTOMATA::InputSymbols_v>
+    words(const CXXAUTOMATA::InputSymbols &alphabet, std::size_t maxLength) {
+        std::vector<CXXAUTOMATA::InputSymbols_v> result(1);
+        for (std::size_t i = 0; i < result.size(); i++) {
+            if (result[i].size() == maxLength) {
+                continue;
+            }
+            for (auto &symbol : alphabet) {
+                CXXAUTOMATA::InputSymbols_v word = result[i];
+                word.push_back(symbol);
+                result.push_back(word);
+            }
+        }
+        return result;
+    }
+
     DFA dfa;
   // CXXAUTOMATA::NFA nfa;
 };
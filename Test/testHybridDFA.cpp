@@ -0,0 +1,119 @@
+#include "HybridDFA.hpp"
+#include "RandomAutomata.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <functional>
+#include <string>
+
+using namespace CXXAUTOMATA;
+
+class HybridDFATest : public FATest {
+protected:
+  /**
+   * @brief Over the 26 letters, a hub state going to a state per letter,
+   *        which returns to the hub on its own letter, sends "z" to a
+   *        trap and everything else back to itself.
+   *
+   */
+  static DFA hub() {
+    InputSymbols symbols;
+    States states = {"hub", "trap"};
+    Transitions transitions;
+    for (char letter = 'a'; letter <= 'z'; letter++) {
+      symbols.insert(std::string(1, letter));
+    }
+    for (auto &symbol : symbols) {
+      State state = "s" + symbol;
+      states.insert(state);
+      transitions["hub"][symbol] = state;
+      for (auto &other : symbols) {
+        transitions[state][other] = state;
+      }
+      transitions[state][symbol] = "hub";
+      transitions[state]["z"] = "trap";
+    }
+    transitions["trap"] = {{"a", "hub"}};
+    return DFA(states, symbols, transitions, "hub", {"hub"}, true);
+  }
+};
+
+TEST_F(HybridDFATest, test_row_kinds) {
+  // Should store every state in the encoding that needs the fewest
+  // entries.
+  HybridDFA hybrid(hub());
+  ASSERT_EQ(hybrid.getStateCount(), 28u);
+  StateId start = hybrid.getInitialState();
+  ASSERT_EQ(hybrid.getStateName(start), "hub");
+  ASSERT_EQ(hybrid.getRowKind(start), HybridDFA::RowKind::DENSE);
+  StateId a = hybrid.nextState(start, hybrid.symbolId("a"));
+  ASSERT_EQ(hybrid.getStateName(a), "sa");
+  ASSERT_EQ(hybrid.getRowKind(a), HybridDFA::RowKind::DEFAULT);
+  StateId trap = hybrid.nextState(a, hybrid.symbolId("z"));
+  ASSERT_EQ(hybrid.getRowKind(trap), HybridDFA::RowKind::SPARSE);
+  ASSERT_EQ(hybrid.getRowCount(HybridDFA::RowKind::DENSE), 1u);
+  ASSERT_EQ(hybrid.getRowCount(HybridDFA::RowKind::DEFAULT), 26u);
+  ASSERT_EQ(hybrid.getRowCount(HybridDFA::RowKind::SPARSE), 1u);
+  ASSERT_LT(hybrid.tableBytes(), hybrid.denseTableBytes());
+
+  HybridDFA dense(hub(), 0);
+  ASSERT_EQ(dense.getRowCount(HybridDFA::RowKind::DENSE), 28u);
+}
+
+TEST_F(HybridDFATest, test_lookups) {
+  // Should follow defaults, exceptions and missing transitions.
+  DFA candidate = hub();
+  HybridDFA hybrid(candidate);
+  StateId id = 0;
+  for (auto &state : candidate.getStates()) {
+    ASSERT_EQ(hybrid.getStateName(id), state);
+    auto &paths = candidate.getTransitions().at(state);
+    for (auto &symbol : candidate.getInputSymbols()) {
+      StateId target = hybrid.nextState(id, hybrid.symbolId(symbol));
+      auto path = paths.find(symbol);
+      if (path == paths.end()) {
+        ASSERT_EQ(target, NO_STATE);
+      } else {
+        ASSERT_EQ(hybrid.getStateName(target), path->second);
+      }
+    }
+    id++;
+  }
+  ASSERT_TRUE(hybrid.acceptsInput({"b", "c", "b"}));
+  ASSERT_FALSE(hybrid.acceptsInput({"b", "z", "b"}));
+  ASSERT_TRUE(hybrid.acceptsInput({"b", "z", "a"}));
+  ASSERT_FALSE(hybrid.acceptsInput({"1"}));
+  ASSERT_EQ(hybrid.symbolId("1"), NO_SYMBOL);
+  ASSERT_EQ(hybrid.readInput({"z", "z", "z"}), NO_STATE);
+
+  // No row has exceptions, so their table is empty.
+  HybridDFA stuck(DFA({"s"}, {"a"}, {}, "s", {"s"}, true));
+  ASSERT_EQ(stuck.getRowKind(0), HybridDFA::RowKind::SPARSE);
+  ASSERT_EQ(stuck.nextState(0, 0), NO_STATE);
+  ASSERT_TRUE(stuck.acceptsInput({}));
+}
+
+TEST_F(HybridDFATest, test_same_language) {
+  // Should accept exactly the words the DFA accepts.
+  for (uint64_t seed = 0; seed < 10; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    double density = seed % 2 == 0 ? 1.0 : 0.3;
+    auto random = generator.randomDFA(5 + seed, 4, 0.4, density);
+    HybridDFA hybrid(random, seed % 3);
+    std::function<void(InputSymbols_v &)> check = [&](InputSymbols_v &word) {
+      ASSERT_EQ(hybrid.acceptsInput(word), random.acceptsInput(word));
+      if (word.size() == 4) {
+        return;
+      }
+      for (auto &symbol : random.getInputSymbols()) {
+        word.push_back(symbol);
+        check(word);
+        word.pop_back();
+      }
+    };
+    InputSymbols_v word;
+    check(word);
+  }
+  HybridDFA fixture(dfa);
+  ASSERT_TRUE(fixture.acceptsInput({"0", "1"}));
+  ASSERT_FALSE(fixture.acceptsInput({"1", "1"}));
+}
@@ -0,0 +1,103 @@
+#include "DAWGBuilder.hpp"
+#include "Exceptions.hpp"
+#include "Lexer.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class LexerTest : public FATest {
+public:
+  /**
+   * @brief Partial DFA accepting one or more characters of chars.
+   *
+   */
+  static DFA oneOrMore(const std::string &chars) {
+    InputSymbols symbols;
+    Paths paths;
+    for (char c : chars) {
+      symbols.insert(std::string(1, c));
+      paths[std::string(1, c)] = "more";
+    }
+    return DFA({"start", "more"}, symbols,
+               {{"start", paths}, {"more", paths}}, "start", {"more"}, true);
+  }
+
+  /**
+   * @brief Partial DFA accepting exactly the given words.
+   *
+   */
+  static DFA words(std::vector<std::string> list) {
+    DAWGBuilder builder;
+    std::sort(list.begin(), list.end());
+    for (auto &word : list) {
+      builder.add(word);
+    }
+    return builder.build();
+  }
+
+  enum { KEYWORD, IDENTIFIER, NUMBER, SPACE, OPERATOR };
+
+  LexerTest()
+      : lexer({words({"if", "else"}), oneOrMore("abcdefghijklmnopqrstuvwxyz"),
+               oneOrMore("0123456789"), oneOrMore(" "),
+               words({"=", "==", "<", "<="})}) {}
+
+  Lexer lexer;
+};
+
+TEST_F(LexerTest, test_longest_match_and_priority) {
+  // Should prefer the longest match, then the earliest token type.
+  std::string input = "if iffy==12 else<=x";
+  auto tokens = lexer.tokenize(input);
+  std::vector<std::pair<TokenType, std::string>> found;
+  for (auto &token : tokens) {
+    found.emplace_back(token.type, input.substr(token.offset, token.length));
+  }
+  std::vector<std::pair<TokenType, std::string>> expected = {
+      {KEYWORD, "if"},  {SPACE, " "},     {IDENTIFIER, "iffy"},
+      {OPERATOR, "=="}, {NUMBER, "12"},   {SPACE, " "},
+      {KEYWORD, "else"}, {OPERATOR, "<="}, {IDENTIFIER, "x"}};
+  ASSERT_EQ(found, expected);
+}
+
+TEST_F(LexerTest, test_stop_without_token) {
+  // Should stop where no token starts, and tokenize should throw there.
+  std::string input = "ab 12+3";
+  std::vector<Token> tokens;
+  ASSERT_EQ(lexer.scan(input.data(), input.size(), tokens), 5u);
+  ASSERT_EQ(tokens.size(), 3u);
+  ASSERT_THROW(lexer.tokenize(input), RejectionException);
+  ASSERT_TRUE(lexer.tokenize("").empty());
+
+  Token token;
+  ASSERT_FALSE(lexer.nextToken(input.data(), input.size(), 5, token));
+  ASSERT_TRUE(lexer.nextToken(input.data(), input.size(), 6, token));
+  ASSERT_EQ(token.type, static_cast<TokenType>(NUMBER));
+  ASSERT_EQ(token.offset, 6u);
+  ASSERT_EQ(token.length, 1u);
+}
+
+TEST_F(LexerTest, test_dead_states_are_dropped) {
+  // Should not keep complete token DFAs running in their sink state.
+  DFA complete({"start", "a", "sink"}, {"a", "b"},
+               {{"start", {{"a", "a"}, {"b", "sink"}}},
+                {"a", {{"a", "sink"}, {"b", "sink"}}},
+                {"sink", {{"a", "sink"}, {"b", "sink"}}}},
+               "start", {"a"});
+  Lexer single({complete, oneOrMore("b")});
+  ASSERT_EQ(single.getTokenTypeCount(), 2u);
+  // start, after "a", after "b"
+  ASSERT_EQ(single.getStateCount(), 3u);
+  ASSERT_EQ(single.getAcceptedType(0), NO_TOKEN);
+  ASSERT_EQ(single.tokenize("abba").size(), 3u);
+}
+
+TEST_F(LexerTest, test_multi_character_symbols) {
+  // Should reject token DFAs whose symbols are not single characters.
+  DFA dfa({"q0"}, {"ab"}, {{"q0", {{"ab", "q0"}}}}, "q0", {"q0"});
+  ASSERT_THROW(Lexer({dfa}), InvalidSymbolException);
+}
@@ -0,0 +1,140 @@
+#include "BinaryFormat.hpp"
+#include "Exceptions.hpp"
+#include "MappedDFA.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+
+class MappedDFATest : public FATest {
+protected:
+  virtual void TearDown() { std::remove(path.c_str()); }
+
+  std::string path = "testMappedDFA.bin";
+};
+
+using namespace CXXAUTOMATA;
+
+TEST_F(MappedDFATest, test_round_trip) {
+  // Should rebuild the same DFA from the mapped file.
+  saveBinaryDFA(dfa, path);
+  MappedDFA mapped(path);
+  ASSERT_EQ(mapped.getStateCount(), 3u);
+  ASSERT_EQ(mapped.getSymbolCount(), 2u);
+  FATest::assertIsCopy(mapped.toDFA(), dfa);
+}
+
+TEST_F(MappedDFATest, test_read_input) {
+  // Should match directly from the mapped table.
+  saveBinaryDFA(dfa, path);
+  MappedDFA mapped(path);
+  ASSERT_EQ(mapped.readInput({"0", "1", "1", "1"}), "q1");
+  ASSERT_TRUE(mapped.acceptsInput({"0", "1", "1", "1"}));
+  ASSERT_FALSE(mapped.acceptsInput({"0", "1", "0"}));
+  ASSERT_FALSE(mapped.acceptsInput({"0", "1", "2"}));
+  EXPECT_THROW(mapped.readInput({"0", "1", "0"}), RejectionException);
+  EXPECT_THROW(mapped.readInput({"2"}), RejectionException);
+}
+
+TEST_F(MappedDFATest, test_partial_dfa) {
+  // Should keep missing transitions of a partial DFA.
+  auto partial = DFA({"q0", "q1"}, {"a", "b"},
+                     {{"q0", {{"a", "q1"}}}, {"q1", {{"b", "q0"}}}}, "q0",
+                     {"q1"}, true);
+  saveBinaryDFA(partial, path);
+  MappedDFA mapped(path);
+  ASSERT_TRUE(mapped.acceptsInput({"a", "b", "a"}));
+  ASSERT_FALSE(mapped.acceptsInput({"a", "a"}));
+  auto rebuilt = mapped.toDFA();
+  ASSERT_TRUE(rebuilt.getAllowPartial());
+  FATest::assertIsCopy(rebuilt, partial);
+}
+
+TEST_F(MappedDFATest, test_sections_aligned) {
+  // Should align every section so that it can be used in place.
+  saveBinaryDFA(dfa, path);
+  std::ifstream file(path, std::ios::binary);
+  BinaryHeader header;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  ASSERT_EQ(header.version, BINARY_VERSION);
+  ASSERT_EQ(header.tableOffset % BINARY_SECTION_ALIGNMENT, 0u);
+  ASSERT_EQ(header.finalOffset % BINARY_SECTION_ALIGNMENT, 0u);
+  ASSERT_EQ(header.fileSize % sizeof(uint64_t), 0u);
+}
+
+TEST_F(MappedDFATest, test_checksum_mismatch) {
+  // Should raise error if the payload has been modified.
+  saveBinaryDFA(dfa, path);
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    BinaryHeader header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    file.seekp(header.tableOffset);
+    uint32_t corrupted = 2;
+    file.write(reinterpret_cast<const char *>(&corrupted), sizeof(corrupted));
+  }
+  EXPECT_THROW(MappedDFA mapped(path), SerializationException);
+  MappedDFA unchecked(path, false);
+  ASSERT_EQ(unchecked.nextState(0, 0), 2u);
+}
+
+TEST_F(MappedDFATest, test_invalid_file) {
+  // Should raise error if the file is not a binary DFA.
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << std::string(sizeof(BinaryHeader) * 2, 'x');
+  }
+  EXPECT_THROW(MappedDFA mapped(path), SerializationException);
+  EXPECT_THROW(MappedDFA mapped("does/not/exist.bin"), SerializationException);
+}
+
+TEST_F(MappedDFATest, test_missing_transition_message) {
+  // Should tell a missing transition apart from an unknown symbol.
+  auto partial = DFA({"q0", "q1"}, {"a", "b"}, {{"q0", {{"a", "q1"}}}}, "q0",
+                     {"q1"}, true);
+  saveBinaryDFA(partial, path);
+  MappedDFA mapped(path);
+  try {
+    mapped.readInput({"b"});
+    FAIL();
+  } catch (const RejectionException &e) {
+    ASSERT_EQ(std::string(e.what()), "state q0 has no transition on b");
+  }
+  try {
+    mapped.readInput({"c"});
+    FAIL();
+  } catch (const RejectionException &e) {
+    ASSERT_EQ(std::string(e.what()), "c is not a valid input symbol");
+  }
+}
+
+TEST_F(MappedDFATest, test_corrupted_symbol_index) {
+  // Should raise error on a symbol index entry past its blob.
+  saveBinaryDFA(dfa, path);
+  BinaryHeader header;
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    file.seekp(header.symbolIndexOffset + sizeof(uint64_t));
+    uint64_t corrupted = 1ull << 40;
+    file.write(reinterpret_cast<const char *>(&corrupted), sizeof(corrupted));
+  }
+  MappedDFA unchecked(path, false);
+  EXPECT_THROW(unchecked.findSymbol("1"), SerializationException);
+  EXPECT_THROW(unchecked.acceptsInput({"1"}), SerializationException);
+}
+
+TEST_F(MappedDFATest, test_overflowing_counts) {
+  // Should reject counts too large for their sections.
+  saveBinaryDFA(dfa, path);
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    BinaryHeader header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    header.stateCount = 0xFFFFFFFFu;
+    header.symbolCount = 0xFFFFFFFFu;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+  EXPECT_THROW(MappedDFA mapped(path, false), SerializationException);
+}
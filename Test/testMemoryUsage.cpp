@@ -0,0 +1,138 @@
+#include "DFA.hpp"
+#include "NFA.hpp"
+#include "RandomAutomata.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+
+using namespace CXXAUTOMATA;
+
+class MemoryUsageTest : public FATest {
+public:
+  /**
+   * @brief Return a DFA counting symbols modulo size, with state names of
+   *        the given prefix.
+   *
+   */
+  static DFA cycle(std::size_t size, const std::string &prefix) {
+    States states;
+    Transitions transitions;
+    for (std::size_t i = 0; i < size; i++) {
+      State state = prefix + std::to_string(i);
+      states.insert(state);
+      transitions[state] = {{"0", prefix + std::to_string((i + 1) % size)},
+                            {"1", state}};
+    }
+    return DFA(states, {"0", "1"}, transitions, prefix + "0",
+               {prefix + "0"});
+  }
+
+  NFA nfa = NFA({"q0", "q1", "q2"}, {"a", "b"},
+                {{"q0", {{"a", {"q0", "q1"}}}}, {"q1", {{"b", {"q2"}}}}}, "q0",
+                {"q2"});
+};
+
+TEST_F(MemoryUsageTest, test_breakdown) {
+  // Should split the total into its parts and grow with the automaton.
+  MemoryUsage usage = dfa.memoryUsage();
+  ASSERT_EQ(usage.total(), usage.transitions + usage.stateNames +
+                               usage.symbols + usage.auxiliary);
+  ASSERT_GT(usage.transitions, usage.stateNames);
+  ASSERT_GT(usage.symbols, 0u);
+  ASSERT_GE(usage.auxiliary, sizeof(DFA) - sizeof(Automaton));
+
+  MemoryUsage small = cycle(10, "q").memoryUsage();
+  MemoryUsage large = cycle(100, "q").memoryUsage();
+  ASSERT_GT(large.transitions, 9 * small.transitions);
+  ASSERT_GT(large.stateNames, 5 * small.stateNames);
+  ASSERT_EQ(large.symbols, small.symbols);
+
+  std::string longName(100, 'x');
+  MemoryUsage named = cycle(10, longName).memoryUsage();
+  ASSERT_GT(named.stateNames, small.stateNames + 10 * longName.size());
+}
+
+TEST_F(MemoryUsageTest, test_provenance) {
+  // Should count a recorded provenance as auxiliary memory.
+  DFA recorded = dfa.withProvenance();
+  ASSERT_GT(recorded.memoryUsage().auxiliary, dfa.memoryUsage().auxiliary);
+  ASSERT_EQ(recorded.memoryUsage().transitions,
+            dfa.memoryUsage().transitions);
+}
+
+TEST_F(MemoryUsageTest, test_nfa) {
+  // Should count the transitions of an NFA.
+  MemoryUsage usage = nfa.memoryUsage();
+  ASSERT_GT(usage.transitions, sizeof(NFATransitions) + sizeof(Transitions));
+  ASSERT_EQ(usage.total(), usage.transitions + usage.stateNames +
+                               usage.symbols + usage.auxiliary);
+}
+
+TEST_F(MemoryUsageTest, test_live_tally) {
+  // Should charge live automata and release them when destroyed.
+  std::size_t bytes = Automaton::getLiveMemoryBytes();
+  std::size_t count = Automaton::getLiveCount();
+  {
+    DFA copy(dfa);
+    ASSERT_EQ(Automaton::getLiveCount(), count + 1);
+    ASSERT_EQ(Automaton::getLiveMemoryBytes(),
+              bytes + copy.memoryUsage().total());
+    NFA other(nfa);
+    ASSERT_EQ(Automaton::getLiveCount(), count + 2);
+    ASSERT_EQ(Automaton::getLiveMemoryBytes(),
+              bytes + copy.memoryUsage().total() +
+                  other.memoryUsage().total());
+  }
+  ASSERT_EQ(Automaton::getLiveCount(), count);
+  ASSERT_EQ(Automaton::getLiveMemoryBytes(), bytes);
+
+  std::unique_ptr<DFA> built(new DFA(cycle(50, "q").minify()));
+  ASSERT_EQ(Automaton::getLiveMemoryBytes(),
+            bytes + built->memoryUsage().total());
+  built.reset();
+  ASSERT_EQ(Automaton::getLiveMemoryBytes(), bytes);
+}
+
+TEST_F(MemoryUsageTest, test_assignment) {
+  // Should recharge an automaton when it is assigned another one.
+  std::size_t bytes = Automaton::getLiveMemoryBytes();
+  DFA target(dfa);
+  DFA large = cycle(100, "q");
+  target = large;
+  ASSERT_EQ(target.memoryUsage().total(), large.memoryUsage().total());
+  ASSERT_EQ(Automaton::getLiveMemoryBytes(),
+            bytes + 2 * large.memoryUsage().total());
+  target = dfa;
+  ASSERT_EQ(Automaton::getLiveMemoryBytes(),
+            bytes + dfa.memoryUsage().total() + large.memoryUsage().total());
+}
+
+TEST_F(MemoryUsageTest, test_operation_results) {
+  // Should charge the results of operations built without validation.
+  RandomAutomatonGenerator generator(5);
+  DFA a = generator.randomDFA(20, 2, 0.5, 0.9);
+  DFA b = generator.randomDFA(20, 2, 0.5, 0.9);
+  DFA partial({"r0", "r1"}, {"0", "1"}, {{"r0", {{"1", "r1"}}}}, "r0",
+              {"r1"}, true);
+  DFA tracked = a.withProvenance();
+  std::size_t bytes = Automaton::getLiveMemoryBytes();
+  {
+    DFA minimal = a.minify();
+    DFA product = a.intersection(b);
+    DFA canonical = a.canonical();
+    DFA reversed = a.reverse();
+    DFA complement = partial.complement();
+    DFA completeComplement = dfa.complement();
+    DFA trackedProduct = tracked.intersection(b, false, false);
+    ASSERT_EQ(Automaton::getLiveMemoryBytes(),
+              bytes + minimal.memoryUsage().total() +
+                  product.memoryUsage().total() +
+                  canonical.memoryUsage().total() +
+                  reversed.memoryUsage().total() +
+                  complement.memoryUsage().total() +
+                  completeComplement.memoryUsage().total() +
+                  trackedProduct.memoryUsage().total());
+  }
+  ASSERT_EQ(Automaton::getLiveMemoryBytes(), bytes);
+}
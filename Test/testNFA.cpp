@@ -0,0 +1,110 @@
+#include "Exceptions.hpp"
+#include "Typedefs.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+
+using namespace CXXAUTOMATA;
+
+class NFATest : public FATest {
+protected:
+  NFATest()
+      : FATest(),
+        /*
+         * This NFA accepts all words which are at least two characters long
+         * and where the second-to-last character is a
+         */
+        nfa({"q0", "q1", "q2"}, {"a", "b"},
+            {{"q0", {{"a", {"q0", "q1"}}, {"b", {"q0"}}}},
+             {"q1", {{"a", {"q2"}}, {"b", {"q2"}}}}},
+            "q0", {"q2"}),
+        /*
+         * This NFA accepts the words a and ab using a lambda transition
+         */
+        lambdaNfa({"q0", "q1", "q2"}, {"a", "b"},
+                  {{"q0", {{"a", {"q1"}}}},
+                   {"q1", {{NFA::LAMBDA, {"q2"}}}},
+                   {"q2", {{"b", {"q1"}}}}},
+                  "q0", {"q1"}){};
+
+  NFA nfa;
+  NFA lambdaNfa;
+};
+
+TEST_F(NFATest, test_init_nfa) {
+  // Should copy NFA if passed into NFA constructor.
+  auto new_nfa = nfa;
+  FATest::assertIsCopy(new_nfa, nfa);
+  ASSERT_EQ(new_nfa.getNFATransitions(), nfa.getNFATransitions());
+}
+
+TEST_F(NFATest, test_validate_invalid_symbol) {
+  // Should raise error if a transition references an invalid symbol.
+  EXPECT_THROW(NFA({"q0", "q1"}, {"a"}, {{"q0", {{"c", {"q1"}}}}}, "q0",
+                   {"q1"}),
+               InvalidSymbolException);
+}
+
+TEST_F(NFATest, test_validate_invalid_state) {
+  // Should raise error if a transition references an invalid state.
+  EXPECT_THROW(NFA({"q0", "q1"}, {"a"}, {{"q0", {{"a", {"q2"}}}}}, "q0",
+                   {"q1"}),
+               InvalidStateException);
+  EXPECT_THROW(NFA({"q0", "q1"}, {"a"}, {{"q2", {{"a", {"q1"}}}}}, "q0",
+                   {"q1"}),
+               InvalidStateException);
+}
+
+TEST_F(NFATest, test_validate_invalid_initial_and_final_state) {
+  // Should raise error if the initial or a final state is invalid.
+  EXPECT_THROW(NFA({"q0", "q1"}, {"a"}, {}, "q2", {"q1"}),
+               InvalidStateException);
+  EXPECT_THROW(NFA({"q0", "q1"}, {"a"}, {}, "q0", {"q2"}),
+               InvalidStateException);
+}
+
+TEST_F(NFATest, test_lambda_closure) {
+  // Should follow lambda transitions transitively.
+  States expected = {"q1", "q2"};
+  ASSERT_EQ(lambdaNfa.getLambdaClosure("q1"), expected);
+  States initial = {"q0"};
+  ASSERT_EQ(lambdaNfa.getLambdaClosure("q0"), initial);
+}
+
+TEST_F(NFATest, test_read_input_step) {
+  // Should yield the set of current states at each step.
+  States_v expected = {"q0", "q0,q1", "q0,q2"};
+  ASSERT_EQ(nfa.readInputStepwise({"a", "b"}), expected);
+  ASSERT_EQ(nfa.readInput({"b", "a", "a"}), "q0,q1,q2");
+}
+
+TEST_F(NFATest, test_accepts_input) {
+  // Should accept or reject input as the language requires.
+  ASSERT_TRUE(nfa.acceptsInput({"a", "b"}));
+  ASSERT_TRUE(nfa.acceptsInput({"b", "b", "a", "a"}));
+  ASSERT_FALSE(nfa.acceptsInput({"b", "a"}));
+  ASSERT_FALSE(nfa.acceptsInput({"a"}));
+  ASSERT_TRUE(lambdaNfa.acceptsInput({"a"}));
+  ASSERT_TRUE(lambdaNfa.acceptsInput({"a", "b", "b"}));
+  ASSERT_FALSE(lambdaNfa.acceptsInput({"b"}));
+}
+
+TEST_F(NFATest, test_dfa_from_nfa) {
+  // Should build an equivalent DFA with the subset construction.
+  auto dfa = DFA::fromNFA(nfa);
+  States expected_states = {"q0", "q0,q1", "q0,q2", "q0,q1,q2"};
+  ASSERT_EQ(dfa.getStates(), expected_states);
+  ASSERT_EQ(dfa.getInitialState(), "q0");
+  States expected_final_states = {"q0,q2", "q0,q1,q2"};
+  ASSERT_EQ(dfa.getFinalStates(), expected_final_states);
+  ASSERT_EQ(dfa.getTransitions().at("q0,q1").at("a"), "q0,q1,q2");
+  ASSERT_EQ(dfa.getTransitions().at("q0,q1").at("b"), "q0,q2");
+}
+
+TEST_F(NFATest, test_dfa_from_nfa_lambda) {
+  // Should include lambda closures and the empty set in the DFA.
+  auto dfa = DFA::fromNFA(lambdaNfa);
+  ASSERT_EQ(dfa.getTransitions().at("q0").at("a"), "q1,q2");
+  ASSERT_EQ(dfa.getTransitions().at("q0").at("b"), "");
+  ASSERT_TRUE(dfa.acceptsInput({"a", "b"}));
+  ASSERT_FALSE(dfa.acceptsInput({"a", "a"}));
+}
@@ -0,0 +1,140 @@
+#include "OperationCache.hpp"
+#include "RandomAutomata.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+
+using namespace CXXAUTOMATA;
+
+class OperationCacheTest : public FATest {
+public:
+  // dfa with its states renamed, an unreachable state and a redundant copy
+  // of the final state
+  DFA variant = DFA({"a", "b", "c", "d", "e"}, {"0", "1"},
+                    {{"a", {{"0", "a"}, {"1", "b"}}},
+                     {"b", {{"0", "a"}, {"1", "c"}}},
+                     {"c", {{"0", "c"}, {"1", "d"}}},
+                     {"d", {{"0", "a"}, {"1", "c"}}},
+                     {"e", {{"0", "e"}, {"1", "e"}}}},
+                    "a", {"b", "d"});
+
+  // Words ending in 1, with an unreachable sink
+  DFA unreachableSink = DFA({"p0", "p1", "sink"}, {"0", "1"},
+                            {{"p0", {{"0", "p0"}, {"1", "p1"}}},
+                             {"p1", {{"0", "p0"}, {"1", "p1"}}},
+                             {"sink", {{"0", "sink"}, {"1", "sink"}}}},
+                            "p0", {"p1"});
+  // Words 10*, complete with a sink and partial without
+  DFA oneThenZeros = DFA({"p0", "p1", "sink"}, {"0", "1"},
+                         {{"p0", {{"0", "sink"}, {"1", "p1"}}},
+                          {"p1", {{"0", "p1"}, {"1", "sink"}}},
+                          {"sink", {{"0", "sink"}, {"1", "sink"}}}},
+                         "p0", {"p1"});
+  DFA partial = DFA({"r0", "r1"}, {"0", "1"},
+                    {{"r0", {{"1", "r1"}}}, {"r1", {{"0", "r1"}}}}, "r0",
+                    {"r1"}, true);
+};
+
+TEST_F(OperationCacheTest, test_canonical) {
+  // Should number the minimal states in breadth-first order.
+  DFA canonical = variant.canonical();
+  ASSERT_EQ(canonical.getStates(), States({"0", "1"}));
+  ASSERT_EQ(canonical.getInitialState(), "0");
+  ASSERT_EQ(canonical.getFinalStates(), States({"1"}));
+  ASSERT_TRUE(canonical == dfa);
+  assertIsCopy(canonical, dfa.canonical());
+}
+
+TEST_F(OperationCacheTest, test_fingerprint_equivalent) {
+  // Should fingerprint equivalent DFAs alike.
+  ASSERT_EQ(dfa.fingerprint(), variant.fingerprint());
+  DFA withoutSink({"p0", "p1"}, {"0", "1"},
+                  {{"p0", {{"0", "p0"}, {"1", "p1"}}},
+                   {"p1", {{"0", "p0"}, {"1", "p1"}}}},
+                  "p0", {"p1"});
+  ASSERT_EQ(unreachableSink.fingerprint(), withoutSink.fingerprint());
+  ASSERT_EQ(oneThenZeros.fingerprint(), partial.fingerprint());
+  assertIsCopy(oneThenZeros.canonical(), partial.canonical());
+  ASSERT_EQ(dfa.fingerprint().toString().size(), 32u);
+
+  DFA empty({"e"}, {"0", "1"}, {{"e", {{"0", "e"}, {"1", "e"}}}}, "e", {});
+  DFA emptyPartial({"e"}, {"0", "1"}, {}, "e", {}, true);
+  ASSERT_EQ(empty.fingerprint(), emptyPartial.fingerprint());
+}
+
+TEST_F(OperationCacheTest, test_fingerprint_different) {
+  // Should fingerprint different languages differently.
+  ASSERT_NE(dfa.fingerprint(), unreachableSink.fingerprint());
+  ASSERT_NE(dfa.fingerprint(), dfa.complement().fingerprint());
+  ASSERT_NE(unreachableSink.fingerprint(), oneThenZeros.fingerprint());
+
+  RandomAutomatonGenerator generator(5);
+  for (int i = 0; i < 20; i++) {
+    DFA first = generator.randomDFA(8, 2, 0.5, 0.7);
+    DFA second = generator.randomDFA(8, 2, 0.5, 0.7);
+    ASSERT_EQ(first == second, first.fingerprint() == second.fingerprint());
+  }
+}
+
+TEST_F(OperationCacheTest, test_cache_hits) {
+  // Should answer equivalent operands from the cache.
+  OperationCache cache(16);
+  DFA result = cache.intersection(dfa, oneThenZeros);
+  ASSERT_TRUE(result == dfa.intersection(oneThenZeros));
+  // Both operands and the product miss
+  ASSERT_EQ(cache.getMisses(), 3u);
+  ASSERT_EQ(cache.size(), 3u);
+  assertIsCopy(cache.intersection(variant, oneThenZeros), result);
+  ASSERT_EQ(cache.getMisses(), 4u);
+  ASSERT_EQ(cache.getHits(), 2u);
+  ASSERT_EQ(cache.size(), 4u);
+
+  DFA &other = oneThenZeros;
+  ASSERT_TRUE(cache.unionJoin(dfa, other) == dfa.unionJoin(other));
+  ASSERT_TRUE(cache.difference(dfa, other) == dfa.difference(other));
+  ASSERT_TRUE(cache.symmetricDifference(dfa, other) ==
+              dfa.symmetricDifference(other));
+  ASSERT_FALSE(cache.isSubset(dfa, oneThenZeros));
+  ASSERT_TRUE(cache.isSubset(partial, oneThenZeros));
+  ASSERT_TRUE(cache.isSubset(oneThenZeros, partial));
+  assertIsCopy(cache.minify(variant), dfa.canonical());
+  ASSERT_EQ(cache.getHits(), 15u);
+  ASSERT_EQ(cache.getMisses(), 10u);
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0u);
+  cache.minify(dfa);
+  ASSERT_EQ(cache.getMisses(), 11u);
+}
+
+TEST_F(OperationCacheTest, test_cache_structure_keys) {
+  // Should tell apart operands that differ only in their final states.
+  OperationCache cache(4);
+  DFA complement = dfa.complement();
+  assertIsCopy(cache.minify(dfa), dfa.canonical());
+  assertIsCopy(cache.minify(complement), complement.canonical());
+  ASSERT_EQ(cache.getMisses(), 2u);
+  assertIsCopy(cache.minify(complement), complement.canonical());
+  ASSERT_EQ(cache.getHits(), 1u);
+}
+
+TEST_F(OperationCacheTest, test_cache_eviction) {
+  // Should evict the least recently used result.
+  OperationCache cache(2);
+  cache.minify(dfa);
+  cache.minify(oneThenZeros);
+  cache.minify(variant);
+  cache.minify(unreachableSink);
+  ASSERT_EQ(cache.size(), 2u);
+  ASSERT_EQ(cache.getCapacity(), 2u);
+  cache.minify(variant);
+  ASSERT_EQ(cache.getHits(), 1u);
+  cache.minify(dfa);
+  ASSERT_EQ(cache.getHits(), 1u);
+  ASSERT_EQ(cache.getMisses(), 5u);
+
+  OperationCache disabled(0);
+  disabled.minify(dfa);
+  disabled.minify(dfa);
+  ASSERT_EQ(disabled.size(), 0u);
+  ASSERT_EQ(disabled.getHits(), 0u);
+}
@@ -0,0 +1,164 @@
+#include "Exceptions.hpp"
+#include "Provenance.hpp"
+#include "RandomAutomata.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class ProvenanceTest : public FATest {
+public:
+  /**
+   * @brief Return the described name of every state of dfa.
+   *
+   */
+  static States describedStates(const DFA &dfa) {
+    States described;
+    for (StateId state = 0; state < dfa.getStates().size(); state++) {
+      described.insert(dfa.describeState(state));
+    }
+    return described;
+  }
+
+  /**
+   * @brief Return names with their comma-separated parts sorted, as member
+   *        order inside a class follows the names of the operands.
+   *
+   */
+  static std::multiset<std::string> canonical(const States &names) {
+    std::multiset<std::string> result;
+    for (auto &name : names) {
+      std::vector<std::string> parts(1);
+      for (char c : name) {
+        if (c == ',') {
+          parts.emplace_back();
+        } else {
+          parts.back() += c;
+        }
+      }
+      std::sort(parts.begin(), parts.end());
+      std::string joined;
+      for (auto &part : parts) {
+        joined += part + ',';
+      }
+      result.insert(joined);
+    }
+    return result;
+  }
+
+  DFA hasB = DFA({"p0", "p1"}, {"0", "1"},
+                 {{"p0", {{"0", "p0"}, {"1", "p1"}}},
+                  {"p1", {{"0", "p1"}, {"1", "p1"}}}},
+                 "p0", {"p1"});
+};
+
+TEST_F(ProvenanceTest, test_describe_without_provenance) {
+  // Should describe a state by its own name.
+  ASSERT_EQ(dfa.getProvenance(), nullptr);
+  ASSERT_EQ(dfa.describeState(1), "q1");
+  ASSERT_EQ(dfa.describeState("q2"), "q2");
+  ASSERT_THROW(dfa.describeState(3), InvalidStateException);
+  ASSERT_THROW(dfa.describeState("q3"), InvalidStateException);
+  ASSERT_EQ(dfa.withProvenance().describeState(2), "q2");
+}
+
+TEST_F(ProvenanceTest, test_product_provenance) {
+  // Should describe product states by the names they would have had.
+  auto product = dfa.withProvenance().intersection(hasB, false, false);
+  ASSERT_EQ(product.getProvenance()->getKind(), Provenance::PRODUCT);
+  ASSERT_EQ(describedStates(product),
+            dfa.intersection(hasB, false, false).getStates());
+  ASSERT_EQ(product.describeState("0"), "q0,p0");
+  // States are numbered as q0,p0 q0,p1 q1,p0 ...
+  ASSERT_EQ(product.getProvenance()->getPair(2),
+            std::make_pair(StateId(1), StateId(0)));
+}
+
+TEST_F(ProvenanceTest, test_minimal_product_provenance) {
+  // Should keep short names while describing the merged classes.
+  auto tracked = dfa.withProvenance().unionJoin(hasB, false);
+  auto named = dfa.unionJoin(hasB, true);
+  ASSERT_EQ(tracked.getProvenance()->getKind(), Provenance::CLASSES);
+  ASSERT_EQ(tracked.getProvenance()->getLeft()->getKind(),
+            Provenance::PRODUCT);
+  ASSERT_EQ(canonical(describedStates(tracked)),
+            canonical(named.getStates()));
+  for (auto &state : tracked.getStates()) {
+    ASSERT_LE(state.size(), 2u);
+  }
+}
+
+TEST_F(ProvenanceTest, test_chained_provenance) {
+  // Should describe chained operations like names kept all along, up to
+  // the order of class members, with short names in the automata.
+  RandomAutomatonGenerator generator(3);
+  std::vector<DFA> operands;
+  for (int i = 0; i < 4; i++) {
+    operands.push_back(generator.randomDFA(6, 2, 0.5, 0.8));
+  }
+  DFA tracked = operands[0].withProvenance();
+  DFA named = operands[0];
+  for (std::size_t i = 1; i < operands.size(); i++) {
+    tracked = i % 2 ? tracked.intersection(operands[i], false)
+                    : tracked.unionJoin(operands[i], false);
+    named = i % 2 ? named.intersection(operands[i], true)
+                  : named.unionJoin(operands[i], true);
+    ASSERT_EQ(canonical(describedStates(tracked)),
+              canonical(named.getStates()));
+  }
+  tracked = tracked.minify(false);
+  ASSERT_EQ(canonical(describedStates(tracked)),
+            canonical(named.minify(true).getStates()));
+  for (auto &state : tracked.getStates()) {
+    ASSERT_LE(state.size(), 2u);
+  }
+  ASSERT_EQ(tracked.getProvenance()->getKind(), Provenance::CLASSES);
+}
+
+TEST_F(ProvenanceTest, test_complement_provenance) {
+  // Should name the added sink and keep the ids of the other states.
+  DFA partial({"q0", "q1"}, {"0", "1"}, {{"q0", {{"0", "q1"}}}}, "q0",
+              {"q1"}, true);
+  DFA complement = partial.withProvenance().complement();
+  ASSERT_EQ(complement.getProvenance()->getKind(), Provenance::INSERTED);
+  ASSERT_EQ(describedStates(complement), complement.getStates());
+  ASSERT_EQ(complement.describeState(0), "");
+  ASSERT_EQ(complement.describeState(2), "q1");
+  ASSERT_THROW(complement.describeState(3), InvalidStateException);
+
+  // The sink "'" sorts between "" and "b".
+  DFA quoted({"", "b"}, {"0"}, {{"", {{"0", "b"}}}}, "", {"b"}, true);
+  complement = quoted.withProvenance().complement();
+  ASSERT_EQ(complement.describeState(0), "");
+  ASSERT_EQ(complement.describeState(1), "'");
+  ASSERT_EQ(complement.describeState(2), "b");
+  ASSERT_EQ(describedStates(complement.minify(false)),
+            describedStates(complement.minify(true)));
+}
+
+TEST_F(ProvenanceTest, test_names_stay_short) {
+  // Should number the states of tracked results whatever retainNames, so
+  // names do not grow over a chain of operations.
+  RandomAutomatonGenerator generator(4);
+  for (bool retainNames : {false, true}) {
+    for (bool minify : {false, true}) {
+      DFA tracked = dfa.withProvenance();
+      DFA named = dfa;
+      for (int i = 0; i < 5; i++) {
+        DFA operand = generator.randomDFA(4, 2, 0.5, 0.8);
+        tracked = tracked.intersection(operand, retainNames, minify);
+        named = named.intersection(operand, true, minify);
+        std::size_t digits = std::to_string(tracked.getStates().size()).size();
+        for (auto &state : tracked.getStates()) {
+          ASSERT_LE(state.size(), digits);
+        }
+        ASSERT_EQ(canonical(describedStates(tracked)),
+                  canonical(named.getStates()));
+      }
+    }
+  }
+}
@@ -0,0 +1,306 @@
+#include "Exceptions.hpp"
+#include "IndexedDFA.hpp"
+#include "RandomAutomata.hpp"
+#include "ThreadPool.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+using namespace CXXAUTOMATA;
+
+class RandomAutomataTest : public FATest {
+public:
+  /**
+   * @brief Reference DFA simulation working on the raw transitions.
+   *
+   */
+  static bool dfaAccepts(const DFA &dfa, const InputSymbols_v &word) {
+    State current = dfa.getInitialState();
+    for (auto &symbol : word) {
+      auto paths = dfa.getTransitions().find(current);
+      if (paths == dfa.getTransitions().end()) {
+        return false;
+      }
+      auto path = paths->second.find(symbol);
+      if (path == paths->second.end()) {
+        return false;
+      }
+      current = path->second;
+    }
+    return dfa.getFinalStates().count(current) > 0;
+  }
+
+  /**
+   * @brief Reference NFA simulation exploring every path.
+   *
+   */
+  static bool nfaAccepts(const NFA &nfa, const State &state,
+                         const InputSymbols_v &word, std::size_t pos,
+                         std::set<std::pair<State, std::size_t>> &seen) {
+    if (!seen.insert(std::make_pair(state, pos)).second) {
+      return false;
+    }
+    if (pos == word.size() && nfa.getFinalStates().count(state) > 0) {
+      return true;
+    }
+    auto transition = nfa.getNFATransitions().find(state);
+    if (transition == nfa.getNFATransitions().end()) {
+      return false;
+    }
+    for (auto &path : transition->second) {
+      bool lambda = path.first == NFA::LAMBDA;
+      if (!lambda && (pos == word.size() || path.first != word[pos])) {
+        continue;
+      }
+      for (auto &end : path.second) {
+        if (nfaAccepts(nfa, end, word, lambda ? pos : pos + 1, seen)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  static bool nfaAccepts(const NFA &nfa, const InputSymbols_v &word) {
+    std::set<std::pair<State, std::size_t>> seen;
+    return nfaAccepts(nfa, nfa.getInitialState(), word, 0, seen);
+  }
+};
+
+TEST_F(RandomAutomataTest, test_random_dfa_shape) {
+  // Should generate accessible DFAs of the requested size.
+  RandomAutomatonGenerator generator(42);
+  auto dfa = generator.randomDFA(100, 3, 0.3);
+  ASSERT_EQ(dfa.getStates().size(), 100u);
+  ASSERT_EQ(dfa.getInputSymbols().size(), 3u);
+  ASSERT_EQ(dfa.getInitialState(), "q00");
+  ASSERT_FALSE(dfa.getAllowPartial());
+  ASSERT_EQ(dfa.getStates().count("q99"), 1u);
+
+  std::set<State> reached = {dfa.getInitialState()};
+  std::vector<State> stack = {dfa.getInitialState()};
+  while (!stack.empty()) {
+    auto state = stack.back();
+    stack.pop_back();
+    for (auto &path : dfa.getTransitions().at(state)) {
+      if (reached.insert(path.second).second) {
+        stack.push_back(path.second);
+      }
+    }
+  }
+  ASSERT_EQ(reached.size(), 100u);
+}
+
+TEST_F(RandomAutomataTest, test_random_is_reproducible) {
+  // Should generate the same automata from the same seed.
+  RandomAutomatonGenerator first(7);
+  RandomAutomatonGenerator second(7);
+  FATest::assertIsCopy(first.randomDFA(50, 2), second.randomDFA(50, 2));
+  FATest::assertIsCopy(first.randomNFA(50, 2), second.randomNFA(50, 2));
+}
+
+TEST_F(RandomAutomataTest, test_random_partial_dfa) {
+  // Should keep the spanning tree when transitions are sparse.
+  RandomAutomatonGenerator generator(3);
+  auto dfa = generator.randomDFA(1000, 4, 0.5, 0.0);
+  ASSERT_TRUE(dfa.getAllowPartial());
+  std::size_t transitionCount = 0;
+  for (auto &transition : dfa.getTransitions()) {
+    transitionCount += transition.second.size();
+  }
+  ASSERT_EQ(transitionCount, 999u);
+}
+
+TEST_F(RandomAutomataTest, test_large_random_dfa) {
+  // Should build large automata quickly.
+  RandomAutomatonGenerator generator(1);
+  auto dfa = generator.randomDFA(200000, 2);
+  ASSERT_EQ(dfa.getStates().size(), 200000u);
+  ASSERT_EQ(dfa.getTransitions().size(), 200000u);
+}
+
+TEST_F(RandomAutomataTest, test_differential_minify) {
+  // Should accept the same words after minify.
+  for (uint64_t seed = 0; seed < 20; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    auto dfa = generator.randomDFA(1 + seed % 6, 2, 0.4);
+    auto minimal = dfa.minify(seed % 2 == 0);
+    for (auto &word : words(dfa.getInputSymbols(), 7)) {
+      ASSERT_EQ(dfaAccepts(minimal, word), dfaAccepts(dfa, word));
+    }
+  }
+}
+
+TEST_F(RandomAutomataTest, test_differential_products) {
+  // Should match the boolean combination of both languages.
+  for (uint64_t seed = 0; seed < 12; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    auto a = generator.randomDFA(1 + seed % 4, 2, 0.5);
+    auto b = generator.randomDFA(1 + (seed / 4) % 4, 2, 0.5);
+    bool minify = seed % 2 == 1;
+    auto unionDfa = a.unionJoin(b, false, minify);
+    auto intersectionDfa = a.intersection(b, false, minify);
+    auto differenceDfa = a.difference(b, false, minify);
+    auto symmetricDifferenceDfa = a.symmetricDifference(b, false, minify);
+    for (auto &word : words(a.getInputSymbols(), 6)) {
+      bool inA = dfaAccepts(a, word);
+      bool inB = dfaAccepts(b, word);
+      ASSERT_EQ(dfaAccepts(unionDfa, word), inA || inB);
+      ASSERT_EQ(dfaAccepts(intersectionDfa, word), inA && inB);
+      ASSERT_EQ(dfaAccepts(differenceDfa, word), inA && !inB);
+      ASSERT_EQ(dfaAccepts(symmetricDifferenceDfa, word), inA != inB);
+    }
+    ASSERT_EQ(a <= b, [&]() {
+      bool subset = true;
+      for (auto &word : words(a.getInputSymbols(), 6)) {
+        subset = subset && (!dfaAccepts(a, word) || dfaAccepts(b, word));
+      }
+      return subset;
+    }());
+  }
+}
+
+TEST_F(RandomAutomataTest, test_differential_partial) {
+  // Should handle missing transitions in every operation.
+  for (uint64_t seed = 0; seed < 20; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    auto a = generator.randomDFA(1 + seed % 5, 3, 0.3, 0.3);
+    auto b = generator.randomDFA(1 + (seed / 5) % 4, 3, 0.5, 0.6);
+    auto minimal = a.minify();
+    auto complement = a.complement();
+    auto intersectionDfa = a.intersection(b, false, seed % 2 == 0);
+    ASSERT_FALSE(complement.getAllowPartial());
+    bool empty = true;
+    for (auto &word : words(a.getInputSymbols(), 5)) {
+      bool inA = dfaAccepts(a, word);
+      empty = empty && !inA;
+      ASSERT_EQ(a.acceptsInput(word), inA);
+      ASSERT_EQ(dfaAccepts(minimal, word), inA);
+      ASSERT_EQ(dfaAccepts(complement, word), !inA);
+      ASSERT_EQ(dfaAccepts(intersectionDfa, word),
+                inA && dfaAccepts(b, word));
+    }
+    ASSERT_EQ(a.isEmpty(), empty);
+    ASSERT_TRUE(a.intersection(complement).isEmpty());
+    ASSERT_NE(a.toDot().find("digraph"), std::string::npos);
+  }
+}
+
+TEST_F(RandomAutomataTest, test_parallel_minify_is_identical) {
+  // Should build exactly the sequential result with any number of threads.
+  ThreadPool one(1);
+  ThreadPool three(3);
+  for (uint64_t seed = 0; seed < 20; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    double density = seed % 3 == 0 ? 0.6 : 1.0;
+    auto dfa = generator.randomDFA(1 + seed * 7, 1 + seed % 3, 0.3, density);
+    bool retainNames = seed % 2 == 0;
+    auto minimal = dfa.minify(retainNames);
+    FATest::assertIsCopy(dfa.minify(retainNames, one), minimal);
+    FATest::assertIsCopy(dfa.minify(retainNames, three), minimal);
+    ASSERT_EQ(dfa.minify(retainNames, three).getAllowPartial(),
+              minimal.getAllowPartial());
+  }
+}
+
+TEST_F(RandomAutomataTest, test_parallel_products_are_identical) {
+  // Should explore the same product with any number of threads.
+  ThreadPool one(1);
+  ThreadPool three(3);
+  for (uint64_t seed = 0; seed < 12; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    auto a = generator.randomDFA(1 + seed * 3, 2, 0.5, 0.7);
+    auto b = generator.randomDFA(1 + (seed * 5) % 17, 3, 0.5);
+    bool retainNames = seed % 2 == 0;
+    for (auto pool : {&one, &three}) {
+      FATest::assertIsCopy(a.unionJoin(b, retainNames, *pool),
+                           a.unionJoin(b, retainNames));
+      FATest::assertIsCopy(a.intersection(b, retainNames, *pool),
+                           a.intersection(b, retainNames));
+      FATest::assertIsCopy(a.difference(b, retainNames, *pool),
+                           a.difference(b, retainNames));
+      FATest::assertIsCopy(a.symmetricDifference(b, retainNames, *pool),
+                           a.symmetricDifference(b, retainNames));
+    }
+    // The product itself is numbered in breadth-first order either way.
+    Arena arena;
+    auto indexedA = IndexedDFA::fromDFA(a, arena);
+    auto indexedB = IndexedDFA::fromDFA(b, arena);
+    InputSymbols alphabet = b.getInputSymbols();
+    auto accept = [](bool x, bool y) { return x && y; };
+    auto sequential = IndexedDFA::product(indexedA, indexedB, alphabet, accept);
+    auto parallel =
+        IndexedDFA::product(indexedA, indexedB, alphabet, accept, &three);
+    ASSERT_EQ(parallel.getStateCount(), sequential.getStateCount());
+    for (StateId state = 0; state < sequential.getStateCount(); state++) {
+      ASSERT_EQ(parallel.isFinal(state), sequential.isFinal(state));
+      for (SymbolId symbol = 0; symbol < alphabet.size(); symbol++) {
+        ASSERT_EQ(parallel.next(state, symbol),
+                  sequential.next(state, symbol));
+      }
+    }
+  }
+}
+
+TEST_F(RandomAutomataTest, test_parallel_from_nfa_is_identical) {
+  // Should build the same subset construction with any number of threads.
+  ThreadPool three(3);
+  for (uint64_t seed = 0; seed < 20; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    auto nfa = generator.randomNFA(1 + seed % 9, 2, 0.3, 1.2, 0.3);
+    FATest::assertIsCopy(DFA::fromNFA(nfa, three), DFA::fromNFA(nfa));
+  }
+}
+
+TEST_F(RandomAutomataTest, test_differential_from_nfa) {
+  // Should build DFAs accepting exactly the words of the NFA.
+  for (uint64_t seed = 0; seed < 20; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    auto nfa = generator.randomNFA(1 + seed % 5, 2, 0.3, 1.2, 0.3);
+    auto dfa = DFA::fromNFA(nfa);
+    for (auto &word : words(nfa.getInputSymbols(), 6)) {
+      bool expected = nfaAccepts(nfa, word);
+      ASSERT_EQ(dfaAccepts(dfa, word), expected);
+      ASSERT_EQ(nfa.acceptsInput(word), expected);
+    }
+  }
+}
+
+TEST_F(RandomAutomataTest, test_differential_minify_is_minimal) {
+  // Should produce as many states as there are distinct residual languages.
+  for (uint64_t seed = 0; seed < 20; seed++) {
+    RandomAutomatonGenerator generator(seed);
+    double density = seed % 3 == 0 ? 0.6 : 1.0;
+    auto dfa = generator.randomDFA(2 + seed % 7, 2, 0.4, density);
+    auto minimal = dfa.minify(false);
+    // Two states are equivalent if they agree on every word of length < n.
+    std::size_t n = dfa.getStates().size();
+    std::set<std::vector<bool>> residuals;
+    bool dead = false;
+    for (auto &state : dfa.getStates()) {
+      DFA from(dfa.getStates(), dfa.getInputSymbols(), dfa.getTransitions(),
+               state, dfa.getFinalStates(), dfa.getAllowPartial());
+      std::vector<bool> signature;
+      for (auto &word : words(dfa.getInputSymbols(), n)) {
+        signature.push_back(dfaAccepts(from, word));
+      }
+      residuals.insert(signature);
+      dead = dead || std::find(signature.begin(), signature.end(), true) ==
+                         signature.end();
+    }
+    for (auto &word : words(dfa.getInputSymbols(), n)) {
+      ASSERT_EQ(dfaAccepts(minimal, word), dfaAccepts(dfa, word));
+    }
+    // Every state here is reachable. Missing transitions already stand for
+    // the dead state, so its class is dropped unless it is the only one.
+    bool missing = false;
+    for (auto &transition : dfa.getTransitions()) {
+      missing = missing || transition.second.size() < 2;
+    }
+    std::size_t expected = residuals.size();
+    if (missing && dead && !minimal.getFinalStates().empty()) {
+      expected--;
+    }
+    ASSERT_EQ(minimal.getStates().size(), expected);
+  }
+}
@@ -0,0 +1,56 @@
+#include "StaticDFA.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+
+using namespace CXXAUTOMATA;
+
+namespace {
+// The DFA of FATest with q0, q1, q2 numbered 0, 1, 2.
+constexpr StaticDFA<3, 2> staticDfa({'0', '1'}, {{0, 1}, {0, 2}, {2, 1}},
+                                    {false, true, false}, 0);
+
+static_assert(staticDfa.acceptsInput("0111"), "should accept 0111");
+static_assert(!staticDfa.acceptsInput("011"), "should reject 011");
+static_assert(!staticDfa.acceptsInput("01x"), "should reject foreign symbols");
+static_assert(staticDfa.nextState(1, '1') == 2, "q1 should move to q2");
+
+constexpr StaticDFA<2, 1> partialDfa({'a'}, {{1}, {-1}}, {false, true}, 0,
+                                     true);
+static_assert(partialDfa.acceptsInput("a"), "should accept a");
+static_assert(!partialDfa.acceptsInput("aa"), "should reject aa");
+static_assert(partialDfa.nextState(1, 'a') == -1, "q1 has no transition");
+} // namespace
+
+class StaticDFATest : public FATest {};
+
+TEST_F(StaticDFATest, test_accepts_input) {
+  // Should match at run time like the runtime DFA.
+  ASSERT_TRUE(staticDfa.acceptsInput(std::string("0111")));
+  ASSERT_FALSE(staticDfa.acceptsInput(std::string("")));
+  ASSERT_EQ(staticDfa.getStateCount(), 3u);
+  ASSERT_FALSE(staticDfa.getAllowPartial());
+  ASSERT_TRUE(partialDfa.getAllowPartial());
+}
+
+TEST_F(StaticDFATest, test_equivalent_to_dfa) {
+  // Should convert to a DFA equivalent to the runtime one.
+  auto converted = staticDfa.toDFA();
+  ASSERT_EQ(converted.getStates(), States({"0", "1", "2"}));
+  ASSERT_EQ(converted.getInitialState(), "0");
+  ASSERT_TRUE(converted == dfa);
+  ASSERT_EQ(partialDfa.toDFA().getTransitions().at("1").size(), 0u);
+}
+
+TEST_F(StaticDFATest, test_invalid_at_run_time) {
+  // Should throw when an invalid automaton is built at run time.
+  typedef StaticDFA<2, 1> TwoStates;
+  typedef StaticDFA<1, 2> TwoSymbols;
+  typedef StaticDFA<1, 1> OneState;
+  ASSERT_THROW(TwoStates({'a'}, {{1}, {2}}, {false, true}, 0),
+               InvalidStateException);
+  ASSERT_THROW(TwoStates({'a'}, {{1}, {-1}}, {false, true}, 0),
+               MissingSymbolException);
+  ASSERT_THROW(TwoSymbols({'a', 'a'}, {{0, 0}}, {true}, 0),
+               InvalidSymbolException);
+  ASSERT_THROW(OneState({'a'}, {{0}}, {true}, 1), InitialStateException);
+}
@@ -0,0 +1,80 @@
+#include "Statistics.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class StatisticsTest : public FATest {
+protected:
+  virtual void SetUp() { Statistics::reset(); }
+  virtual void TearDown() { Statistics::setCallback(Statistics::Callback()); }
+};
+
+TEST_F(StatisticsTest, test_operations_recorded) {
+  // Should count calls and work of each operation when enabled.
+  auto no_consecutive_11_dfa = DFA({"q0", "q1", "q2", "q3"}, {"0", "1"},
+                                   {
+                                       {"q0", {{"0", "q3"}, {"1", "q1"}}},
+                                       {"q1", {{"0", "q0"}, {"1", "q2"}}},
+                                       {"q2", {{"0", "q2"}, {"1", "q2"}}},
+                                       {"q3", {{"0", "q0"}, {"1", "q1"}}},
+                                   },
+                                   "q0", {"q0", "q1", "q3"});
+  Statistics::reset();
+  no_consecutive_11_dfa.minify();
+  no_consecutive_11_dfa.validate();
+  auto stats = Statistics::snapshot();
+  if (!Statistics::isEnabled()) {
+    ASSERT_EQ(stats.get(Operation::MINIFY).calls, 0u);
+    ASSERT_EQ(stats.peakMemoryBytes, 0u);
+    return;
+  }
+  auto &minify = stats.get(Operation::MINIFY);
+  ASSERT_EQ(minify.calls, 1u);
+  ASSERT_EQ(minify.get(Counter::STATES_EXPLORED), 4u);
+  ASSERT_GT(minify.get(Counter::TRANSITIONS_VISITED), 0u);
+  ASSERT_GT(minify.get(Counter::PARTITIONS_SPLIT), 0u);
+  ASSERT_EQ(stats.get(Operation::VALIDATE).calls, 1u);
+  ASSERT_EQ(stats.get(Operation::VALIDATE).get(Counter::TRANSITIONS_VISITED),
+            8u);
+  ASSERT_GT(stats.peakMemoryBytes, 0u);
+}
+
+TEST_F(StatisticsTest, test_callback) {
+  // Should report each completed operation to the callback.
+  std::vector<Operation> seen;
+  Statistics::setCallback(
+      [&seen](Operation operation, const OperationStatistics &stats) {
+        ASSERT_EQ(stats.calls, 1u);
+        seen.push_back(operation);
+      });
+  dfa.intersection(dfa, false, false);
+  if (!Statistics::isEnabled()) {
+    ASSERT_TRUE(seen.empty());
+    return;
+  }
+  // The product DFA is validated before the cross product completes.
+  std::vector<Operation> expected = {Operation::VALIDATE,
+                                     Operation::CROSS_PRODUCT};
+  ASSERT_EQ(seen, expected);
+}
+
+TEST_F(StatisticsTest, test_prometheus_text) {
+  // Should export one sample per operation and metric.
+  dfa.minify();
+  std::stringstream ss;
+  Statistics::writePrometheus(ss);
+  auto text = ss.str();
+  ASSERT_NE(text.find("# TYPE cxxautomata_operation_calls_total counter"),
+            std::string::npos);
+  ASSERT_NE(
+      text.find("cxxautomata_operation_calls_total{operation=\"minify\"} " +
+                std::string(Statistics::isEnabled() ? "1" : "0")),
+      std::string::npos);
+  ASSERT_NE(text.find("cxxautomata_partitions_split_total{operation="
+                      "\"cross_product\"}"),
+            std::string::npos);
+  ASSERT_NE(text.find("cxxautomata_peak_memory_bytes "), std::string::npos);
+}
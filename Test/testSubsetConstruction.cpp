@@ -0,0 +1,191 @@
+#include "Exceptions.hpp"
+#include "RandomAutomata.hpp"
+#include "SubsetConstruction.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class SubsetConstructionTest : public FATest {
+public:
+  static InputSymbols_v part(const InputSymbols_v &word, std::size_t begin,
+                             std::size_t end) {
+    return InputSymbols_v(word.begin() + begin, word.begin() + end);
+  }
+
+  static bool acceptsConcatenation(const DFA &a, const DFA &b,
+                                   const InputSymbols_v &word) {
+    for (std::size_t i = 0; i <= word.size(); i++) {
+      if (a.acceptsInput(part(word, 0, i)) &&
+          b.acceptsInput(part(word, i, word.size()))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool acceptsStar(const DFA &a, const InputSymbols_v &word) {
+    // split[i]: the first i symbols are a sequence of words of a
+    std::vector<bool> split(word.size() + 1, false);
+    split[0] = true;
+    for (std::size_t end = 1; end <= word.size(); end++) {
+      for (std::size_t begin = 0; begin < end && !split[end]; begin++) {
+        split[end] = split[begin] && a.acceptsInput(part(word, begin, end));
+      }
+    }
+    return split[word.size()];
+  }
+
+  /**
+   * @brief Return a DFA accepting the words whose n-th symbol is 1.
+   *
+   */
+  static DFA nthIsOne(std::size_t n) {
+    States states;
+    Transitions transitions;
+    for (std::size_t i = 0; i <= n; i++) {
+      State state = "s" + std::to_string(i);
+      State next = "s" + std::to_string(i + 1);
+      states.insert(state);
+      if (i + 1 < n) {
+        transitions[state] = {{"0", next}, {"1", next}};
+      } else if (i + 1 == n) {
+        transitions[state] = {{"1", next}};
+      } else {
+        transitions[state] = {{"0", state}, {"1", state}};
+      }
+    }
+    return DFA(states, {"0", "1"}, transitions, "s0",
+               {"s" + std::to_string(n)}, true);
+  }
+
+  DFA ab = DFA({"p0", "p1", "p2"}, {"a", "b"},
+               {{"p0", {{"a", "p1"}}}, {"p1", {{"b", "p2"}}}}, "p0", {"p2"},
+               true);
+};
+
+TEST_F(SubsetConstructionTest, test_concatenate) {
+  // Should accept the words of one DFA followed by words of the other.
+  RandomAutomatonGenerator generator(11);
+  for (int i = 0; i < 10; i++) {
+    DFA a = generator.randomDFA(5, 2, 0.4, 0.8);
+    DFA b = generator.randomDFA(5, 2, 0.4, 0.8);
+    DFA result = a.concatenate(b);
+    for (auto &word : words(a.getInputSymbols(), 6)) {
+      ASSERT_EQ(result.acceptsInput(word), acceptsConcatenation(a, b, word));
+    }
+  }
+}
+
+TEST_F(SubsetConstructionTest, test_concatenate_alphabets) {
+  // Should concatenate over the union of both alphabets.
+  DFA result = dfa.concatenate(ab);
+  ASSERT_EQ(result.getInputSymbols(), InputSymbols({"0", "1", "a", "b"}));
+  ASSERT_TRUE(result.acceptsInput({"0", "1", "a", "b"}));
+  ASSERT_FALSE(result.acceptsInput({"0", "1", "a"}));
+  ASSERT_FALSE(result.acceptsInput({"a", "b"}));
+  ASSERT_FALSE(result.acceptsInput({"1", "a", "b", "1"}));
+}
+
+TEST_F(SubsetConstructionTest, test_star) {
+  // Should accept any sequence of words, including the empty one.
+  RandomAutomatonGenerator generator(12);
+  for (int i = 0; i < 10; i++) {
+    DFA a = generator.randomDFA(5, 2, 0.3, 0.7);
+    DFA result = a.star();
+    ASSERT_TRUE(result.acceptsInput({}));
+    for (auto &word : words(a.getInputSymbols(), 6)) {
+      ASSERT_EQ(result.acceptsInput(word), acceptsStar(a, word));
+    }
+  }
+  DFA repeated = ab.star();
+  ASSERT_TRUE(repeated.acceptsInput({"a", "b", "a", "b"}));
+  ASSERT_FALSE(repeated.acceptsInput({"a", "b", "a"}));
+  ASSERT_EQ(repeated.getStates().size(), 2u);
+}
+
+TEST_F(SubsetConstructionTest, test_reverse) {
+  // Should accept the words spelled backwards.
+  RandomAutomatonGenerator generator(13);
+  for (int i = 0; i < 10; i++) {
+    DFA a = generator.randomDFA(6, 2, 0.4, 0.8);
+    DFA result = a.reverse();
+    for (auto &word : words(a.getInputSymbols(), 6)) {
+      InputSymbols_v backwards(word.rbegin(), word.rend());
+      ASSERT_EQ(result.acceptsInput(word), a.acceptsInput(backwards));
+    }
+    ASSERT_TRUE(result.reverse() == a);
+  }
+  ASSERT_TRUE(ab.reverse().acceptsInput({"b", "a"}));
+}
+
+TEST_F(SubsetConstructionTest, test_quotients) {
+  // Should strip the words of the other DFA from either end.
+  RandomAutomatonGenerator generator(14);
+  for (int i = 0; i < 10; i++) {
+    DFA a = generator.randomDFA(5, 2, 0.4, 0.8);
+    DFA b = generator.randomDFA(3, 2, 0.4, 0.8);
+    DFA left = a.leftQuotient(b);
+    DFA right = a.rightQuotient(b);
+    // A word of b that leads a to a state, or from one state to a final
+    // state, is at most as long as the paths of the product without a
+    // repeated pair.
+    std::size_t bound = a.getStates().size() * b.getStates().size() - 1;
+    std::vector<InputSymbols_v> accepted;
+    for (auto &other : words(a.getInputSymbols(), bound)) {
+      if (b.acceptsInput(other)) {
+        accepted.push_back(other);
+      }
+    }
+    for (auto &word : words(a.getInputSymbols(), 4)) {
+      bool inLeft = false;
+      bool inRight = false;
+      for (auto &other : accepted) {
+        InputSymbols_v prefixed = other;
+        prefixed.insert(prefixed.end(), word.begin(), word.end());
+        InputSymbols_v suffixed = word;
+        suffixed.insert(suffixed.end(), other.begin(), other.end());
+        inLeft = inLeft || a.acceptsInput(prefixed);
+        inRight = inRight || a.acceptsInput(suffixed);
+      }
+      ASSERT_EQ(left.acceptsInput(word), inLeft);
+      ASSERT_EQ(right.acceptsInput(word), inRight);
+    }
+  }
+
+  DFA prefix({"r0", "r1"}, {"a", "b"}, {{"r0", {{"a", "r1"}}}}, "r0", {"r1"},
+             true);
+  ASSERT_TRUE(ab.leftQuotient(prefix).acceptsInput({"b"}));
+  ASSERT_FALSE(ab.leftQuotient(prefix).acceptsInput({"a", "b"}));
+  ASSERT_TRUE(ab.rightQuotient(prefix).isEmpty());
+  ASSERT_TRUE(ab.rightQuotient(ab).acceptsInput({}));
+}
+
+TEST_F(SubsetConstructionTest, test_lazy_matching) {
+  // Should only create the states that the input passes through.
+  auto construction =
+      SubsetConstruction::reversal(nthIsOne(12), ConstructionBudget());
+  InputSymbols_v input(12, "0");
+  input[0] = "1";
+  ASSERT_TRUE(construction.acceptsInput(input));
+  ASSERT_EQ(construction.getStateCount(), 13u);
+  input[0] = "0";
+  ASSERT_FALSE(construction.acceptsInput(input));
+  ASSERT_LT(construction.getStateCount(), 30u);
+  ASSERT_EQ(construction.toDFA().getStates().size(), 4096u);
+}
+
+TEST_F(SubsetConstructionTest, test_budget) {
+  // Should stop when the result grows over its budget.
+  DFA blowup = nthIsOne(12);
+  ASSERT_THROW(blowup.reverse(ConstructionBudget(1000, 0)),
+               BudgetExceededException);
+  ASSERT_THROW(blowup.reverse(ConstructionBudget(0, 100000)),
+               BudgetExceededException);
+  ASSERT_EQ(nthIsOne(6).reverse(ConstructionBudget(1000, 100000))
+                .getStates()
+                .size(),
+            64u);
+}
@@ -0,0 +1,107 @@
+#include "Exceptions.hpp"
+#include "TextFormat.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <sstream>
+
+using namespace CXXAUTOMATA;
+
+class TextFormatTest : public FATest {
+protected:
+  TextFormatTest()
+      : FATest(),
+        nfa({"q0", "q 1", "q2"}, {"a", "b"},
+            {{"q0", {{"a", {"q0", "q 1"}}, {"b", {"q0"}}}},
+             {"q 1", {{"a", {"q2"}}, {NFA::LAMBDA, {"q2"}}}}},
+            "q0", {"q2"}){};
+
+  NFA nfa;
+};
+
+TEST_F(TextFormatTest, test_dfa_json_round_trip) {
+  // Should read back the DFA written as JSON.
+  std::stringstream ss;
+  writeJSON(dfa, ss);
+  auto copy = readDFAFromJSON(ss);
+  FATest::assertIsCopy(copy, dfa);
+  ASSERT_FALSE(copy.getAllowPartial());
+}
+
+TEST_F(TextFormatTest, test_nfa_json_round_trip) {
+  // Should read back the NFA written as JSON, including lambda transitions.
+  std::stringstream ss;
+  writeJSON(nfa, ss);
+  auto copy = readNFAFromJSON(ss);
+  FATest::assertIsCopy(copy, nfa);
+  ASSERT_EQ(copy.getNFATransitions(), nfa.getNFATransitions());
+}
+
+TEST_F(TextFormatTest, test_dfa_edge_list_round_trip) {
+  // Should read back a partial DFA written as an edge list.
+  auto partial = DFA({"q0", "q#1", ""}, {"a", "@", " "},
+                     {{"q0", {{"a", "q#1"}, {" ", ""}}},
+                      {"q#1", {{"@", "q0"}}},
+                      {"", {}}},
+                     "q0", {"q#1"}, true);
+  std::stringstream ss;
+  writeEdgeList(partial, ss);
+  auto copy = readDFAFromEdgeList(ss);
+  FATest::assertIsCopy(copy, partial);
+  ASSERT_TRUE(copy.getAllowPartial());
+}
+
+TEST_F(TextFormatTest, test_nfa_edge_list_round_trip) {
+  // Should read back the NFA written as an edge list.
+  std::stringstream ss;
+  writeEdgeList(nfa, ss);
+  auto copy = readNFAFromEdgeList(ss);
+  FATest::assertIsCopy(copy, nfa);
+  ASSERT_EQ(copy.getNFATransitions(), nfa.getNFATransitions());
+}
+
+TEST_F(TextFormatTest, test_json_any_key_order) {
+  // Should accept members in any order, escapes and unknown keys.
+  std::stringstream ss(R"({
+    "final_states": ["qé"],
+    "comment": {"nested": [1, 2.5e3, null, true]},
+    "transitions": {"q0": {"x": "qé"}, "qé": {"x": "q0"}},
+    "initial_state": "q0",
+    "input_symbols": ["x"],
+    "states": ["q0", "qé"],
+    "type": "DFA"
+  })");
+  auto dfa = readDFAFromJSON(ss);
+  ASSERT_EQ(dfa.getFinalStates(), States({"q\xc3\xa9"}));
+  ASSERT_TRUE(dfa.acceptsInput({"x", "x", "x"}));
+}
+
+TEST_F(TextFormatTest, test_edge_list_comments) {
+  // Should ignore comments and blank lines.
+  std::stringstream ss("# generated\n"
+                       "dfa\n"
+                       "\n"
+                       "@initial q0   # start here\n"
+                       "@symbols 0 1\n"
+                       "@states q0\n"
+                       "@states q1\n"
+                       "@final q1\n"
+                       "q0 0 q0\nq0 1 q1\nq1 0 q0\nq1 1 q1\n");
+  auto dfa = readDFAFromEdgeList(ss);
+  ASSERT_TRUE(dfa.acceptsInput({"0", "1"}));
+  ASSERT_FALSE(dfa.acceptsInput({"1", "0"}));
+}
+
+TEST_F(TextFormatTest, test_invalid_input) {
+  // Should raise error on malformed or mismatching documents.
+  std::stringstream wrongType;
+  writeJSON(nfa, wrongType);
+  EXPECT_THROW(readDFAFromJSON(wrongType), SerializationException);
+  std::stringstream truncated("{\"type\": \"DFA\", \"states\": [\"q0\"");
+  EXPECT_THROW(readDFAFromJSON(truncated), SerializationException);
+  std::stringstream duplicate("dfa\n@initial q0\n@states q0 q1\n"
+                              "q0 a q0\nq0 a q1\n");
+  EXPECT_THROW(readDFAFromEdgeList(duplicate), SerializationException);
+  std::stringstream invalid("dfa\n@initial q0\n@symbols a\n@states q0\n"
+                            "q0 a q1\n");
+  EXPECT_THROW(readDFAFromEdgeList(invalid), InvalidStateException);
+}
@@ -0,0 +1,50 @@
+#include "ThreadPool.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+TEST(ThreadPoolTest, test_run_on_every_worker) {
+  // Should call the task once per worker, the calling thread included.
+  ThreadPool pool(4);
+  ASSERT_EQ(pool.getThreadCount(), 4u);
+  std::vector<int> calls(4, 0);
+  for (int round = 0; round < 3; round++) {
+    pool.run([&](std::size_t worker) { calls[worker]++; });
+  }
+  ASSERT_EQ(calls, std::vector<int>(4, 3));
+}
+
+TEST(ThreadPoolTest, test_parallel_for_covers_range) {
+  // Should visit every index exactly once.
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> visits(1000);
+  for (auto &visit : visits) {
+    visit = 0;
+  }
+  pool.parallelFor(visits.size(), 7, [&](std::size_t begin, std::size_t end) {
+    ASSERT_LE(end - begin, 7u);
+    for (std::size_t i = begin; i < end; i++) {
+      visits[i]++;
+    }
+  });
+  for (auto &visit : visits) {
+    ASSERT_EQ(visit, 1);
+  }
+}
+
+TEST(ThreadPoolTest, test_rethrows_task_exception) {
+  // Should rethrow an exception of a worker and stay usable.
+  ThreadPool pool(2);
+  EXPECT_THROW(pool.run([](std::size_t worker) {
+    if (worker == 1) {
+      throw std::runtime_error("worker failed");
+    }
+  }),
+               std::runtime_error);
+  std::atomic<int> calls(0);
+  pool.run([&](std::size_t) { calls++; });
+  ASSERT_EQ(calls, 2);
+}
@@ -0,0 +1,106 @@
+#include "CompiledDFA.hpp"
+#include "Exceptions.hpp"
+#include "TraceRecorder.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class TraceRecorderTest : public FATest {
+public:
+  InputSymbols_v input = {"1", "1", "0", "1", "0", "0", "1"};
+};
+
+TEST_F(TraceRecorderTest, test_trace_matches_read_input_stepwise) {
+  // Should visit the states of readInputStepwise by their ids.
+  States_v names(dfa.getStates().begin(), dfa.getStates().end());
+  States_v stepwise = dfa.readInputStepwise(input);
+  std::vector<std::size_t> positions;
+  StateId last = dfa.traceInput(
+      input, [&](StateId state, std::size_t position,
+                 const InputSymbol &symbol) {
+        ASSERT_EQ(names[state], stepwise[position + 1]);
+        ASSERT_EQ(symbol, input[position]);
+        positions.push_back(position);
+      });
+  ASSERT_EQ(names[last], stepwise.back());
+  ASSERT_EQ(positions.size(), input.size());
+  ASSERT_EQ(positions.back(), input.size() - 1);
+}
+
+TEST_F(TraceRecorderTest, test_record_modes) {
+  // Should keep every step, a sample of steps or the last steps.
+  auto all = TraceRecorder::all();
+  dfa.traceInput(input, all);
+  ASSERT_EQ(all.getStates(), std::vector<StateId>({1, 2, 2, 1, 0, 0, 1}));
+  ASSERT_EQ(all.positionAt(3), 3u);
+
+  auto sampled = TraceRecorder::sampled(3);
+  dfa.traceInput(input, sampled);
+  ASSERT_EQ(sampled.getStates(), std::vector<StateId>({1, 1, 1}));
+  ASSERT_EQ(sampled.positionAt(2), 6u);
+  ASSERT_EQ(sampled.getStepCount(), input.size());
+
+  auto last = TraceRecorder::last(3);
+  dfa.traceInput(input, last);
+  ASSERT_EQ(last.getStates(), std::vector<StateId>({0, 0, 1}));
+  ASSERT_EQ(last.positionAt(0), 4u);
+  ASSERT_EQ(last.positionAt(2), 6u);
+  last.clear();
+  ASSERT_EQ(last.size(), 0u);
+
+  ASSERT_THROW(TraceRecorder::last(0), AutomatonException);
+}
+
+TEST_F(TraceRecorderTest, test_reused_recorder_positions) {
+  // Should report the positions of every trace recorded without clear().
+  auto all = TraceRecorder::all();
+  dfa.traceInput({"1", "1"}, all);
+  dfa.traceInput({"0", "1", "0"}, all);
+  ASSERT_EQ(all.size(), 5u);
+  std::vector<std::size_t> positions;
+  for (std::size_t i = 0; i < all.size(); i++) {
+    positions.push_back(all.positionAt(i));
+  }
+  ASSERT_EQ(positions, std::vector<std::size_t>({0, 1, 0, 1, 2}));
+  all.clear();
+  dfa.traceInput({"0", "1"}, all);
+  ASSERT_EQ(all.positionAt(1), 1u);
+}
+
+TEST_F(TraceRecorderTest, test_compiled_trace) {
+  // Should trace a CompiledDFA exactly like the DFA it was built from.
+  CompiledDFA compiled(dfa);
+  auto fromDFA = TraceRecorder::all();
+  auto fromCompiled = TraceRecorder::all();
+  ASSERT_EQ(dfa.traceInput(input, fromDFA),
+            compiled.trace(input, fromCompiled));
+  ASSERT_EQ(fromDFA.getStates(), fromCompiled.getStates());
+}
+
+TEST_F(TraceRecorderTest, test_trace_stops_on_rejection) {
+  // Should return NO_STATE after visiting the steps taken.
+  DFA partial({"q0", "q1"}, {"a", "b"}, {{"q0", {{"a", "q1"}}}}, "q0", {"q1"},
+              true);
+  auto recorder = TraceRecorder::all();
+  ASSERT_EQ(partial.traceInput({"a", "a", "b"}, recorder), NO_STATE);
+  ASSERT_EQ(recorder.getStates(), std::vector<StateId>({1}));
+  ASSERT_EQ(partial.traceInput({"c"}, recorder), NO_STATE);
+  ASSERT_EQ(CompiledDFA(partial).trace({"a", "b"}, recorder), NO_STATE);
+}
+
+TEST_F(TraceRecorderTest, test_trace_after_copy_and_assignment) {
+  // Should trace the automaton a DFA holds, not the one it was copied from.
+  DFA partial({"q0", "q1"}, {"a", "b"}, {{"q0", {{"a", "q1"}}}}, "q0", {"q1"},
+              true);
+  auto ignore = [](StateId, std::size_t, const InputSymbol &) {};
+  DFA target(dfa);
+  ASSERT_EQ(target.traceInput(input, ignore), dfa.traceInput(input, ignore));
+  target = partial;
+  auto recorder = TraceRecorder::all();
+  ASSERT_EQ(target.traceInput({"a"}, recorder), 1u);
+  ASSERT_EQ(target.traceInput(input, recorder), NO_STATE);
+  DFA copy(target);
+  ASSERT_EQ(copy.traceInput({"a"}, recorder), 1u);
+}
@@ -0,0 +1,156 @@
+#include "Exceptions.hpp"
+#include "RandomAutomata.hpp"
+#include "WordGenerator.hpp"
+#include "testFA.cpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace CXXAUTOMATA;
+
+class WordGeneratorTest : public FATest {
+public:
+  /**
+   * @brief Return the words of at most maxLength symbols accepted by dfa,
+   *        ordered by length, then lexicographically.
+   *
+   */
+  static std::vector<InputSymbols_v> acceptedWords(const DFA &dfa,
+                                                   std::size_t maxLength) {
+    std::vector<InputSymbols_v> accepted;
+    for (auto &word : words(dfa.getInputSymbols(), maxLength)) {
+      if (dfa.acceptsInput(word)) {
+        accepted.push_back(word);
+      }
+    }
+    return accepted;
+  }
+};
+
+TEST_F(WordGeneratorTest, test_shortest_word) {
+  // Should return the first of the shortest accepted words.
+  WordGenerator generator(dfa);
+  InputSymbols_v word;
+  ASSERT_TRUE(generator.shortestWord(word));
+  ASSERT_EQ(word, InputSymbols_v({"1"}));
+
+  DFA longer({"a", "b", "c"}, {"0", "1"},
+             {{"a", {{"0", "b"}, {"1", "b"}}}, {"b", {{"1", "c"}}}}, "a",
+             {"c"}, true);
+  ASSERT_TRUE(WordGenerator(longer).shortestWord(word));
+  ASSERT_EQ(word, InputSymbols_v({"0", "1"}));
+
+  DFA empty({"a"}, {"0"}, {}, "a", {}, true);
+  ASSERT_FALSE(WordGenerator(empty).shortestWord(word));
+  ASSERT_TRUE(WordGenerator(empty).shortestWords(3).empty());
+}
+
+TEST_F(WordGeneratorTest, test_shortest_words) {
+  // Should enumerate words by length, then lexicographically.
+  RandomAutomatonGenerator random(21);
+  for (int i = 0; i < 10; i++) {
+    DFA candidate = random.randomDFA(6, 2, 0.3, 0.8);
+    auto expected = acceptedWords(candidate, 7);
+    expected.resize(std::min<std::size_t>(expected.size(), 20));
+    auto words = WordGenerator(candidate).shortestWords(expected.size());
+    ASSERT_EQ(words, expected);
+  }
+
+  DFA finite({"a", "b", "c"}, {"0", "1"},
+             {{"a", {{"0", "b"}, {"1", "c"}}}, {"b", {{"1", "c"}}}}, "a",
+             {"b", "c"}, true);
+  auto words = WordGenerator(finite).shortestWords(10);
+  ASSERT_EQ(words, std::vector<InputSymbols_v>({{"0"}, {"1"}, {"0", "1"}}));
+}
+
+TEST_F(WordGeneratorTest, test_lexicographic_words) {
+  // Should enumerate the words up to a length in lexicographic order.
+  RandomAutomatonGenerator random(22);
+  for (int i = 0; i < 10; i++) {
+    DFA candidate = random.randomDFA(6, 2, 0.3, 0.8);
+    auto expected = acceptedWords(candidate, 5);
+    std::sort(expected.begin(), expected.end());
+    auto words = WordGenerator(candidate).lexicographicWords(1000, 5);
+    ASSERT_EQ(words, expected);
+    auto first = WordGenerator(candidate).lexicographicWords(3, 5);
+    expected.resize(std::min<std::size_t>(expected.size(), 3));
+    ASSERT_EQ(first, expected);
+  }
+}
+
+TEST_F(WordGeneratorTest, test_sample_uniform) {
+  // Should draw every accepted word of a length about equally often.
+  WordGenerator generator(dfa);
+  ASSERT_THROW(generator.hasWords(1), AutomatonException);
+  generator.prepare(6);
+  ASSERT_EQ(generator.getPreparedLength(), 6u);
+
+  std::map<InputSymbols_v, int> seen;
+  std::mt19937_64 rng(7);
+  const int samples = 20000;
+  InputSymbols_v word;
+  for (int i = 0; i < samples; i++) {
+    ASSERT_TRUE(generator.sample(6, rng, word));
+    ASSERT_TRUE(dfa.acceptsInput(word));
+    seen[word]++;
+  }
+  std::size_t total = 0;
+  for (auto &candidate : acceptedWords(dfa, 6)) {
+    total += candidate.size() == 6;
+  }
+  ASSERT_EQ(seen.size(), total);
+  double expected = static_cast<double>(samples) / total;
+  for (auto &entry : seen) {
+    ASSERT_NEAR(entry.second, expected, expected * 0.3);
+  }
+}
+
+TEST_F(WordGeneratorTest, test_sample_long_words) {
+  // Should sample lengths whose counts overflow a double.
+  DFA anything({"a"}, {"0", "1"}, {{"a", {{"0", "a"}, {"1", "a"}}}}, "a",
+               {"a"});
+  WordGenerator generator(anything);
+  generator.prepare(3000);
+  std::mt19937_64 rng(3);
+  std::vector<SymbolId> ids;
+  ASSERT_TRUE(generator.sampleIds(3000, rng, ids));
+  ASSERT_EQ(ids.size(), 3000u);
+  std::size_t ones = std::count(ids.begin(), ids.end(), 1u);
+  ASSERT_GT(ones, 1300u);
+  ASSERT_LT(ones, 1700u);
+
+  DFA even({"a", "b"}, {"0"}, {{"a", {{"0", "b"}}}, {"b", {{"0", "a"}}}}, "a",
+           {"a"});
+  WordGenerator parity(even);
+  parity.prepare(5);
+  ASSERT_FALSE(parity.sampleIds(5, rng, ids));
+  ASSERT_TRUE(ids.empty());
+  ASSERT_TRUE(parity.sampleIds(4, rng, ids));
+}
+
+TEST_F(WordGeneratorTest, test_sample_small_counts) {
+  // Should sample lengths whose counts are tiny next to others of the same
+  // length.
+  States states = {"loop"};
+  Transitions transitions = {{"loop", {{"a", "loop"}, {"b", "loop"}}}};
+  const int chain = 1100;
+  for (int i = 0; i < chain; i++) {
+    State next = i + 1 < chain ? "c" + std::to_string(i + 1) : "loop";
+    states.insert("c" + std::to_string(i));
+    transitions["c" + std::to_string(i)] = {{"x", next}};
+  }
+  DFA tail(states, {"a", "b", "x"}, transitions, "c0", {"loop"}, true);
+  WordGenerator generator(tail);
+  generator.prepare(chain + 5);
+  ASSERT_TRUE(generator.hasWords(chain + 5));
+  ASSERT_FALSE(generator.hasWords(chain - 1));
+  std::mt19937_64 rng(5);
+  InputSymbols_v word;
+  for (int i = 0; i < 20; i++) {
+    ASSERT_TRUE(generator.sample(chain + 5, rng, word));
+    ASSERT_EQ(word.size(), chain + 5u);
+    ASSERT_TRUE(tail.acceptsInput(word));
+  }
+}
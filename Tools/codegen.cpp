@@ -0,0 +1,96 @@
+#include "CodeGenerator.hpp"
+#include "Exceptions.hpp"
+#include "RandomAutomata.hpp"
+#include "TextFormat.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace CXXAUTOMATA;
+
+namespace {
+void usage() {
+  std::cerr
+      << "usage: CXXAutomataCodegen [--style direct|table] [--name NAME]\n"
+         "                          [--namespace NS] INPUT OUTPUT\n"
+         "       CXXAutomataCodegen [options] --random STATES SYMBOLS SEED "
+         "OUTPUT\n"
+         "\n"
+         "INPUT is a DFA in JSON (*.json) or edge list format. --random\n"
+         "generates the DFA the benchmarks use (one state in four final).\n";
+}
+
+bool endsWith(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  CodeGeneratorOptions options;
+  std::vector<std::string> positional;
+  bool random = false;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if ((arg == "--style" || arg == "--name" || arg == "--namespace") &&
+        i + 1 < argc) {
+      std::string value = argv[++i];
+      if (arg == "--name") {
+        options.functionName = value;
+      } else if (arg == "--namespace") {
+        options.namespaceName = value;
+      } else if (value == "direct") {
+        options.style = CodeGeneratorOptions::DIRECT;
+      } else if (value == "table") {
+        options.style = CodeGeneratorOptions::TABLE;
+      } else {
+        usage();
+        return 2;
+      }
+    } else if (arg == "--random") {
+      random = true;
+    } else if (!arg.empty() && arg[0] == '-') {
+      usage();
+      return 2;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+  if (positional.size() != (random ? 4u : 2u)) {
+    usage();
+    return 2;
+  }
+
+  try {
+    const std::string &output = positional.back();
+    std::ofstream out(output);
+    if (!out) {
+      std::cerr << "cannot write " << output << std::endl;
+      return 1;
+    }
+    if (random) {
+      RandomAutomatonGenerator generator(std::stoull(positional[2]));
+      writeCppMatcher(generator.randomDFA(std::stoul(positional[0]),
+                                          std::stoul(positional[1]), 0.25),
+                      out, options);
+    } else {
+      std::ifstream in(positional[0]);
+      if (!in) {
+        std::cerr << "cannot read " << positional[0] << std::endl;
+        return 1;
+      }
+      writeCppMatcher(endsWith(positional[0], ".json") ? readDFAFromJSON(in)
+                                                       : readDFAFromEdgeList(in),
+                      out, options);
+    }
+    if (!out.flush()) {
+      std::cerr << "cannot write " << output << std::endl;
+      return 1;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}